@@ -0,0 +1,6 @@
+result = app.sendScriptMessage (
+    "Ai2Canvas",
+    "Batch",
+    'c:\\temp\\snapshots.txt'
+  );
+alert(result);
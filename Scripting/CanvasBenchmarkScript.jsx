@@ -0,0 +1,6 @@
+result = app.sendScriptMessage (
+    "Ai2Canvas",
+    "Benchmark",
+    'c:\\temp\\'
+  );
+alert(result);
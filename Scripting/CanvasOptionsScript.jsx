@@ -0,0 +1,6 @@
+result = app.sendScriptMessage (
+    "Ai2Canvas",
+    "Options",
+    'minify: yes'
+  );
+alert(result);
@@ -0,0 +1,6 @@
+result = app.sendScriptMessage (
+    "Ai2Canvas",
+    "Regression",
+    'c:\\temp\\corpus\\corpus.txt'
+  );
+alert(result);
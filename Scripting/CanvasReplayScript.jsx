@@ -0,0 +1,6 @@
+result = app.sendScriptMessage (
+    "Ai2Canvas",
+    "Replay",
+    'c:\\temp\\document.snapshot'
+  );
+alert(result);
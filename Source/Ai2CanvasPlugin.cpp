@@ -30,6 +30,11 @@
 #include "Image.h"
 #include "State.h"
 #include "Canvas.h"
+#include "Benchmark.h"
+#include "SnapshotArtSource.h"
+#include "SuiteArtSource.h"
+#include "BatchExport.h"
+#include "Regression.h"
 
 #ifdef MAC_ENV
     #include <ApplicationServices/ApplicationServices.h>
@@ -40,14 +45,27 @@
 #endif 
 
 #define kSelectorAIScriptExport	"Export"
+#define kSelectorAIScriptBenchmark	"Benchmark"
+#define kSelectorAIScriptOptions	"Options"
+#define kSelectorAIScriptSnapshot	"Snapshot"
+#define kSelectorAIScriptReplay	"Replay"
+#define kSelectorAIScriptBatch	"Batch"
+#define kSelectorAIScriptRegression	"Regression"
 
 using namespace CanvasExport;
 
 namespace CanvasExport
 {
 	// Globals
-	ofstream outFile;
+	OutputStream outFile;
 	bool debug;
+	ExportOptions exportOptions;
+	Trace trace;
+
+	// Art is read from the current document unless another source is provided
+	SuiteArtSource suiteArtSource;
+	SnapshotArtSource snapshotArtSource;
+	ArtSource* artSource = &suiteArtSource;
 }
 
 /*
@@ -70,6 +88,7 @@ Ai2CanvasPlugin::Ai2CanvasPlugin(SPPluginRef pluginRef)
 	: Plugin(pluginRef)
 {
 	strncpy(fPluginName, kAi2CanvasPluginName, kMaxStringLength);
+	fRemovedStatements = 0;
 }
 
 /*
@@ -91,6 +110,151 @@ ASErr Ai2CanvasPlugin::Message(char* caller, char* selector, void *message)
 		{
 			isRecognizedCommand = true;
 		}
+		// Benchmark command?
+		else if (strcmp(selector, kSelectorAIScriptBenchmark) == 0)
+		{
+			if (msg->inParam.empty())
+			{
+				outParam.append(ai::UnicodeString("No benchmark folder provided"));
+			}
+			else
+			{
+				char folderPath[300];
+				msg->inParam.as_Roman(folderPath, 300);
+
+				// Run benchmarks and return the report
+				Benchmark benchmark(folderPath);
+				outParam.append(ai::UnicodeString(benchmark.Run()));
+			}
+		}
+		// Options command?
+		else if (strcmp(selector, kSelectorAIScriptOptions) == 0)
+		{
+			char options[300];
+			msg->inParam.as_Roman(options, 300);
+
+			// Update options (kept for later exports) and return the result
+			exportOptions.Parse(options);
+			outParam.append(ai::UnicodeString(exportOptions.Description()));
+		}
+		// Snapshot command?
+		else if (strcmp(selector, kSelectorAIScriptSnapshot) == 0)
+		{
+			if (msg->inParam.empty())
+			{
+				outParam.append(ai::UnicodeString("No snapshot path provided"));
+			}
+			else
+			{
+				char pathName[300];
+				msg->inParam.as_Roman(pathName, 300);
+
+				// Always capture the current document (even while replaying)
+				std::string skipped;
+				if (SnapshotArtSource::Write(suiteArtSource, pathName, skipped))
+				{
+					outParam.append(ai::UnicodeString("Snapshot written to: '"));
+				}
+				else
+				{
+					outParam.append(ai::UnicodeString("Error writing snapshot to: '"));
+				}
+				outParam.append(msg->inParam);
+				outParam.append(ai::UnicodeString("'"));
+
+				// Report art that a replay won't include
+				if (!skipped.empty())
+				{
+					outParam.append(ai::UnicodeString(" (art not captured: " + skipped + ")"));
+				}
+			}
+		}
+		// Replay command?
+		else if (strcmp(selector, kSelectorAIScriptReplay) == 0)
+		{
+			// No path returns to the current document
+			artSource = &suiteArtSource;
+			snapshotArtSource.Close();
+
+			if (msg->inParam.empty())
+			{
+				outParam.append(ai::UnicodeString("Exporting the current document"));
+			}
+			else
+			{
+				char pathName[300];
+				msg->inParam.as_Roman(pathName, 300);
+
+				// Later exports read art from the snapshot (until replay is turned off)
+				if (snapshotArtSource.Open(pathName))
+				{
+					artSource = &snapshotArtSource;
+					outParam.append(ai::UnicodeString("Replaying snapshot: '"));
+				}
+				else
+				{
+					outParam.append(ai::UnicodeString("Unable to open snapshot: '"));
+				}
+				outParam.append(msg->inParam);
+				outParam.append(ai::UnicodeString("'"));
+			}
+		}
+		// Batch command?
+		else if (strcmp(selector, kSelectorAIScriptBatch) == 0)
+		{
+			if (msg->inParam.empty())
+			{
+				outParam.append(ai::UnicodeString("No snapshot list provided"));
+			}
+			else
+			{
+				char listPath[300];
+				msg->inParam.as_Roman(listPath, 300);
+
+				// Export each snapshot in the list and return the report
+				BatchExport batch;
+				if (batch.ReadList(listPath) > 0)
+				{
+					outParam.append(ai::UnicodeString(batch.Run()));
+				}
+				else
+				{
+					outParam.append(ai::UnicodeString("No snapshots found in: '"));
+					outParam.append(msg->inParam);
+					outParam.append(ai::UnicodeString("'"));
+				}
+			}
+		}
+		// Regression command?
+		else if (strcmp(selector, kSelectorAIScriptRegression) == 0)
+		{
+			if (msg->inParam.empty())
+			{
+				outParam.append(ai::UnicodeString("No corpus list provided"));
+			}
+			else
+			{
+				char parameter[300];
+				msg->inParam.as_Roman(parameter, 300);
+
+				// "list path" compares, "list path; update" replaces the golden output and baseline
+				std::string listPath = parameter;
+				bool update = false;
+				size_t separator = listPath.find_last_of(';');
+				if (separator != std::string::npos)
+				{
+					std::string mode = listPath.substr(separator + 1);
+					CleanParameter(mode);
+					ToLower(mode);
+					update = (mode == "update");
+
+					listPath.erase(separator);
+				}
+
+				Regression regression(listPath);
+				outParam.append(ai::UnicodeString(regression.Run(update)));
+			}
+		}
 		// Unrecognized command
 		else
 		{
@@ -99,8 +263,20 @@ ASErr Ai2CanvasPlugin::Message(char* caller, char* selector, void *message)
 			outParam.append(ai::UnicodeString("Unrecognized command: '"));
 			outParam.append(ai::UnicodeString(selector));
 			outParam.append(ai::UnicodeString("'"));
-			outParam.append(ai::UnicodeString(" (only valid command is '"));
+			outParam.append(ai::UnicodeString(" (valid commands are '"));
 			outParam.append(ai::UnicodeString(kSelectorAIScriptExport));
+			outParam.append(ai::UnicodeString("', '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptBenchmark));
+			outParam.append(ai::UnicodeString("', '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptOptions));
+			outParam.append(ai::UnicodeString("', '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptSnapshot));
+			outParam.append(ai::UnicodeString("', '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptReplay));
+			outParam.append(ai::UnicodeString("', '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptBatch));
+			outParam.append(ai::UnicodeString("' and '"));
+			outParam.append(ai::UnicodeString(kSelectorAIScriptRegression));
 			outParam.append(ai::UnicodeString("')"));
 		}
 
@@ -127,6 +303,12 @@ ASErr Ai2CanvasPlugin::Message(char* caller, char* selector, void *message)
 
 				outParam.append(msg->inParam);
 				outParam.append(ai::UnicodeString("'"));
+
+				// Report optimization
+				if (error == kNoErr && fRemovedStatements > 0)
+				{
+					outParam.append(ai::UnicodeString(" (" + std::to_string(fRemovedStatements) + " canvas statements removed by optimization)"));
+				}
 			}
 		}
 
@@ -255,26 +437,9 @@ ASErr Ai2CanvasPlugin::WriteText(const char* pathName, AIBoolean openFile)
 		bool debugActivated = ((GetKeyState(VK_LSHIFT) &0x1000) != 0);
 	#endif 
 
-	// Create file
+	// Create file and render the document
 	std::string file = std::string(pathName);
-	if (OpenFile(file))
-	{
-		// Set debug mode
-		//CanvasExport::debug = (openFile != 0);
-		CanvasExport::debug = debugActivated;
-
-		// Create a new document
-		Document* document = new Document(file);
-
-		// Render the document
-		document->Render();
-
-		// Close the file
-		CloseFile();
-
-		// Delete document
-		delete document;
-	}
+	Document::Export(file, debugActivated, &fRemovedStatements);
 
 	#ifdef MAC_ENV
 		// Create file URI
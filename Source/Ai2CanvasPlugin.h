@@ -98,6 +98,10 @@ private:
 	*/
 	AIMenuItemHandle fAboutPluginMenu;
 
+	/**	Number of canvas statements removed by optimization during the last export.
+	*/
+	size_t fRemovedStatements;
+
 	/**	Adds the menu items for this plugin to the application UI.
 		@param message IN pointer to plugin and call information.
 		@return kNoErr on success, other ASErr otherwise.
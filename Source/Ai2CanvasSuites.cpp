@@ -22,6 +22,15 @@
 
 #include "IllustratorSDK.h"
 #include "Ai2CanvasSuites.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <stdint.h>
+#include <utility>
+#include <vector>
 
 extern "C"
 {
@@ -109,5 +118,399 @@ ImportSuite gImportSuites[] =
 	nullptr, 0, nullptr
 };
 
+// Suite-call profiling
+//
+// Each profiled suite is copied, and the functions the exporter calls are replaced
+// (in the copy) with wrappers that count and time the call before forwarding it to
+// the original. The global suite pointer is pointed at the copy while profiling.
+
+namespace
+{
+	/// Calls and time for a single suite function
+	struct SuiteCall
+	{
+		const char*				name;					// "suite->Function"
+		std::atomic<uint64_t>	calls;
+		std::atomic<uint64_t>	nanoseconds;
+
+		SuiteCall(const char* name) : name(name), calls(0), nanoseconds(0) { }
+	};
+
+	bool profiling = false;
+	std::deque<SuiteCall> suiteCalls;					// (a deque, so counters never move)
+
+	/// Times a call (from construction to destruction)
+	class SuiteCallTimer
+	{
+	private:
+
+		SuiteCall&				call;
+		std::chrono::steady_clock::time_point	start;
+
+	public:
+
+		inline SuiteCallTimer(SuiteCall& call) : call(call), start(std::chrono::steady_clock::now()) { }
+		inline ~SuiteCallTimer()
+		{
+			uint64_t elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+			call.calls.fetch_add(1, std::memory_order_relaxed);
+			call.nanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+		}
+	};
+
+	/// Wraps one suite function (Id makes each wrapped function a distinct type, with its own original)
+	template <typename F, int Id> struct ProfiledFunction;
+
+	template <typename R, typename... Args, int Id>
+	struct ProfiledFunction<R (*)(Args...), Id>
+	{
+		static R				(*original)(Args...);
+		static SuiteCall*		call;
+
+		static R Call(Args... args)
+		{
+			SuiteCallTimer timer(*call);
+			return original(std::forward<Args>(args)...);
+		}
+
+		static void Install(R (*&function)(Args...), const char* name)
+		{
+			// Leave functions that aren't in this suite version alone
+			if (function == nullptr)
+			{
+				return;
+			}
+			suiteCalls.emplace_back(name);
+			call = &suiteCalls.back();
+			original = function;
+			function = &Call;
+		}
+	};
+
+	template <typename R, typename... Args, int Id> R (*ProfiledFunction<R (*)(Args...), Id>::original)(Args...) = nullptr;
+	template <typename R, typename... Args, int Id> SuiteCall* ProfiledFunction<R (*)(Args...), Id>::call = nullptr;
+}
+
+// Profiled copy of a suite (and the acquired suite it was copied from)
+#define PROFILE_SUITE(suite, type) \
+	type profiled_##suite; \
+	type* original_##suite = nullptr;
+
+// Copy an acquired suite (before its functions are wrapped)
+#define COPY_SUITE(suite) \
+	original_##suite = suite; \
+	if (suite) profiled_##suite = *suite;
+
+#define PROFILE_FUNCTION(suite, function) \
+	if (suite) ProfiledFunction<decltype(profiled_##suite.function), __COUNTER__>::Install(profiled_##suite.function, #suite "->" #function);
+
+// Point at the profiled copy
+#define SWAP_SUITE(suite) \
+	if (suite) suite = &profiled_##suite;
+
+#define RESTORE_SUITE(suite) \
+	suite = original_##suite;
+
+namespace
+{
+	PROFILE_SUITE(sAIArt, AIArtSuite)
+	PROFILE_SUITE(sAIPath, AIPathSuite)
+	PROFILE_SUITE(sAIPathStyle, AIPathStyleSuite)
+	PROFILE_SUITE(sAIRealMath, AIRealMathSuite)
+	PROFILE_SUITE(sAIHardSoft, AIHardSoftSuite)
+	PROFILE_SUITE(sAILayer, AILayerSuite)
+	PROFILE_SUITE(sAIBlendStyle, AIBlendStyleSuite)
+	PROFILE_SUITE(sAIMask, AIMaskSuite)
+	PROFILE_SUITE(sAIArtStyle, AIArtStyleSuite)
+	PROFILE_SUITE(sAIArtStyleParser, AIArtStyleParserSuite)
+	PROFILE_SUITE(sAILiveEffect, AILiveEffectSuite)
+	PROFILE_SUITE(sAIDictionary, AIDictionarySuite)
+	PROFILE_SUITE(sAIDictionaryIterator, AIDictionaryIteratorSuite)
+	PROFILE_SUITE(sAIEntry, AIEntrySuite)
+	PROFILE_SUITE(sAIGradient, AIGradientSuite)
+	PROFILE_SUITE(sAICustomColor, AICustomColorSuite)
+	PROFILE_SUITE(sAIColorConversion, AIColorConversionSuite)
+	PROFILE_SUITE(sAIPluginGroup, AIPluginGroupSuite)
+	PROFILE_SUITE(sAISymbol, AISymbolSuite)
+	PROFILE_SUITE(sAIPattern, AIPatternSuite)
+	PROFILE_SUITE(sAIRealBezier, AIRealBezierSuite)
+	PROFILE_SUITE(sAITextFrame, AITextFrameSuite)
+	PROFILE_SUITE(sATEPaint, AIATEPaintSuite)
+	PROFILE_SUITE(sAIFont, AIFontSuite)
+	PROFILE_SUITE(sAIPlaced, AIPlacedSuite)
+	PROFILE_SUITE(sAIRaster, AIRasterSuite)
+	PROFILE_SUITE(sAIImageOpt, AIImageOptSuite)
+	PROFILE_SUITE(sAIDataFilter, AIDataFilterSuite)
+}
+
+// Wrap the suite functions the exporter calls
+void CanvasExport::BeginSuiteProfile()
+{
+	if (profiling)
+	{
+		return;
+	}
+
+	suiteCalls.clear();
+
+	COPY_SUITE(sAIArt)
+	PROFILE_FUNCTION(sAIArt, GetFirstArtOfLayer)
+	PROFILE_FUNCTION(sAIArt, GetArtUserAttr)
+	PROFILE_FUNCTION(sAIArt, GetArtType)
+	PROFILE_FUNCTION(sAIArt, GetArtSibling)
+	PROFILE_FUNCTION(sAIArt, GetArtName)
+	PROFILE_FUNCTION(sAIArt, GetArtFirstChild)
+	PROFILE_FUNCTION(sAIArt, GetArtBounds)
+	SWAP_SUITE(sAIArt)
+
+	COPY_SUITE(sAIPath)
+	PROFILE_FUNCTION(sAIPath, GetPathSegments)
+	PROFILE_FUNCTION(sAIPath, GetPathSegmentCount)
+	PROFILE_FUNCTION(sAIPath, GetPathGuide)
+	PROFILE_FUNCTION(sAIPath, GetPathClosed)
+	SWAP_SUITE(sAIPath)
+
+	COPY_SUITE(sAIPathStyle)
+	PROFILE_FUNCTION(sAIPathStyle, GetPathStyle)
+	SWAP_SUITE(sAIPathStyle)
+
+	COPY_SUITE(sAIRealMath)
+	PROFILE_FUNCTION(sAIRealMath, AIRealMatrixConcatTranslate)
+	PROFILE_FUNCTION(sAIRealMath, AIRealMatrixConcat)
+	PROFILE_FUNCTION(sAIRealMath, AIRealMatrixConcatScale)
+	PROFILE_FUNCTION(sAIRealMath, AIRealMatrixSetIdentity)
+	PROFILE_FUNCTION(sAIRealMath, AIRealMatrixXformPoint)
+	PROFILE_FUNCTION(sAIRealMath, DegreeToRadian)
+	PROFILE_FUNCTION(sAIRealMath, AIRealPointLengthAngle)
+	PROFILE_FUNCTION(sAIRealMath, AIRealPointAdd)
+	SWAP_SUITE(sAIRealMath)
+
+	COPY_SUITE(sAIHardSoft)
+	PROFILE_FUNCTION(sAIHardSoft, AIRealPointHarden)
+	PROFILE_FUNCTION(sAIHardSoft, AIRealMatrixRealSoft)
+	PROFILE_FUNCTION(sAIHardSoft, AIRealMatrixHarden)
+	SWAP_SUITE(sAIHardSoft)
+
+	COPY_SUITE(sAILayer)
+	PROFILE_FUNCTION(sAILayer, CountLayers)
+	PROFILE_FUNCTION(sAILayer, GetNthLayer)
+	PROFILE_FUNCTION(sAILayer, GetLayerVisible)
+	PROFILE_FUNCTION(sAILayer, GetLayerTitle)
+	SWAP_SUITE(sAILayer)
+
+	COPY_SUITE(sAIBlendStyle)
+	PROFILE_FUNCTION(sAIBlendStyle, GetOpacity)
+	PROFILE_FUNCTION(sAIBlendStyle, GetBlendingMode)
+	SWAP_SUITE(sAIBlendStyle)
+
+	COPY_SUITE(sAIMask)
+	PROFILE_FUNCTION(sAIMask, GetMask)
+	SWAP_SUITE(sAIMask)
+
+	COPY_SUITE(sAIArtStyle)
+	PROFILE_FUNCTION(sAIArtStyle, GetArtStyle)
+	SWAP_SUITE(sAIArtStyle)
+
+	COPY_SUITE(sAIArtStyleParser)
+	PROFILE_FUNCTION(sAIArtStyleParser, NewParser)
+	PROFILE_FUNCTION(sAIArtStyleParser, ParseStyle)
+	PROFILE_FUNCTION(sAIArtStyleParser, GetStyleBlendField)
+	PROFILE_FUNCTION(sAIArtStyleParser, CountPostEffects)
+	PROFILE_FUNCTION(sAIArtStyleParser, GetNthPostEffect)
+	PROFILE_FUNCTION(sAIArtStyleParser, GetLiveEffectHandle)
+	PROFILE_FUNCTION(sAIArtStyleParser, GetLiveEffectParams)
+	PROFILE_FUNCTION(sAIArtStyleParser, DisposeParser)
+	SWAP_SUITE(sAIArtStyleParser)
+
+	COPY_SUITE(sAILiveEffect)
+	PROFILE_FUNCTION(sAILiveEffect, GetLiveEffectName)
+	SWAP_SUITE(sAILiveEffect)
+
+	COPY_SUITE(sAIDictionary)
+	PROFILE_FUNCTION(sAIDictionary, Begin)
+	PROFILE_FUNCTION(sAIDictionary, Get)
+	PROFILE_FUNCTION(sAIDictionary, GetKeyString)
+	PROFILE_FUNCTION(sAIDictionary, GetRealEntry)
+	SWAP_SUITE(sAIDictionary)
+
+	COPY_SUITE(sAIDictionaryIterator)
+	PROFILE_FUNCTION(sAIDictionaryIterator, AtEnd)
+	PROFILE_FUNCTION(sAIDictionaryIterator, GetKey)
+	PROFILE_FUNCTION(sAIDictionaryIterator, Next)
+	PROFILE_FUNCTION(sAIDictionaryIterator, Release)
+	SWAP_SUITE(sAIDictionaryIterator)
+
+	COPY_SUITE(sAIEntry)
+	PROFILE_FUNCTION(sAIEntry, ToFillStyle)
+	SWAP_SUITE(sAIEntry)
+
+	COPY_SUITE(sAIGradient)
+	PROFILE_FUNCTION(sAIGradient, GetGradientType)
+	PROFILE_FUNCTION(sAIGradient, GetGradientStopCount)
+	PROFILE_FUNCTION(sAIGradient, GetNthGradientStop)
+	SWAP_SUITE(sAIGradient)
+
+	COPY_SUITE(sAICustomColor)
+	PROFILE_FUNCTION(sAICustomColor, GetCustomColor)
+	SWAP_SUITE(sAICustomColor)
+
+	COPY_SUITE(sAIColorConversion)
+	PROFILE_FUNCTION(sAIColorConversion, ConvertSampleColor)
+	SWAP_SUITE(sAIColorConversion)
+
+	COPY_SUITE(sAIPluginGroup)
+	PROFILE_FUNCTION(sAIPluginGroup, GetPluginArtName)
+	PROFILE_FUNCTION(sAIPluginGroup, GetPluginArtResultArt)
+	PROFILE_FUNCTION(sAIPluginGroup, GetPluginArtClipping)
+	SWAP_SUITE(sAIPluginGroup)
+
+	COPY_SUITE(sAISymbol)
+	PROFILE_FUNCTION(sAISymbol, GetSymbolPatternOfSymbolArt)
+	PROFILE_FUNCTION(sAISymbol, GetSoftTransformOfSymbolArt)
+	SWAP_SUITE(sAISymbol)
+
+	COPY_SUITE(sAIPattern)
+	PROFILE_FUNCTION(sAIPattern, GetPatternArt)
+	PROFILE_FUNCTION(sAIPattern, GetPatternName)
+	SWAP_SUITE(sAIPattern)
+
+	COPY_SUITE(sAIRealBezier)
+	PROFILE_FUNCTION(sAIRealBezier, Set)
+	PROFILE_FUNCTION(sAIRealBezier, Length)
+	PROFILE_FUNCTION(sAIRealBezier, TAtLength)
+	SWAP_SUITE(sAIRealBezier)
+
+	COPY_SUITE(sAITextFrame)
+	PROFILE_FUNCTION(sAITextFrame, GetATETextFrame)
+	SWAP_SUITE(sAITextFrame)
+
+	COPY_SUITE(sATEPaint)
+	PROFILE_FUNCTION(sATEPaint, GetAIColor)
+	SWAP_SUITE(sATEPaint)
+
+	COPY_SUITE(sAIFont)
+	PROFILE_FUNCTION(sAIFont, FontKeyFromFont)
+	PROFILE_FUNCTION(sAIFont, GetSystemFontName)
+	PROFILE_FUNCTION(sAIFont, GetFontStyleName)
+	SWAP_SUITE(sAIFont)
+
+	COPY_SUITE(sAIPlaced)
+	PROFILE_FUNCTION(sAIPlaced, GetPlacedType)
+	PROFILE_FUNCTION(sAIPlaced, GetPlacedMatrix)
+	PROFILE_FUNCTION(sAIPlaced, GetPlacedDimensions)
+	PROFILE_FUNCTION(sAIPlaced, GetPlacedFilePathFromArt)
+	PROFILE_FUNCTION(sAIPlaced, GetRasterInfo)
+	SWAP_SUITE(sAIPlaced)
+
+	COPY_SUITE(sAIRaster)
+	PROFILE_FUNCTION(sAIRaster, GetRasterInfo)
+	PROFILE_FUNCTION(sAIRaster, GetRasterFilePathFromArt)
+	SWAP_SUITE(sAIRaster)
+
+	COPY_SUITE(sAIImageOpt)
+	PROFILE_FUNCTION(sAIImageOpt, MakePNG24)
+	SWAP_SUITE(sAIImageOpt)
+
+	COPY_SUITE(sAIDataFilter)
+	PROFILE_FUNCTION(sAIDataFilter, NewFileDataFilter)
+	PROFILE_FUNCTION(sAIDataFilter, LinkDataFilter)
+	PROFILE_FUNCTION(sAIDataFilter, UnlinkDataFilter)
+	SWAP_SUITE(sAIDataFilter)
+
+	profiling = true;
+}
+
+// Point back at the acquired suites (the counts are kept until the next profile begins)
+void CanvasExport::EndSuiteProfile()
+{
+	if (!profiling)
+	{
+		return;
+	}
+
+	RESTORE_SUITE(sAIArt)
+	RESTORE_SUITE(sAIPath)
+	RESTORE_SUITE(sAIPathStyle)
+	RESTORE_SUITE(sAIRealMath)
+	RESTORE_SUITE(sAIHardSoft)
+	RESTORE_SUITE(sAILayer)
+	RESTORE_SUITE(sAIBlendStyle)
+	RESTORE_SUITE(sAIMask)
+	RESTORE_SUITE(sAIArtStyle)
+	RESTORE_SUITE(sAIArtStyleParser)
+	RESTORE_SUITE(sAILiveEffect)
+	RESTORE_SUITE(sAIDictionary)
+	RESTORE_SUITE(sAIDictionaryIterator)
+	RESTORE_SUITE(sAIEntry)
+	RESTORE_SUITE(sAIGradient)
+	RESTORE_SUITE(sAICustomColor)
+	RESTORE_SUITE(sAIColorConversion)
+	RESTORE_SUITE(sAIPluginGroup)
+	RESTORE_SUITE(sAISymbol)
+	RESTORE_SUITE(sAIPattern)
+	RESTORE_SUITE(sAIRealBezier)
+	RESTORE_SUITE(sAITextFrame)
+	RESTORE_SUITE(sATEPaint)
+	RESTORE_SUITE(sAIFont)
+	RESTORE_SUITE(sAIPlaced)
+	RESTORE_SUITE(sAIRaster)
+	RESTORE_SUITE(sAIImageOpt)
+	RESTORE_SUITE(sAIDataFilter)
+
+	profiling = false;
+}
+
+// Write the called functions as a table, ranked by total time
+bool CanvasExport::WriteSuiteProfile(const std::string& filePath)
+{
+	std::vector<const SuiteCall*> ranked;
+	uint64_t totalCalls = 0;
+	uint64_t totalNanoseconds = 0;
+	for (const SuiteCall& call : suiteCalls)
+	{
+		if (call.calls > 0)
+		{
+			ranked.push_back(&call);
+			totalCalls += call.calls;
+			totalNanoseconds += call.nanoseconds;
+		}
+	}
+	std::stable_sort(ranked.begin(), ranked.end(), [](const SuiteCall* call1, const SuiteCall* call2)
+	{
+		return (call1->nanoseconds > call2->nanoseconds);
+	});
+
+	std::ofstream file;
+	file.open(filePath.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << std::setiosflags(std::ios::fixed) <<
+		std::left << std::setw(6) << "Rank" << std::setw(52) << "Function" << std::right <<
+		std::setw(12) << "Calls" << std::setw(14) << "Total (ms)" << std::setw(12) << "ns/call" << std::setw(10) << "Time %" << "\n";
+
+	for (size_t i = 0; i < ranked.size(); i++)
+	{
+		const SuiteCall& call = *ranked[i];
+		uint64_t calls = call.calls;
+		uint64_t nanoseconds = call.nanoseconds;
+
+		file << std::left << std::setw(6) << (i + 1) << std::setw(52) << call.name << std::right <<
+			std::setw(12) << calls <<
+			std::setw(14) << std::setprecision(3) << (nanoseconds / 1000000.0) <<
+			std::setw(12) << std::setprecision(0) << ((double)nanoseconds / calls) <<
+			std::setw(10) << std::setprecision(1) << (totalNanoseconds > 0 ? (100.0 * nanoseconds / totalNanoseconds) : 0.0) << "\n";
+	}
+
+	file << std::left << std::setw(6) << "" << std::setw(52) << "Total" << std::right <<
+		std::setw(12) << totalCalls <<
+		std::setw(14) << std::setprecision(3) << (totalNanoseconds / 1000000.0) << "\n";
+
+	file.close();
+
+	return true;
+}
 
 // End Ai2CanvasSuites.cpp
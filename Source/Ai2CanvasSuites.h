@@ -37,6 +37,7 @@
 #include "AIPattern.h"
 #include "AIPathStyle.h"
 #include "AIGradient.h"
+#include <string>
 
 extern	"C"	AIUnicodeStringSuite*	sAIUnicodeString;
 extern  "C" SPBlocksSuite*			sSPBlocks;
@@ -76,4 +77,12 @@ extern "C" AIBlendStyleSuite *sAIBlendStyle;
 extern "C" AILayerSuite *sAILayer;
 extern "C" AIRealBezierSuite *sAIRealBezier;
 
+namespace CanvasExport
+{
+	// Suite-call profiling (while enabled, the suite pointers above point to copies that count and time each call)
+	void BeginSuiteProfile();
+	void EndSuiteProfile();
+	bool WriteSuiteProfile(const std::string& filePath);
+}
+
 #endif // End Ai2CanvasSuites.h
@@ -57,16 +57,15 @@ void AnimationClock::JSClockInit(const std::string& objectName)
 	if (direction != kNone)
 	{
 		outFile <<   "\n      " << objectName << "." << name << " = new clock(" <<
-			setiosflags(ios::fixed) << setprecision(2) << duration << ", " <<
-			delay << ", " <<
-			direction << ", " <<
+			Fixed<2>(duration) << ", " <<
+			Fixed<2>(delay) << ", " <<
+			(int)direction << ", " <<
 			(reverses ? "true" : "false") << ", " <<
 			iterations << ", " <<
 			timingFunction << ", " <<
 			rangeExpression << ", " <<
-			multiplier << ", " <<
-			setprecision(4) <<				// Increase precision to accomodate Firefox 3.x scaling issue
-			offset <<
+			Fixed<2>(multiplier) << ", " <<
+			Fixed<4>(offset) <<				// Increase precision to accomodate Firefox 3.x scaling issue
 			");";
 
 		if (debug)
@@ -177,8 +176,7 @@ void AnimationClock::SetParameter(const std::string& parameter, const std::strin
 
 		if (debug)
 		{
-			outFile << "\n//     duration = " << setiosflags(ios::fixed) << setprecision(2) <<
-				this->duration << " seconds";
+			outFile << "\n//     duration = " << Fixed<2>(this->duration) << " seconds";
 		}
 	}
 
@@ -196,8 +194,7 @@ void AnimationClock::SetParameter(const std::string& parameter, const std::strin
 
 		if (debug)
 		{
-			outFile << "\n//     delay = " << setiosflags(ios::fixed) << setprecision(2) <<
-				this->delay << " seconds";
+			outFile << "\n//     delay = " << Fixed<2>(this->delay) << " seconds";
 		}
 	}
 
@@ -272,8 +269,7 @@ void AnimationClock::SetParameter(const std::string& parameter, const std::strin
 
 			if (debug)
 			{
-				outFile << "\n//     iterations = " << setiosflags(ios::fixed) << setprecision(2) <<
-					this->iterations;
+				outFile << "\n//     iterations = " << this->iterations;
 			}
 		}
 	}
@@ -327,8 +323,7 @@ void AnimationClock::SetParameter(const std::string& parameter, const std::strin
 
 		if (debug)
 		{
-			outFile << "\n//     multiplier = " << setiosflags(ios::fixed) << setprecision(2) <<
-				this->multiplier;
+			outFile << "\n//     multiplier = " << Fixed<2>(this->multiplier);
 		}
 	}
 
@@ -346,8 +341,7 @@ void AnimationClock::SetParameter(const std::string& parameter, const std::strin
 
 		if (debug)
 		{
-			outFile << "\n//     offset = " << setiosflags(ios::fixed) << setprecision(2) <<
-				this->offset;
+			outFile << "\n//     offset = " << Fixed<2>(this->offset);
 		}
 	}
 
@@ -31,7 +31,7 @@
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	// Represents an animation clock
@@ -56,9 +56,9 @@ void AnimationFunction::RenderInit(const AIRealRect& documentBounds)
 
 	// Re-set matrix based on document
 	// TODO: Need to make this more isolated/encapsulated
-	sAIRealMath->AIRealMatrixSetIdentity(&canvas->currentState->internalTransform);
-	sAIRealMath->AIRealMatrixConcatScale(&canvas->currentState->internalTransform, 1, -1);
-	sAIRealMath->AIRealMatrixConcatTranslate(&canvas->currentState->internalTransform, - 1 * documentBounds.left, documentBounds.top);
+	RealMatrixSetIdentity(&canvas->currentState->internalTransform);
+	RealMatrixConcatScale(&canvas->currentState->internalTransform, 1, -1);
+	RealMatrixConcatTranslate(&canvas->currentState->internalTransform, - 1 * documentBounds.left, documentBounds.top);
 
 	// Render animation
 	RenderArt(rootArtHandle, 1);
@@ -119,7 +119,7 @@ void AnimationFunction::RenderArt(AIArtHandle artHandle, unsigned int depth)
 		// Is this art visible?
 		AIBoolean isArtVisible = false;
 		ai::int32 attr = 0;
-		sAIArt->GetArtUserAttr(artHandle, kArtHidden, &attr);
+		artSource->GetArtUserAttr(artHandle, kArtHidden, &attr);
 		isArtVisible = !((attr &kArtHidden) == kArtHidden);
 
 		// Only render if art is visible
@@ -127,7 +127,7 @@ void AnimationFunction::RenderArt(AIArtHandle artHandle, unsigned int depth)
 		{
 			// Get type
 			short artType = 0;
-			sAIArt->GetArtType(artHandle, &artType);
+			artSource->GetArtType(artHandle, &artType);
 
 			// Process based on art type
 			switch (artType)
@@ -152,7 +152,7 @@ void AnimationFunction::RenderArt(AIArtHandle artHandle, unsigned int depth)
 		}
 
 		// Find the next sibling
-		sAIArt->GetArtSibling(artHandle, &artHandle);
+		artSource->GetArtSibling(artHandle, &artHandle);
 	}
 	while (artHandle != nullptr);
 }
@@ -161,7 +161,7 @@ void AnimationFunction::RenderGroupArt(AIArtHandle artHandle, unsigned int depth
 {
 	// Get the first art element in the group
 	AIArtHandle childArtHandle = nullptr;
-	sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
+	artSource->GetArtFirstChild(artHandle, &childArtHandle);
 
 	// Render this sub-group
 	RenderArt(childArtHandle, depth + 1);
@@ -171,7 +171,7 @@ void AnimationFunction::RenderCompoundPathArt(AIArtHandle artHandle, unsigned in
 {
 	// Get the first art element in the group
 	AIArtHandle childArtHandle = nullptr;
-	sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
+	artSource->GetArtFirstChild(artHandle, &childArtHandle);
 
 	// Render this sub-group
 	RenderPathArt(childArtHandle, depth + 1);
@@ -181,13 +181,13 @@ void AnimationFunction::RenderPathArt(AIArtHandle artHandle, unsigned int depth)
 {
 	// Skip if this path is a "guide"
 	AIBoolean isGuide = false;
-	sAIPath->GetPathGuide(artHandle, &isGuide);
+	artSource->GetPathGuide(artHandle, &isGuide);
 	if (!isGuide)
 	{
 		// Is this art part of a compound path?
 		AIBoolean isCompound = false;
 		ai::int32 attr = 0;
-		sAIArt->GetArtUserAttr(artHandle, kArtPartOfCompound, &attr);
+		artSource->GetArtUserAttr(artHandle, kArtPartOfCompound, &attr);
 		isCompound = ((attr &kArtPartOfCompound) == kArtPartOfCompound);
 
 		do
@@ -198,7 +198,7 @@ void AnimationFunction::RenderPathArt(AIArtHandle artHandle, unsigned int depth)
 			// If this is a compound path, get the next sibling
 			if (isCompound)
 			{
-				sAIArt->GetArtSibling(artHandle, &artHandle);
+				artSource->GetArtSibling(artHandle, &artHandle);
 			}
 
 		}
@@ -212,70 +212,50 @@ void AnimationFunction::RenderPathFigure(AIArtHandle artHandle, unsigned int dep
 {
 	// Is this a closed path?
 	AIBoolean pathClosed = false;
-	sAIPath->GetPathClosed(artHandle, &pathClosed);
+	artSource->GetPathClosed(artHandle, &pathClosed);
 
-	// Get the path starting point
-	AIPathSegment segment;
-	sAIPath->GetPathSegments(artHandle, 0, 1, &segment);
-
-	// Remember the first segment, in case we have to create an extra segment to close the figure
-	AIPathSegment firstSegment = segment;
-
-	// Transform starting point
-	TransformPoint(segment.p);
-	TransformPoint(segment.in);
-	TransformPoint(segment.out);
-
-	// Move to the first point
-	//fprintf(m_fp, "\n%s%s.moveTo(%.1f, %.1f);", Indent(depth), canvas->contextName.c_str(), x, y);
-
-	// How many segments are in this path?
-	short segmentCount = 0;
-	sAIPath->GetPathSegmentCount(artHandle, &segmentCount);
-
-	// Track the last out point
-	AIPathSegment previousSegment = segment;
+	// Get and transform all of the segments at once
+	SegmentBuffer& segments = canvas->documentResources->segments;
+	size_t segmentCount = segments.Fetch(artHandle);
+	if (segmentCount == 0)
+	{
+		return;
+	}
+	segments.Transform(canvas->currentState->internalTransform);
 
 	// Loop through each segment
-	for (short segmentIndex = 1; segmentIndex < segmentCount; segmentIndex++)
+	for (size_t segmentIndex = 1; segmentIndex < segmentCount; segmentIndex++)
 	{
-		sAIPath->GetPathSegments(artHandle, segmentIndex, 1, &segment);
-
-		RenderSegment(previousSegment, segment, depth);
-
-		previousSegment = segment;
+		RenderSegment(segments, segmentIndex - 1, segmentIndex, depth);
 	}
 
 	// Handle closing segment
 	if (pathClosed)
 	{
 		// Create "phantom" extra segment to accomodate curve
-		RenderSegment(previousSegment, firstSegment, depth);
+		RenderSegment(segments, segmentCount - 1, 0, depth);
 	}
 }
 
-void AnimationFunction::RenderSegment(AIPathSegment& previousSegment, AIPathSegment& segment, unsigned int depth)
+// Output the segment from previous to current (both already transformed)
+void AnimationFunction::RenderSegment(const SegmentBuffer& segments, size_t previous, size_t current, unsigned int depth)
 {
-	// Transform points
-	TransformPoint(segment.p);
-	TransformPoint(segment.in);
-	TransformPoint(segment.out);
+	AIRealPoint previousPoint = segments.Point(previous);
+	AIRealPoint point = segments.Point(current);
 
-	AIReal x1 = previousSegment.out.h;
-	AIReal y1 = previousSegment.out.v;
-	AIReal x2 = segment.in.h;
-	AIReal y2 = segment.in.v;
+	AIReal x1 = segments.outx[previous];
+	AIReal y1 = segments.outy[previous];
+	AIReal x2 = segments.inx[current];
+	AIReal y2 = segments.iny[current];
 
 	// Is this a straight line segment?
-	AIBoolean isLine = ((previousSegment.p.h == previousSegment.out.h && previousSegment.p.v == previousSegment.out.v) &&
-						(segment.p.h == segment.in.h && segment.p.v == segment.in.v));
-	if (isLine)
+	if (segments.IsLine(previous, current))
 	{
 		// Optimize point locations
-		x1 = ((segment.p.h - previousSegment.p.h) * 0.33f) + previousSegment.p.h;
-		y1 = ((segment.p.v - previousSegment.p.v) * 0.33f) + previousSegment.p.v;
-		x2 = ((segment.p.h - previousSegment.p.h) * 0.66f) + previousSegment.p.h;
-		y2 = ((segment.p.v - previousSegment.p.v) * 0.66f) + previousSegment.p.v;
+		x1 = ((point.h - previousPoint.h) * 0.33f) + previousPoint.h;
+		y1 = ((point.v - previousPoint.v) * 0.33f) + previousPoint.v;
+		x2 = ((point.h - previousPoint.h) * 0.66f) + previousPoint.h;
+		y2 = ((point.v - previousPoint.v) * 0.66f) + previousPoint.v;
 	}
 
 	// If this isn't the first segment, include separator
@@ -286,10 +266,10 @@ void AnimationFunction::RenderSegment(AIPathSegment& previousSegment, AIPathSegm
 
 	// Output Bezier segment
 	outFile << "\n" << Indent(depth) << "              [ " <<
-		"[" << setiosflags(ios::fixed) << setprecision(1) << previousSegment.p.h << ", " << previousSegment.p.v << "]" <<
-		", [" << x1 << ", " << y1 << "]" <<
-		", [" << x2 << ", " << y2 << "]" <<
-		", [" << segment.p.h << ", " << segment.p.v << "] ]";
+		"[" << Fixed<1>(previousPoint.h) << ", " << Fixed<1>(previousPoint.v) << "]" <<
+		", [" << Fixed<1>(x1) << ", " << Fixed<1>(y1) << "]" <<
+		", [" << Fixed<1>(x2) << ", " << Fixed<1>(y2) << "]" <<
+		", [" << Fixed<1>(point.h) << ", " << Fixed<1>(point.v) << "] ]";
 
 	AIRealPoint p1;
 	AIRealPoint p2;
@@ -300,9 +280,9 @@ void AnimationFunction::RenderSegment(AIPathSegment& previousSegment, AIPathSegm
 
 	const AIReal FLATNESS = 1e-2f; // Adobe recommended value
 	AIRealBezier b;
-	sAIRealBezier->Set(&b, &previousSegment.p, &p1, &p2, &segment.p);
-	AIReal bezierSegmentLength = sAIRealBezier->Length(&b, FLATNESS);
-	//outFile << "\n" << Indent(depth) << "              // Length = " << setiosflags(ios::fixed) << setprecision(2) << segmentLength;
+	RealBezierSet(&b, &previousPoint, &p1, &p2, &point);
+	AIReal bezierSegmentLength = RealBezierLength(&b, FLATNESS);
+	//outFile << "\n" << Indent(depth) << "              // Length = " << Fixed<2>(segmentLength);
 
 	// Remember for later
 	BezierInfo bi;
@@ -371,8 +351,8 @@ void AnimationFunction::ArcLength(unsigned int depth)
 		else
 		{
 			// Now that we found the segment, find the t value within the segment
-			sAIRealBezier->TAtLength(&beziers[s].b, remainingSearchLength, beziers[s].length, FLATNESS, &t);
-			//outFile << "\n" << Indent(depth) << "                // t at length " << setiosflags(ios::fixed) << setprecision(2) << length << " = " << t;
+			RealBezierTAtLength(&beziers[s].b, remainingSearchLength, beziers[s].length, FLATNESS, &t);
+			//outFile << "\n" << Indent(depth) << "                // t at length " << Fixed<2>(length) << " = " << Fixed<2>(t);
 		}
 
 		// Separator
@@ -387,8 +367,7 @@ void AnimationFunction::ArcLength(unsigned int depth)
 			outFile << "\n" << Indent(depth) << "              ";
 		}
 
-		outFile << "[" << setiosflags(ios::fixed) << setprecision(2) <<
-			s << ", " << t << ", " << totalS << "]";
+		outFile << "[" << s << ", " << Fixed<2>(t) << ", " << Fixed<2>(totalS) << "]";
 	}
 
 	// End function block
@@ -407,7 +386,7 @@ void AnimationFunction::ArcLength(unsigned int depth)
 		{
 			outFile << ", ";
 		}
-		outFile << setiosflags(ios::fixed) << setprecision(2) << (runningLength / totalLength);
+		outFile << Fixed<2>(runningLength / totalLength);
 	}
 
 	// End block
@@ -420,11 +399,6 @@ void AnimationFunction::Bezier(const AIRealBezier& b, AIReal u, AIReal& x, AIRea
 	y = pow(u, 3) * (b.p3.v + 3 * (b.p1.v - b.p2.v) - b.p0.v) + 3 * pow(u, 2) * (b.p0.v - 2 * b.p1.v + b.p2.v) + 3 * u * (b.p1.v - b.p0.v) + b.p0.v;
 }
 
-void AnimationFunction::TransformPoint(AIRealPoint& point)
-{
-	sAIRealMath->AIRealMatrixXformPoint(&canvas->currentState->internalTransform, &point, &point);
-}
-
 void AnimationFunction::SetParameter(const std::string& parameter, const std::string& value)
 {
 	// Allow path clock to parse its own parameters
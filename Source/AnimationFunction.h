@@ -32,7 +32,7 @@
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	struct BezierInfo
@@ -71,8 +71,7 @@ namespace CanvasExport
 		void				RenderCompoundPathArt(AIArtHandle artHandle, unsigned int depth);
 		void				RenderPathArt(AIArtHandle artHandle, unsigned int depth);
 		void				RenderPathFigure(AIArtHandle artHandle, unsigned int depth);
-		void				RenderSegment(AIPathSegment& previousSegment, AIPathSegment& segment, unsigned int depth);
-		void				TransformPoint(AIRealPoint& point);
+		void				RenderSegment(const SegmentBuffer& segments, size_t previous, size_t current, unsigned int depth);
 		void				Bezier(const AIRealBezier& b, AIReal u, AIReal& x, AIReal& y);
 		void				ArcLength(unsigned int depth);
 	};
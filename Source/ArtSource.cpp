@@ -0,0 +1,130 @@
+// ArtSource.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "ArtSource.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace CanvasExport;
+
+// Characters that are left as-is in a file URL (everything else is percent-encoded)
+static const char* kURLCharacters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~/:";
+
+void ArtSource::AIRealPointHarden(const AIRealPoint* source, AIRealPoint* destination)
+{
+	*destination = *source;
+}
+
+void ArtSource::AIRealMatrixHarden(AIRealMatrix* matrix)
+{
+	(void)matrix;
+}
+
+void ArtSource::AIRealMatrixRealSoft(AIRealMatrix* matrix)
+{
+	(void)matrix;
+}
+
+// Gray, CMYK and RGB samples can be converted to RGB
+AIErr ArtSource::ConvertSampleColor(ai::int32 srcSpace, const SampleComponent* srcColor, ai::int32 dstSpace, SampleComponent* dstColor, ASBoolean* inGamut)
+{
+	if (dstSpace != kAIRGBColorSpace)
+	{
+		return kBadParameterErr;
+	}
+
+	switch (srcSpace)
+	{
+		case kAIGrayColorSpace:
+		{
+			dstColor[0] = srcColor[0];
+			dstColor[1] = srcColor[0];
+			dstColor[2] = srcColor[0];
+			break;
+		}
+		case kAICMYKColorSpace:
+		{
+			dstColor[0] = (1 - srcColor[0]) * (1 - srcColor[3]);
+			dstColor[1] = (1 - srcColor[1]) * (1 - srcColor[3]);
+			dstColor[2] = (1 - srcColor[2]) * (1 - srcColor[3]);
+			break;
+		}
+		case kAIRGBColorSpace:
+		{
+			dstColor[0] = srcColor[0];
+			dstColor[1] = srcColor[1];
+			dstColor[2] = srcColor[2];
+			break;
+		}
+		default:
+		{
+			return kBadParameterErr;
+		}
+	}
+
+	if (inGamut)
+	{
+		*inGamut = true;
+	}
+	return kNoErr;
+}
+
+// A "file:" URL (a relative path is written as if it were at the root, just as Illustrator does)
+AIErr ArtSource::GetFileURL(const std::string& filePath, std::string& url)
+{
+	std::string path = filePath;
+	for (size_t i = 0; i < path.length(); i++)
+	{
+		if (path[i] == '\\')
+		{
+			path[i] = '/';
+		}
+	}
+
+	url = (path.length() > 0 && path[0] == '/') ? "file://" : "file:///";
+	for (size_t i = 0; i < path.length(); i++)
+	{
+		if (strchr(kURLCharacters, path[i]) != nullptr)
+		{
+			url += path[i];
+		}
+		else
+		{
+			char encoded[4];
+			snprintf(encoded, sizeof(encoded), "%%%02X", (unsigned char)path[i]);
+			url += encoded;
+		}
+	}
+
+	return kNoErr;
+}
+
+void ArtSource::BeginProfile()
+{
+}
+
+void ArtSource::EndProfile(const std::string& filePath)
+{
+	(void)filePath;
+}
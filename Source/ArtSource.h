@@ -0,0 +1,189 @@
+// ArtSource.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef ARTSOURCE_H
+#define ARTSOURCE_H
+
+#include "IllustratorSDK.h"
+#include "AIColorConversion.h"
+#include "AIGradient.h"
+#include "AIPathStyle.h"
+#include "AIPattern.h"
+#include <string>
+#include <vector>
+
+// Accommodate color component type based on SDK version
+#if kPluginInterfaceVersion > kPluginInterfaceVersion16001
+	typedef AIFloatSampleComponent SampleComponent;
+#else
+	typedef AISampleComponent SampleComponent;
+#endif
+
+namespace CanvasExport
+{
+	// Drop shadow parameters
+	// NOTE: Should this move to State? That's where it is in the canvas spec.
+	struct DropShadow
+	{
+		AIReal			horz;						// Horizontal offset
+		AIReal			vert;						// Vertical offset
+		AIReal			blur;						// Blur amount
+		AIFillStyle		shadowStyle;				// Fill style
+		AIReal			opac;						// Opacity
+	};
+
+	// A Live Effect applied to art (only drop shadows are rendered)
+	struct LiveEffect
+	{
+		std::string		name;						// Live Effect name
+		bool			isDropShadow;				// Is this an "Adobe Drop Shadow"?
+		DropShadow		dropShadow;					// Drop shadow parameters (if isDropShadow)
+	};
+
+	// A run of glyphs that share character features
+	// Features that aren't assigned locally are flagged, so they aren't applied
+	struct GlyphRun
+	{
+		std::string		contents;					// Characters (platform encoding)
+		AIReal			fontSize;					// Font size
+		bool			hasFont;					// Is a font assigned?
+		std::string		fontName;					// System font name
+		std::string		fontStyleName;				// Font style name ("Regular", "Bold", etc.)
+		AIReal			verticalScale;				// Vertical scale (1.0 if not assigned)
+		AIReal			horizontalScale;			// Horizontal scale (1.0 if not assigned)
+		AIRealMatrix	matrix;						// Glyph run matrix
+		AIRealPoint		origin;						// Origin of the first glyph
+		bool			hasFill;					// Are the glyphs filled (with an assigned color)?
+		AIColor			fillColor;					// Fill color
+		bool			hasStroke;					// Are the glyphs stroked (with an assigned color)?
+		AIColor			strokeColor;				// Stroke color
+		bool			hasLineWidth;				// Is a stroke width assigned?
+		AIReal			lineWidth;					// Stroke width
+		bool			hasLineCap;					// Is a line cap assigned?
+		AILineCap		lineCap;					// Line cap
+		bool			hasLineJoin;				// Is a line join assigned?
+		AILineJoin		lineJoin;					// Line join
+	};
+
+	// A line of text
+	struct TextLine
+	{
+		std::vector<GlyphRun>	glyphRuns;			// Glyph runs (runs without any characters are left out)
+	};
+
+	// Text frame contents, as the exporter reads them from Illustrator's text engine
+	struct TextFrame
+	{
+		AIRealMatrix			matrix;				// Text frame matrix
+		std::vector<TextLine>	lines;				// Lines of text
+	};
+
+	/// Where the exporter reads layers, art, paths and styles from
+	/// Functions match the Illustrator suite functions they replace, so they can be swapped in place
+	/// Nothing else in the export reads from the suites, so sources other than the current document work outside of Illustrator
+	class ArtSource
+	{
+	public:
+
+		virtual ~ArtSource() {}
+
+		// Layers
+		virtual AIErr		CountLayers(ai::int32* count) = 0;
+		virtual AIErr		GetNthLayer(ai::int32 n, AILayerHandle* layer) = 0;
+		virtual AIErr		GetLayerVisible(AILayerHandle layer, AIBoolean* visible) = 0;
+		virtual AIErr		GetLayerTitle(AILayerHandle layer, std::string& title) = 0;
+		virtual AIErr		GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art) = 0;
+
+		// Art tree
+		virtual AIErr		GetArtFirstChild(AIArtHandle art, AIArtHandle* child) = 0;
+		virtual AIErr		GetArtSibling(AIArtHandle art, AIArtHandle* sibling) = 0;
+		virtual AIErr		GetArtType(AIArtHandle art, short* type) = 0;
+		virtual AIErr		GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr) = 0;
+		virtual AIErr		GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName) = 0;
+		virtual AIErr		GetArtBounds(AIArtHandle art, AIRealRect* bounds) = 0;
+
+		// Appearance
+		virtual AIReal		GetOpacity(AIArtHandle art) = 0;
+		virtual AIBlendingMode	GetBlendingMode(AIArtHandle art) = 0;
+		virtual AIErr		GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects) = 0;
+		virtual AIErr		GetMask(AIArtHandle art, AIMaskRef* mask) = 0;
+		virtual AIErr		GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping) = 0;
+
+		/// Can art be rasterized (only art in an Illustrator document can)?
+		virtual bool		CanRasterize() = 0;
+		virtual AIErr		RasterizeArtToPNG(AIArtHandle art, const std::string& filePath) = 0;
+
+		// Paths
+		virtual AIErr		GetPathSegmentCount(AIArtHandle path, short* count) = 0;
+		virtual AIErr		GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments) = 0;
+		virtual AIErr		GetPathClosed(AIArtHandle path, AIBoolean* closed) = 0;
+		virtual AIErr		GetPathGuide(AIArtHandle path, AIBoolean* isGuide) = 0;
+		virtual AIErr		GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill) = 0;
+
+		// Paints (handles come from path styles)
+		virtual AIErr		GetGradientType(AIGradientHandle gradient, short* type) = 0;
+		virtual AIErr		GetGradientStopCount(AIGradientHandle gradient, short* count) = 0;
+		virtual AIErr		GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop) = 0;
+		virtual AIErr		GetPatternArt(AIPatternHandle pattern, AIArtHandle* art) = 0;
+		virtual AIErr		GetPatternName(AIPatternHandle pattern, std::string& name) = 0;
+		virtual AIErr		GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor) = 0;
+
+		// Symbols (symbol patterns are read like any other pattern)
+		virtual AIErr		GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern) = 0;
+		virtual AIErr		GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform) = 0;
+
+		// Plug-in art
+		virtual AIErr		GetPluginArtName(AIArtHandle art, std::string& name) = 0;
+		virtual AIErr		GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt) = 0;
+
+		// Placed and raster art
+		virtual AIErr		GetPlacedType(AIArtHandle art, short* type) = 0;
+		virtual AIErr		GetPlacedFilePath(AIArtHandle art, std::string& filePath) = 0;
+		virtual AIErr		GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix) = 0;
+		virtual AIErr		GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster) = 0;
+		virtual AIErr		GetRasterFilePath(AIArtHandle art, std::string& filePath) = 0;
+
+		// Text
+		virtual AIErr		GetTextFrame(AIArtHandle art, TextFrame& textFrame) = 0;
+
+		// Coordinates (art outside of an Illustrator document has no ruler origin, so its coordinates are already hard)
+		virtual void		AIRealPointHarden(const AIRealPoint* source, AIRealPoint* destination);
+		virtual void		AIRealMatrixHarden(AIRealMatrix* matrix);
+		virtual void		AIRealMatrixRealSoft(AIRealMatrix* matrix);
+
+		// Colors (without Illustrator's color management, colors are converted with the uncalibrated formulas)
+		virtual AIErr		ConvertSampleColor(ai::int32 srcSpace, const SampleComponent* srcColor, ai::int32 dstSpace, SampleComponent* dstColor, ASBoolean* inGamut);
+
+		// Files
+		virtual AIErr		GetFileURL(const std::string& filePath, std::string& url);
+
+		// Call profiling (only suite calls are profiled)
+		virtual void		BeginProfile();
+		virtual void		EndProfile(const std::string& filePath);
+	};
+
+	// Globals
+	extern ArtSource* artSource;
+}
+
+#endif
@@ -0,0 +1,178 @@
+// ArtTable.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "ArtTable.h"
+
+using namespace CanvasExport;
+
+ArtTable::ArtTable()
+{
+}
+
+ArtTable::~ArtTable()
+{
+}
+
+// Capture art, its siblings and (for visible art) all of their children
+// Returns the index of the first node (a chain that's already been captured is only captured once)
+uint32_t ArtTable::AddChain(AIArtHandle artHandle)
+{
+	if (artHandle == nullptr)
+	{
+		return kNone;
+	}
+
+	// Already captured?
+	std::unordered_map<AIArtHandle, uint32_t>::const_iterator chain = chains.find(artHandle);
+	if (chain != chains.end())
+	{
+		return chain->second;
+	}
+
+	uint32_t first = kNone;
+	uint32_t previous = kNone;
+	do
+	{
+		uint32_t index = AddNode(artHandle);
+
+		// Link to the previous sibling
+		if (previous == kNone)
+		{
+			first = index;
+		}
+		else
+		{
+			nodes[previous].sibling = index;
+		}
+		previous = index;
+
+		// Capture children of visible art
+		if (!HasFlag(index, kNodeHidden))
+		{
+			AIArtHandle childArtHandle = nullptr;
+			artSource->GetArtFirstChild(artHandle, &childArtHandle);
+			if (childArtHandle)
+			{
+				uint32_t child = AddChain(childArtHandle);
+				nodes[index].child = child;
+			}
+		}
+
+		// Find the next sibling
+		artSource->GetArtSibling(artHandle, &artHandle);
+	}
+	while (artHandle != nullptr);
+
+	chains[nodes[first].handle] = first;
+
+	return first;
+}
+
+// Capture a single art object (without links)
+uint32_t ArtTable::AddNode(AIArtHandle artHandle)
+{
+	ArtNode node;
+	node.handle = artHandle;
+	node.child = kNone;
+	node.sibling = kNone;
+	node.name = kNone;
+	node.type = 0;
+	node.flags = 0;
+	node.opacity = 1.0f;
+	node.bounds.left = node.bounds.top = node.bounds.right = node.bounds.bottom = 0;
+
+	ai::int32 attr = 0;
+	artSource->GetArtUserAttr(artHandle, kArtHidden | kArtPartOfCompound, &attr);
+	if ((attr & kArtHidden) == kArtHidden)
+	{
+		node.flags |= kNodeHidden;
+	}
+	if ((attr & kArtPartOfCompound) == kArtPartOfCompound)
+	{
+		node.flags |= kNodeCompound;
+	}
+
+	// Type and style are needed even for hidden art (a hidden clipping path still changes the painting order)
+	artSource->GetArtType(artHandle, &node.type);
+
+	AIPathStyle style;
+	AIBoolean outHasAdvFill = false;
+	artSource->GetPathStyle(artHandle, &style, &outHasAdvFill);
+	node.style = styles.Add(style);
+
+	if (node.type == kPluginArt)
+	{
+		// Clipping plug-in art (like Pathfinder) doesn't use the style attribute
+		AIBoolean clipping = false;
+		artSource->GetPluginArtClipping(artHandle, &clipping);
+		if (clipping)
+		{
+			node.flags |= kNodeClip;
+		}
+	}
+	else if (style.clip)
+	{
+		node.flags |= kNodeClip;
+	}
+
+	if (!(node.flags & kNodeHidden))
+	{
+		artSource->GetArtBounds(artHandle, &node.bounds);
+		node.opacity = artSource->GetOpacity(artHandle);
+
+		if (node.type == kPathArt)
+		{
+			AIBoolean isGuide = false;
+			artSource->GetPathGuide(artHandle, &isGuide);
+			if (isGuide)
+			{
+				node.flags |= kNodeGuide;
+			}
+		}
+
+		AIMaskRef mask = nullptr;
+		artSource->GetMask(artHandle, &mask);
+		if (mask != nullptr)
+		{
+			node.flags |= kNodeMasked;
+		}
+	}
+
+	nodes.push_back(node);
+	return (uint32_t)(nodes.size() - 1);
+}
+
+// Art name (only looked up the first time it's needed, since names are only used for breadcrumbs and debugging)
+const std::string& ArtTable::Name(uint32_t index)
+{
+	if (nodes[index].name == kNone)
+	{
+		std::string artName;
+		AIBoolean isDefaultName = false;
+		artSource->GetArtName(nodes[index].handle, artName, &isDefaultName);
+
+		nodes[index].name = (uint32_t)names.size();
+		names.push_back(artName);
+	}
+	return names[nodes[index].name];
+}
@@ -0,0 +1,91 @@
+// ArtTable.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef ARTTABLE_H
+#define ARTTABLE_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "StyleCollection.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// A single art object, as captured while scanning
+	struct ArtNode
+	{
+		AIArtHandle			handle;
+		uint32_t			child;						// Index of the first child (or ArtTable::kNone)
+		uint32_t			sibling;					// Index of the next sibling (or ArtTable::kNone)
+		uint32_t			style;						// Index into ArtTable::styles (shared by art with the same style)
+		uint32_t			name;						// Index into ArtTable::names (or ArtTable::kNone until the name is needed)
+		short				type;
+		uint16_t			flags;						// ArtTable::Flags
+		AIReal				opacity;
+		AIRealRect			bounds;
+	};
+
+	/// Flattened art tree, captured once (while the document is scanned) and then read while rendering
+	class ArtTable
+	{
+	private:
+
+		std::unordered_map<AIArtHandle, uint32_t>	chains;		// First art of each captured sibling chain
+
+		uint32_t			AddNode(AIArtHandle artHandle);
+
+	public:
+
+		static const uint32_t kNone = 0xFFFFFFFF;
+
+		enum Flags
+		{
+			kNodeHidden = 1 << 0,						// Hidden (nothing else is captured)
+			kNodeClip = 1 << 1,							// Clipping path (or clipping plug-in art)
+			kNodeCompound = 1 << 2,						// Part of a compound path
+			kNodeGuide = 1 << 3,						// Guide path
+			kNodeMasked = 1 << 4						// Has an opacity mask
+		};
+
+		ArtTable();
+		~ArtTable();
+
+		std::vector<ArtNode>		nodes;
+		StyleCollection				styles;
+		std::vector<std::string>	names;
+
+		uint32_t			AddChain(AIArtHandle artHandle);
+		const std::string&	Name(uint32_t index);
+
+		inline const ArtNode&		Node(uint32_t index) const		{ return nodes[index]; }
+		inline const AIPathStyle&	Style(uint32_t index) const		{ return styles.Style(nodes[index].style); }
+		inline bool			HasFlag(uint32_t index, Flags flag) const	{ return ((nodes[index].flags & flag) != 0); }
+	};
+}
+
+#endif
@@ -0,0 +1,154 @@
+// BatchExport.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "BatchExport.h"
+#include "Document.h"
+#include <chrono>
+
+using namespace CanvasExport;
+
+// Remove leading and trailing whitespace
+static std::string Trim(const std::string& s)
+{
+	size_t first = s.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+	{
+		return "";
+	}
+	size_t last = s.find_last_not_of(" \t\r\n");
+	return s.substr(first, last - first + 1);
+}
+
+BatchExport::BatchExport()
+{
+}
+
+BatchExport::~BatchExport()
+{
+}
+
+// Read a list of snapshots, one per line, as "snapshot path" or "snapshot path; output path"
+// (without an output path, the snapshot's extension is replaced with .html)
+size_t BatchExport::ReadList(const std::string& listPath)
+{
+	ifstream list;
+	list.open(listPath.c_str(), ios::in);
+	if (!list.is_open())
+	{
+		return 0;
+	}
+
+	std::string line;
+	while (std::getline(list, line))
+	{
+		// Skip blank lines and comments
+		line = Trim(line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		BatchItem item;
+
+		size_t separator = line.find(';');
+		if (separator != std::string::npos)
+		{
+			item.snapshotPath = Trim(line.substr(0, separator));
+			item.outputPath = Trim(line.substr(separator + 1));
+		}
+		else
+		{
+			item.snapshotPath = line;
+		}
+
+		if (item.outputPath.empty())
+		{
+			size_t extension = item.snapshotPath.find_last_of('.');
+			size_t folder = item.snapshotPath.find_last_of("/\\");
+			if (extension != std::string::npos && (folder == std::string::npos || extension > folder))
+			{
+				item.outputPath = item.snapshotPath.substr(0, extension);
+			}
+			else
+			{
+				item.outputPath = item.snapshotPath;
+			}
+			item.outputPath += ".html";
+		}
+
+		items.push_back(item);
+	}
+
+	return items.size();
+}
+
+// Export every snapshot in the list and return a plain-text report
+std::string BatchExport::Run()
+{
+	if (items.empty())
+	{
+		return "No snapshots to export";
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	ArtSource* previousSource = artSource;
+	bool previousDebug = debug;
+	size_t exportedCount = 0;
+	std::string failures;
+
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		// Read the whole snapshot before it's replayed (rather than while)
+		bool isExported = false;
+		SnapshotArtSource source;
+		if (source.Open(items[i].snapshotPath))
+		{
+			source.Prefetch();
+
+			artSource = &source;
+			isExported = Document::Export(items[i].outputPath, false, nullptr);
+			artSource = previousSource;
+		}
+
+		if (isExported)
+		{
+			exportedCount++;
+		}
+		else
+		{
+			failures += "\n  Unable to export: " + items[i].snapshotPath;
+		}
+	}
+
+	debug = previousDebug;
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::ostringstream report;
+	report << "Exported " << exportedCount << " of " << items.size() << " snapshots in " <<
+		setiosflags(ios::fixed) << setprecision(1) << (seconds * 1000.0) << " ms" << failures;
+
+	return report.str();
+}
@@ -0,0 +1,63 @@
+// BatchExport.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef BATCHEXPORT_H
+#define BATCHEXPORT_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "SnapshotArtSource.h"
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Exports a list of snapshots (invoked via the "Batch" script command)
+	/// Rendering uses the exporter's global state (shared with its own format and write threads),
+	/// so documents are opened and rendered one at a time, in order
+	class BatchExport
+	{
+	private:
+
+		struct BatchItem
+		{
+			std::string			snapshotPath;
+			std::string			outputPath;
+		};
+
+		std::vector<BatchItem>	items;
+
+	public:
+
+		BatchExport();
+		~BatchExport();
+
+		size_t				ReadList(const std::string& listPath);
+		std::string			Run();
+	};
+}
+
+#endif
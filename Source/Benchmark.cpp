@@ -0,0 +1,1038 @@
+// Benchmark.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "Benchmark.h"
+#include "Document.h"
+#include "Canvas.h"
+#include "AnimationFunction.h"
+#include "PointTransform.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#ifdef MAC_ENV
+	#include <sys/resource.h>
+#endif
+
+#ifdef WIN_ENV
+	#include <psapi.h>
+#endif
+
+using namespace CanvasExport;
+
+// Number of path segments written per output pass
+static const size_t kOutputSegments = 200000;
+
+// Number of passes (the best time is reported)
+static const int kPasses = 3;
+
+// Synthetic document sizes
+static const size_t kDocumentPaths = 2000;
+static const size_t kPathSegments = 50;
+static const size_t kNestingDepth = 200;
+static const size_t kAnimationLayers = 10;
+static const size_t kAnimationSegments = 1000;
+static const size_t kSampleGradients = 8;
+static const size_t kSamplePatterns = 4;
+static const size_t kPatternPaths = 4;
+
+// Number of calls per kernel pass
+static const size_t kKernelCalls = 100000;
+static const size_t kArcLengthCalls = 20;
+
+// Points per transform pass (and the largest array checked against the scalar kernel)
+static const size_t kTransformPoints = 1000000;
+static const size_t kTransformCheckPoints = 67;
+
+// Record a closed triangle (offset so that each one is a distinct path)
+static void RecordTriangle(DrawCommands& commands, AIReal offset)
+{
+	commands.BeginPath(1);
+	commands.MoveTo(1, offset, offset);
+	commands.LineTo(1, offset + 10.0, offset);
+	commands.LineTo(1, offset + 10.0, offset + 10.0);
+	commands.ClosePath(1);
+}
+
+// Export options that draw paths by reference (checked by RunPaths)
+struct PathMode
+{
+	bool						path2d;
+	ExportOptions::Encoding		encoding;
+	const char*					label;
+};
+
+static const PathMode kPathModes[] =
+{
+	{ true, ExportOptions::kEncodeNone, "Path2D" },
+	{ false, ExportOptions::kEncodeQuantized, "Quantized" }
+};
+
+// Baseline coordinate formatting (iostream)
+static inline void WriteCoordinate(ofstream& stream, AIReal value)
+{
+	stream << setiosflags(ios::fixed) << setprecision(1) << value;
+}
+
+// Export coordinate formatting
+static inline void WriteCoordinate(OutputStream& stream, AIReal value)
+{
+	stream << Fixed<1>(value);
+}
+
+// Write the same mix of fragments that a typical path export produces
+// (templated so that each stream type uses its own operator overloads)
+template <class Stream>
+static void WritePoints(Stream& stream, const AIReal* values, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i > 0)
+		{
+			stream << ", ";
+		}
+		WriteCoordinate(stream, values[i]);
+	}
+}
+
+template <class Stream>
+static void WriteSampleFragments(Stream& stream, size_t segmentCount)
+{
+	AIReal x = 0.0;
+	AIReal y = 0.0;
+
+	for (size_t i = 0; i < segmentCount; i++)
+	{
+		x += 1.25;
+		y += 0.75;
+
+		if ((i % 32) == 0)
+		{
+			AIReal point[2] = { x, y };
+			stream << "\n      ctx.beginPath();";
+			stream << "\n      ctx.moveTo(";
+			WritePoints(stream, point, 2);
+			stream << ");";
+		}
+		else if ((i % 2) == 0)
+		{
+			AIReal point[2] = { x, y };
+			stream << "\n      ctx.lineTo(";
+			WritePoints(stream, point, 2);
+			stream << ");";
+		}
+		else
+		{
+			AIReal points[6] = { x, y, x + 2.5, y - 1.5, x + 4.0, y };
+			stream << "\n      ctx.bezierCurveTo(";
+			WritePoints(stream, points, 6);
+			stream << ");";
+		}
+
+		if ((i % 32) == 31)
+		{
+			stream << "\n      ctx.closePath();";
+			stream << "\n      ctx.fillStyle = \"rgb(" << (int)(i % 256) << ", 128, 64)\";";
+			stream << "\n      ctx.fill();";
+		}
+	}
+}
+
+// Record the same fragments as drawing commands
+static void RecordSampleCommands(DrawCommands& commands, size_t segmentCount)
+{
+	AIReal x = 0.0;
+	AIReal y = 0.0;
+
+	for (size_t i = 0; i < segmentCount; i++)
+	{
+		x += 1.25;
+		y += 0.75;
+
+		if ((i % 32) == 0)
+		{
+			commands.BeginPath(1);
+			commands.MoveTo(1, x, y);
+		}
+		else if ((i % 2) == 0)
+		{
+			commands.LineTo(1, x, y);
+		}
+		else
+		{
+			commands.BezierCurveTo(1, x, y, x + 2.5, y - 1.5, x + 4.0, y);
+		}
+
+		if ((i % 32) == 31)
+		{
+			std::string fillStyle = "\"rgb(";
+			AppendInteger(fillStyle, (int)(i % 256));
+			fillStyle += ", 128, 64)\"";
+
+			commands.ClosePath(1);
+			commands.FillStyle(1, fillStyle);
+			commands.Fill(1);
+		}
+	}
+}
+
+// Closed, curved path with the given number of segments (around x, y)
+static std::vector<AIPathSegment> SamplePath(AIReal x, AIReal y, AIReal radius, size_t segmentCount)
+{
+	std::vector<AIPathSegment> segments(segmentCount);
+
+	for (size_t i = 0; i < segmentCount; i++)
+	{
+		AIReal angle = (AIReal)(2.0 * 3.14159265358979 * i / segmentCount);
+		AIReal handle = radius * (AIReal)0.2;
+
+		// Alternate the radius, so neighboring segments aren't collinear
+		AIReal r = ((i % 2) == 0) ? radius : radius * (AIReal)0.8;
+
+		segments[i].p.h = x + r * (AIReal)cos(angle);
+		segments[i].p.v = y + r * (AIReal)sin(angle);
+		segments[i].in.h = segments[i].p.h + handle * (AIReal)sin(angle);
+		segments[i].in.v = segments[i].p.v - handle * (AIReal)cos(angle);
+		segments[i].out.h = segments[i].p.h - handle * (AIReal)sin(angle);
+		segments[i].out.v = segments[i].p.v + handle * (AIReal)cos(angle);
+		segments[i].corner = false;
+	}
+
+	return segments;
+}
+
+// Filled path style (every third path is also stroked)
+static AIPathStyle SampleStyle(size_t index)
+{
+	AIPathStyle style;
+	memset(&style, 0, sizeof(style));
+
+	style.fillPaint = true;
+	style.fill.color.kind = kThreeColor;
+	style.fill.color.c.rgb.red = (AIReal)(index % 7) / (AIReal)6.0;
+	style.fill.color.c.rgb.green = (AIReal)(index % 5) / (AIReal)4.0;
+	style.fill.color.c.rgb.blue = (AIReal)(index % 3) / (AIReal)2.0;
+
+	style.strokePaint = ((index % 3) == 0);
+	style.stroke.color.kind = kGrayColor;
+	style.stroke.color.c.g.gray = (AIReal)0.5;
+	style.stroke.width = 1.0;
+	style.stroke.cap = kAIButtCap;
+	style.stroke.join = kAIMiterJoin;
+	style.stroke.miterLimit = 4.0;
+
+	return style;
+}
+
+// A layer of paths (N paths by M segments)
+static size_t GeneratePaths(MemoryArtSource& source, size_t pathCount, size_t segmentCount)
+{
+	AILayerHandle layer = source.AddLayer("Paths", true);
+
+	for (size_t i = 0; i < pathCount; i++)
+	{
+		AIArtHandle path = source.AddArt(layer, kPathArt);
+		source.SetPath(path, SamplePath((AIReal)(i % 50) * 20.0, (AIReal)(i / 50) * 20.0, 8.0, segmentCount), true);
+		source.SetPathStyle(path, SampleStyle(i));
+	}
+
+	return pathCount * segmentCount;
+}
+
+// Groups nested inside each other, with a path at every level
+static size_t GenerateNestedGroups(MemoryArtSource& source, size_t depth, size_t segmentCount)
+{
+	AILayerHandle layer = source.AddLayer("Groups", true);
+	AIArtHandle group = source.AddArt(layer, kGroupArt);
+
+	for (size_t i = 0; i < depth; i++)
+	{
+		AIArtHandle path = source.AddArt(group, kPathArt);
+		source.SetPath(path, SamplePath((AIReal)(i % 20) * 25.0, (AIReal)(i / 20) * 25.0, 10.0, segmentCount), true);
+		source.SetPathStyle(path, SampleStyle(i));
+
+		group = source.AddArt(group, kGroupArt);
+	}
+
+	return depth * segmentCount;
+}
+
+// Identity matrix
+static AIRealMatrix IdentityMatrix()
+{
+	AIRealMatrix matrix;
+	matrix.a = 1.0;
+	matrix.b = 0.0;
+	matrix.c = 0.0;
+	matrix.d = 1.0;
+	matrix.tx = 0.0;
+	matrix.ty = 0.0;
+
+	return matrix;
+}
+
+// A layer of gradient-filled paths (alternating linear and radial gradients, with three stops each)
+static size_t GenerateGradients(MemoryArtSource& source, size_t pathCount, size_t segmentCount)
+{
+	std::vector<AIGradientHandle> gradients;
+	for (size_t i = 0; i < kSampleGradients; i++)
+	{
+		std::vector<AIGradientStop> stops(3);
+		for (size_t j = 0; j < stops.size(); j++)
+		{
+			memset(&stops[j], 0, sizeof(stops[j]));
+			stops[j].rampPoint = (AIReal)(j * 50);
+			stops[j].midPoint = 50.0;
+			stops[j].opacity = 1.0;
+			stops[j].color.kind = kThreeColor;
+			stops[j].color.c.rgb.red = (AIReal)((i + j) % 3) / (AIReal)2.0;
+			stops[j].color.c.rgb.green = (AIReal)(j % 2);
+			stops[j].color.c.rgb.blue = (AIReal)(i % 5) / (AIReal)4.0;
+		}
+		gradients.push_back(source.AddGradient(((i % 2) == 0) ? kLinearGradient : kRadialGradient, stops));
+	}
+
+	AILayerHandle layer = source.AddLayer("Gradients", true);
+
+	for (size_t i = 0; i < pathCount; i++)
+	{
+		AIReal x = (AIReal)(i % 50) * 20.0;
+		AIReal y = (AIReal)(i / 50) * 20.0;
+
+		AIArtHandle path = source.AddArt(layer, kPathArt);
+		source.SetPath(path, SamplePath(x, y, 8.0, segmentCount), true);
+
+		AIPathStyle style = SampleStyle(i);
+		style.fill.color.kind = kGradient;
+		style.fill.color.c.b.gradient = gradients[i % gradients.size()];
+		style.fill.color.c.b.gradientOrigin.h = x - 8.0;
+		style.fill.color.c.b.gradientOrigin.v = y;
+		style.fill.color.c.b.gradientAngle = (AIReal)(i % 360);
+		style.fill.color.c.b.gradientLength = 16.0;
+		style.fill.color.c.b.matrix = IdentityMatrix();
+		style.fill.color.c.b.hiliteAngle = 0.0;
+		style.fill.color.c.b.hiliteLength = 0.0;
+		source.SetPathStyle(path, style);
+	}
+
+	return pathCount * segmentCount;
+}
+
+// A layer of pattern-filled paths (each pattern is a small grid of paths)
+static size_t GeneratePatterns(MemoryArtSource& source, size_t pathCount, size_t segmentCount)
+{
+	std::vector<AIPatternHandle> patterns;
+	size_t patternSegments = 0;
+	for (size_t i = 0; i < kSamplePatterns; i++)
+	{
+		AIPatternHandle pattern = source.AddPattern("Pattern " + std::to_string(i + 1));
+
+		AIArtHandle patternArt = nullptr;
+		source.GetPatternArt(pattern, &patternArt);
+		for (size_t j = 0; j < kPatternPaths; j++)
+		{
+			AIArtHandle path = source.AddArt(patternArt, kPathArt);
+			source.SetPath(path, SamplePath((AIReal)(j % 2) * 10.0, (AIReal)(j / 2) * 10.0, 4.0, segmentCount), true);
+			source.SetPathStyle(path, SampleStyle(i + j));
+			patternSegments += segmentCount;
+		}
+		patterns.push_back(pattern);
+	}
+
+	AILayerHandle layer = source.AddLayer("Patterns", true);
+
+	for (size_t i = 0; i < pathCount; i++)
+	{
+		AIArtHandle path = source.AddArt(layer, kPathArt);
+		source.SetPath(path, SamplePath((AIReal)(i % 50) * 20.0, (AIReal)(i / 50) * 20.0, 8.0, segmentCount), true);
+
+		AIPathStyle style = SampleStyle(i);
+		style.fill.color.kind = kPattern;
+		memset(&style.fill.color.c.p, 0, sizeof(style.fill.color.c.p));
+		style.fill.color.c.p.pattern = patterns[i % patterns.size()];
+		style.fill.color.c.p.scale.h = 1.0;
+		style.fill.color.c.p.scale.v = 1.0;
+		style.fill.color.c.p.transform = IdentityMatrix();
+		source.SetPathStyle(path, style);
+	}
+
+	return patternSegments + pathCount * segmentCount;
+}
+
+// Animation layers, each with one long motion path
+static size_t GenerateAnimation(MemoryArtSource& source, size_t layerCount, size_t segmentCount)
+{
+	for (size_t i = 0; i < layerCount; i++)
+	{
+		std::string title = "motion" + std::to_string(i) + "(type: animation);";
+		AILayerHandle layer = source.AddLayer(title, true);
+
+		AIArtHandle path = source.AddArt(layer, kPathArt);
+		source.SetPath(path, SamplePath(200.0, 200.0, 150.0 + (AIReal)(i * 5), segmentCount), false);
+		source.SetPathStyle(path, SampleStyle(i));
+	}
+
+	return layerCount * segmentCount;
+}
+
+// Peak memory use of the whole process (in bytes)
+static size_t PeakMemory()
+{
+	#ifdef MAC_ENV
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+		{
+			return (size_t)usage.ru_maxrss;
+		}
+	#endif
+	#ifdef WIN_ENV
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		{
+			return (size_t)counters.PeakWorkingSetSize;
+		}
+	#endif
+
+	return 0;
+}
+
+Benchmark::Benchmark(const std::string& folderPath)
+{
+	// Initialize Benchmark
+	this->folderPath = folderPath;
+}
+
+Benchmark::~Benchmark()
+{
+}
+
+std::string Benchmark::TempFilePath(const std::string& name)
+{
+	std::string path = folderPath;
+
+	// Ensure there's a trailing separator
+	if (!path.empty() && path[path.length() - 1] != '/' && path[path.length() - 1] != '\\')
+	{
+		#ifdef MAC_ENV
+			path += "/";
+		#endif
+		#ifdef WIN_ENV
+			path += "\\";
+		#endif
+	}
+
+	return path + name;
+}
+
+std::string Benchmark::FormatRate(const std::string& label, size_t bytes, double seconds)
+{
+	std::ostringstream report;
+
+	double megabytes = (double)bytes / (1024.0 * 1024.0);
+	double rate = (seconds > 0.0) ? (megabytes / seconds) : 0.0;
+
+	report << label << ": " << bytes << " bytes in " <<
+		setiosflags(ios::fixed) << setprecision(1) << (seconds * 1000.0) << " ms (" <<
+		setprecision(1) << rate << " MB/s)\n";
+
+	return report.str();
+}
+
+// Run all benchmarks and return a plain-text report
+std::string Benchmark::Run()
+{
+	std::string report;
+
+	report += RunOutput();
+	report += RunCommands();
+	report += RunDocuments();
+	report += RunKernels();
+	report += RunTransform();
+	report += RunPaths();
+
+	return report;
+}
+
+// Compare output throughput of a plain std::ofstream (with iostream number formatting) against the export's OutputStream
+std::string Benchmark::RunOutput()
+{
+	std::string report = "Output (" + std::to_string(kOutputSegments) + " segments, best of " + std::to_string(kPasses) + ")\n";
+
+	std::string filePath = TempFilePath("Ai2CanvasBenchmark.tmp");
+
+	double streamSeconds = 0.0;
+	double outputSeconds = 0.0;
+	size_t streamBytes = 0;
+	size_t outputBytes = 0;
+
+	for (int pass = 0; pass < kPasses; pass++)
+	{
+		// Baseline: std::ofstream (how exports used to be written)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			ofstream stream;
+			stream.open(filePath.c_str(), ios::out);
+			if (!stream.is_open())
+			{
+				return report + "Unable to create: " + filePath + "\n";
+			}
+			WriteSampleFragments(stream, kOutputSegments);
+			streamBytes = (size_t)stream.tellp();
+			stream.close();
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < streamSeconds)
+			{
+				streamSeconds = seconds;
+			}
+		}
+
+		// Chunked output stream (includes the final bulk write)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			OutputStream stream;
+			if (!stream.Open(filePath))
+			{
+				return report + "Unable to create: " + filePath + "\n";
+			}
+			WriteSampleFragments(stream, kOutputSegments);
+			outputBytes = stream.Size();
+			stream.Close();
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < outputSeconds)
+			{
+				outputSeconds = seconds;
+			}
+		}
+	}
+
+	// Clean up
+	remove(filePath.c_str());
+
+	report += FormatRate("  std::ofstream", streamBytes, streamSeconds);
+	report += FormatRate("  OutputStream ", outputBytes, outputSeconds);
+
+	if (outputSeconds > 0.0)
+	{
+		std::ostringstream speedup;
+		speedup << "  Speedup: " << setiosflags(ios::fixed) << setprecision(2) << (streamSeconds / outputSeconds) << "x\n";
+		report += speedup.str();
+	}
+
+	return report;
+}
+
+// Compare formatting JavaScript inline (how Canvas used to work) against recording drawing commands and rendering them later
+// (output is kept in memory, so only formatting and recording are measured)
+std::string Benchmark::RunCommands()
+{
+	std::string report = "Commands (" + std::to_string(kOutputSegments) + " segments, best of " + std::to_string(kPasses) + ")\n";
+
+	double inlineSeconds = 0.0;
+	double recordSeconds = 0.0;
+	double renderSeconds = 0.0;
+	size_t inlineBytes = 0;
+	size_t renderBytes = 0;
+
+	DrawCommands commands;
+
+	for (int pass = 0; pass < kPasses; pass++)
+	{
+		// Inline formatting
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			OutputStream stream;
+			WriteSampleFragments(stream, kOutputSegments);
+			inlineBytes = stream.Size();
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < inlineSeconds)
+			{
+				inlineSeconds = seconds;
+			}
+		}
+
+		// Record
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			commands.Clear();
+			RecordSampleCommands(commands, kOutputSegments);
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < recordSeconds)
+			{
+				recordSeconds = seconds;
+			}
+		}
+
+		// Render (into the export stream, which isn't attached to a file)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			commands.Render(outFile, "ctx", nullptr);
+			renderBytes = outFile.Size();
+			outFile.Close();
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < renderSeconds)
+			{
+				renderSeconds = seconds;
+			}
+		}
+	}
+
+	report += FormatRate("  Inline ", inlineBytes, inlineSeconds);
+	report += FormatRate("  Record ", renderBytes, recordSeconds);
+	report += FormatRate("  Render ", renderBytes, renderSeconds);
+
+	if (inlineBytes != renderBytes)
+	{
+		report += "  Rendered output size doesn't match inline output\n";
+	}
+
+	return report;
+}
+
+// Render synthetic documents end to end (Document::Render, with art read from memory)
+std::string Benchmark::RunDocuments()
+{
+	std::string report = "Documents (best of " + std::to_string(kPasses) + ")\n";
+
+	MemoryArtSource source;
+
+	size_t segmentCount = GeneratePaths(source, kDocumentPaths, kPathSegments);
+	report += RunDocument("  Paths    ", source, segmentCount);
+
+	source.Clear();
+	segmentCount = GenerateNestedGroups(source, kNestingDepth, kPathSegments);
+	report += RunDocument("  Groups   ", source, segmentCount);
+
+	source.Clear();
+	segmentCount = GenerateAnimation(source, kAnimationLayers, kAnimationSegments);
+	report += RunDocument("  Animation", source, segmentCount);
+
+	source.Clear();
+	segmentCount = GenerateGradients(source, kDocumentPaths, kPathSegments);
+	report += RunDocument("  Gradients", source, segmentCount);
+
+	source.Clear();
+	segmentCount = GeneratePatterns(source, kDocumentPaths, kPathSegments);
+	report += RunDocument("  Patterns ", source, segmentCount);
+
+	std::ostringstream memory;
+	memory << "  Peak memory: " << setiosflags(ios::fixed) << setprecision(1) << ((double)PeakMemory() / (1024.0 * 1024.0)) << " MB\n";
+	report += memory.str();
+
+	return report;
+}
+
+std::string Benchmark::RunDocument(const std::string& label, MemoryArtSource& source, size_t segmentCount)
+{
+	std::string filePath = TempFilePath("Ai2CanvasBenchmark.html");
+
+	// Read art from the synthetic document
+	ArtSource* previousSource = artSource;
+	bool previousDebug = debug;
+	artSource = &source;
+	debug = false;
+
+	double bestSeconds = 0.0;
+	size_t bytes = 0;
+
+	for (int pass = 0; pass < kPasses; pass++)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		// Exported as the plug-in exports (including any gzip, trace and profile setup)
+		if (!Document::Export(filePath, false, nullptr))
+		{
+			artSource = previousSource;
+			debug = previousDebug;
+			return label + ": Unable to create: " + filePath + "\n";
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (pass == 0 || seconds < bestSeconds)
+		{
+			bestSeconds = seconds;
+		}
+	}
+
+	artSource = previousSource;
+	debug = previousDebug;
+
+	// Size of the exported file
+	ifstream file;
+	file.open(filePath.c_str(), ios::in | ios::binary | ios::ate);
+	if (file.is_open())
+	{
+		bytes = (size_t)file.tellg();
+		file.close();
+	}
+
+	// Clean up
+	remove(filePath.c_str());
+	remove((filePath + ".gz").c_str());
+
+	double nanoseconds = (segmentCount > 0) ? (bestSeconds * 1e9 / (double)segmentCount) : 0.0;
+	double rate = (bestSeconds > 0.0) ? ((double)bytes / (1024.0 * 1024.0) / bestSeconds) : 0.0;
+
+	std::ostringstream report;
+	report << label << ": " << segmentCount << " segments, " << bytes << " bytes in " <<
+		setiosflags(ios::fixed) << setprecision(1) << (bestSeconds * 1000.0) << " ms (" <<
+		nanoseconds << " ns/segment, " << rate << " MB/s)\n";
+
+	return report.str();
+}
+
+// Time the hot helper functions in isolation
+std::string Benchmark::RunKernels()
+{
+	std::string report = "Kernels (best of " + std::to_string(kPasses) + ")\n";
+
+	const char* names[4] = { "Layer 12 (copy)", "background-shape_2", "Ellipse Tool Result", "animation path 7" };
+	const std::string options = "type: animation; animate: motion1; duration: 2.5; direction: forward; ease: in-out";
+
+	DocumentResources resources;
+	Canvas canvas("benchmark", &resources);
+
+	AIColor colors[4];
+	memset(colors, 0, sizeof(colors));
+	for (int i = 0; i < 4; i++)
+	{
+		colors[i].kind = kFourColor;
+		colors[i].c.f.cyan = (AIReal)(i * 0.25);
+		colors[i].c.f.magenta = (AIReal)0.5;
+		colors[i].c.f.yellow = (AIReal)(1.0 - i * 0.25);
+		colors[i].c.f.black = (AIReal)0.1;
+	}
+
+	// Motion path for arc-length sampling
+	AnimationFunction animation;
+	std::vector<AIPathSegment> segments = SamplePath(200.0, 200.0, 150.0, kAnimationSegments);
+	for (size_t i = 1; i < segments.size(); i++)
+	{
+		BezierInfo bezier;
+		RealBezierSet(&bezier.b, &segments[i - 1].p, &segments[i - 1].out, &segments[i].in, &segments[i].p);
+		bezier.length = RealBezierLength(&bezier.b, 1e-2f);
+		animation.beziers.push_back(bezier);
+	}
+
+	double seconds[4] = { 0.0, 0.0, 0.0, 0.0 };
+	size_t checksum = 0;
+
+	for (int pass = 0; pass < kPasses; pass++)
+	{
+		double passSeconds[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+		// CleanString
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < kKernelCalls; i++)
+			{
+				std::string name = names[i % 4];
+				CleanString(name, true);
+				checksum += name.length();
+			}
+			passSeconds[0] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Tokenize
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < kKernelCalls; i++)
+			{
+				checksum += Tokenize(options, ";").size();
+			}
+			passSeconds[1] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Canvas::GetColor
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < kKernelCalls; i++)
+			{
+				checksum += canvas.GetColor(colors[i % 4], ((i % 2) == 0) ? 1.0 : 0.5).length();
+			}
+			passSeconds[2] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// AnimationFunction::ArcLength (into the export stream, which isn't attached to a file)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < kArcLengthCalls; i++)
+			{
+				animation.ArcLength(1);
+				checksum += outFile.Size();
+				outFile.Close();
+			}
+			passSeconds[3] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		for (int i = 0; i < 4; i++)
+		{
+			if (pass == 0 || passSeconds[i] < seconds[i])
+			{
+				seconds[i] = passSeconds[i];
+			}
+		}
+	}
+
+	const char* labels[4] = { "  CleanString", "  Tokenize   ", "  GetColor   ", "  ArcLength  " };
+	const size_t calls[4] = { kKernelCalls, kKernelCalls, kKernelCalls, kArcLengthCalls };
+
+	std::ostringstream kernels;
+	kernels << setiosflags(ios::fixed) << setprecision(1);
+	for (int i = 0; i < 4; i++)
+	{
+		kernels << labels[i] << ": " << (seconds[i] * 1e9 / (double)calls[i]) << " ns/call (" << calls[i] << " calls)\n";
+	}
+
+	// (the checksum keeps the calls from being optimized away)
+	if (checksum == 0)
+	{
+		kernels << "  No output\n";
+	}
+
+	report += kernels.str();
+
+	return report;
+}
+
+// Time the vectorized point transform against the scalar loop, and check that every result is bit-identical
+std::string Benchmark::RunTransform()
+{
+	std::string report = "Transform (" + std::string(TransformPointsName()) + ", " + std::to_string(kTransformPoints) + " points, best of " + std::to_string(kPasses) + ")\n";
+
+	// Rotated, scaled, skewed and translated (so no coefficient is trivial)
+	AIRealMatrix matrix;
+	matrix.a = (AIReal)0.8660254;
+	matrix.b = (AIReal)0.5;
+	matrix.c = (AIReal)-0.4330127;
+	matrix.d = (AIReal)1.2990381;
+	matrix.tx = (AIReal)123.456;
+	matrix.ty = (AIReal)-789.012;
+
+	// Source points (a spread of magnitudes and signs)
+	std::vector<AIReal> sourceX(kTransformPoints);
+	std::vector<AIReal> sourceY(kTransformPoints);
+	for (size_t i = 0; i < kTransformPoints; i++)
+	{
+		sourceX[i] = (AIReal)(((double)(i % 1000) - 500.0) * 1.37 + (double)(i % 7) * 0.001);
+		sourceY[i] = (AIReal)(((double)(i % 613) - 300.0) * 2.91 - (double)(i % 11) * 0.003);
+	}
+
+	// Check every array length up to a few vectors long (covers each remainder)
+	size_t mismatches = 0;
+	for (size_t count = 0; count <= kTransformCheckPoints; count++)
+	{
+		std::vector<AIReal> scalarX(sourceX.begin(), sourceX.begin() + count);
+		std::vector<AIReal> scalarY(sourceY.begin(), sourceY.begin() + count);
+		std::vector<AIReal> vectorX(scalarX);
+		std::vector<AIReal> vectorY(scalarY);
+
+		TransformPointsScalar(matrix, scalarX.data(), scalarY.data(), count);
+		TransformPoints(matrix, vectorX.data(), vectorY.data(), count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (memcmp(&scalarX[i], &vectorX[i], sizeof(AIReal)) != 0 ||
+				memcmp(&scalarY[i], &vectorY[i], sizeof(AIReal)) != 0)
+			{
+				mismatches++;
+			}
+		}
+	}
+
+	double scalarSeconds = 0.0;
+	double vectorSeconds = 0.0;
+	std::vector<AIReal> x(kTransformPoints);
+	std::vector<AIReal> y(kTransformPoints);
+	AIReal checksum = 0.0;
+
+	for (int pass = 0; pass < kPasses; pass++)
+	{
+		// Scalar
+		{
+			x = sourceX;
+			y = sourceY;
+
+			auto start = std::chrono::steady_clock::now();
+			TransformPointsScalar(matrix, x.data(), y.data(), kTransformPoints);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < scalarSeconds)
+			{
+				scalarSeconds = seconds;
+			}
+			checksum += x[kTransformPoints - 1];
+		}
+
+		// Vectorized
+		{
+			x = sourceX;
+			y = sourceY;
+
+			auto start = std::chrono::steady_clock::now();
+			TransformPoints(matrix, x.data(), y.data(), kTransformPoints);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < vectorSeconds)
+			{
+				vectorSeconds = seconds;
+			}
+			checksum += y[kTransformPoints - 1];
+		}
+	}
+
+	std::ostringstream transform;
+	transform << setiosflags(ios::fixed) << setprecision(2);
+	transform << "  Scalar     : " << (scalarSeconds * 1e9 / (double)kTransformPoints) << " ns/point\n";
+	transform << "  Vectorized : " << (vectorSeconds * 1e9 / (double)kTransformPoints) << " ns/point\n";
+	if (vectorSeconds > 0.0)
+	{
+		transform << "  Speedup: " << (scalarSeconds / vectorSeconds) << "x\n";
+	}
+
+	if (mismatches > 0)
+	{
+		transform << "  " << mismatches << " vectorized results don't match the scalar kernel\n";
+	}
+	else
+	{
+		transform << "  Vectorized results match the scalar kernel (lengths 0 to " << kTransformCheckPoints << ")\n";
+	}
+
+	// (the checksum keeps the transforms from being optimized away)
+	if (checksum != checksum)
+	{
+		transform << "  No output\n";
+	}
+
+	report += transform.str();
+
+	return report;
+}
+
+// Check which paths are built once and drawn by reference (in each of kPathModes)
+std::string Benchmark::RunPaths()
+{
+	std::string report = "Paths\n";
+
+	// A plain fill can be drawn by reference
+	DrawCommands plain;
+	RecordTriangle(plain, 0.0);
+	plain.FillStyle(1, "\"rgb(0, 0, 0)\"");
+	plain.Fill(1);
+
+	// Pattern fills are drawn after the pattern transform, so the path has to be built with the context
+	AIRealMatrix matrix;
+	matrix.a = (AIReal)2.0;
+	matrix.b = (AIReal)0.0;
+	matrix.c = (AIReal)0.0;
+	matrix.d = (AIReal)2.0;
+	matrix.tx = (AIReal)5.0;
+	matrix.ty = (AIReal)5.0;
+
+	DrawCommands pattern;
+	pattern.Save(1);
+	RecordTriangle(pattern, 20.0);
+	pattern.Transform(1, matrix);
+	pattern.FillStyle(1, "ctx.createPattern(pattern, \"repeat\")");
+	pattern.Fill(1);
+	pattern.Restore(1);
+
+	// Points past 32-bit grid steps can't be quantized, so the path has to be built with the context
+	DrawCommands distant;
+	RecordTriangle(distant, 1.0e7);
+	distant.FillStyle(1, "\"rgb(0, 0, 0)\"");
+	distant.Fill(1);
+
+	// Optimized first (as they are when exported)
+	plain.Optimize();
+	pattern.Optimize();
+	distant.Optimize();
+
+	// (the export options are restored afterwards)
+	bool previousPath2D = exportOptions.path2d;
+	ExportOptions::Encoding previousEncoding = exportOptions.encoding;
+	AIReal previousGrid = exportOptions.grid;
+	bool previousDebug = debug;
+	debug = false;
+
+	size_t failures = 0;
+	for (size_t i = 0; i < sizeof(kPathModes) / sizeof(kPathModes[0]); i++)
+	{
+		exportOptions.path2d = kPathModes[i].path2d;
+		exportOptions.encoding = kPathModes[i].encoding;
+		const char* label = kPathModes[i].label;
+
+		OutputStream stream;
+
+		PathCollection plainPaths;
+		plain.Render(stream, "ctx", &plainPaths);
+		if (!plainPaths.HasPaths())
+		{
+			report += std::string("  ") + label + ": fill isn't drawn by reference\n";
+			failures++;
+		}
+
+		PathCollection patternPaths;
+		pattern.Render(stream, "ctx", &patternPaths);
+		if (patternPaths.HasPaths())
+		{
+			report += std::string("  ") + label + ": pattern fill is drawn by reference (after the pattern transform)\n";
+			failures++;
+		}
+	}
+
+	// Finest grid
+	exportOptions.path2d = false;
+	exportOptions.encoding = ExportOptions::kEncodeQuantized;
+	exportOptions.SetParameter("grid", "0.000001");
+	{
+		OutputStream stream;
+		PathCollection distantPaths;
+		distant.Render(stream, "ctx", &distantPaths);
+		if (distantPaths.HasPaths())
+		{
+			report += "  Quantized: fill past 32-bit grid steps is drawn by reference\n";
+			failures++;
+		}
+	}
+
+	exportOptions.path2d = previousPath2D;
+	exportOptions.encoding = previousEncoding;
+	exportOptions.grid = previousGrid;
+	debug = previousDebug;
+
+	if (failures == 0)
+	{
+		report += "  Fills are drawn by reference, pattern fills and fills past the quantization range are built with the context\n";
+	}
+
+	return report;
+}
@@ -0,0 +1,63 @@
+// Benchmark.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "DrawCommands.h"
+#include "MemoryArtSource.h"
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Runs the built-in performance benchmarks (invoked via the "Benchmark" script command)
+	class Benchmark
+	{
+	private:
+
+		std::string			folderPath;					// Folder for temporary output files
+
+		std::string			TempFilePath(const std::string& name);
+		std::string			FormatRate(const std::string& label, size_t bytes, double seconds);
+		std::string			RunDocument(const std::string& label, MemoryArtSource& source, size_t segmentCount);
+
+	public:
+
+		Benchmark(const std::string& folderPath);
+		~Benchmark();
+
+		std::string			Run();
+		std::string			RunOutput();
+		std::string			RunCommands();
+		std::string			RunDocuments();
+		std::string			RunKernels();
+		std::string			RunTransform();
+		std::string			RunPaths();
+	};
+}
+
+#endif
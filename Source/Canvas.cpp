@@ -27,23 +27,6 @@
 
 using namespace CanvasExport;
 
-AIBoolean ProgressProc(ai::int32 current, ai::int32 total);
-
-// Outside of namespace
-// TODO: Fix this
-AIBoolean ProgressProc(ai::int32 current, ai::int32 total)
-{
-	(void)current;
-	(void)total;
-	return true;
-}
-
-// Simple way to describe art types for debugging purposes
-static const char *m_artTypes[] = 
-{
-	"kUnknownArt", "kGroupArt", "kPathArt", "kCompoundPathArt", "kTextArtUnsupported", "kTextPathArtUnsupported", "kTextRunArtUnsupported", "kPlacedArt", "kMysteryPathArt", "kRasterArt", "kPluginArt", "kMeshArt", "kTextFrameArt", "kSymbolArt", "kForeignArt", "kLegacyTextArt"
-};
-
 Canvas::Canvas(const std::string& id, DocumentResources* documentResources)
 {
 	// Initialize Canvas
@@ -99,8 +82,8 @@ void Canvas::DebugInfo()
 {
 	outFile << "\n\n// Canvas Info";
 	outFile << "\n//   id = " << this->id;
-	outFile << "\n//   width = " << setiosflags(ios::fixed) << setprecision(2) << this->width;
-	outFile << "\n//   height = " << setiosflags(ios::fixed) << setprecision(2) << this->height;
+	outFile << "\n//   width = " << Fixed<2>(this->width);
+	outFile << "\n//   height = " << Fixed<2>(this->height);
 	outFile << "\n//   isHidden = " << this->isHidden;
 	outFile << "\n//   contextName = " << this->contextName;
 	outFile << "\n//   states = " << this->states.size();
@@ -136,9 +119,44 @@ void Canvas::RenderImages()
 	documentResources->images.Render();
 }
 
+// Write (and then clear) the drawing commands recorded by RenderArt
+void Canvas::RenderCommands()
+{
+	// Remove redundant commands first
+	if (exportOptions.IsOptimized())
+	{
+		documentResources->removedStatements += commands.Optimize();
+	}
+
+	RenderCommands(commands, outFile);
+	commands.Clear();
+}
+
+// Write a set of recorded drawing commands to a stream (without optimizing them)
+void Canvas::RenderCommands(DrawCommands& recorded, OutputStream& stream)
+{
+	if (exportOptions.GetEncoding() == ExportOptions::kEncodeTyped)
+	{
+		// Path geometry is replayed from binary data
+		recorded.RenderEncoded(stream, contextName, documentResources->geometry);
+	}
+	else
+	{
+		// Paths can be built once and drawn by reference (and may be quantized)
+		recorded.Render(stream, contextName, exportOptions.IsPath2D() ? &documentResources->paths : nullptr);
+	}
+}
+
 // Render an Illustrator art object
 // (including siblings and children)
 void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
+{
+	// Art captured while scanning is found in the art table (anything else is captured now)
+	RenderArtNodes(documentResources->artTable.AddChain(artHandle), depth);
+}
+
+// Render a chain of sibling art from the art table
+void Canvas::RenderArtNodes(uint32_t index, unsigned int depth)
 {
 	// Simple way to describe blending modes for debugging purposes
 	// See: http://help.adobe.com/en_US/Illustrator/14.0/WS714a382cdf7d304e7e07d0100196cbc5f-64e0a.html
@@ -148,107 +166,64 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 		"Exclusion", "Hue", "Saturation", "Color", "Luminosity", "Num"
 	};
 
+	ArtTable& artTable = documentResources->artTable;
+
 	// Start by gathering art and its siblings
-	std::vector<AIArtHandle> artHandles;
+	std::vector<uint32_t> artNodes;
 	bool hasClipIndex = false;
 	size_t clipIndex = 0;
 
-	do
+	for (; index != ArtTable::kNone; index = artTable.Node(index).sibling)
 	{
-		// Get type (needed for kPluginArt/Pathfinder clip test)
-		short type = 0;
-		sAIArt->GetArtType(artHandle, &type);
-
-		// Get the path style
-		AIPathStyle style;
-		AIBoolean outHasAdvFill = false;
-		sAIPathStyle->GetPathStyle(artHandle, &style, &outHasAdvFill);
-
-		// Is this kPluginArt?
-		if (type == kPluginArt)
-		{
-			// Determine if this plug-in art is clipping
-			AIBoolean clipping = false;
-			sAIPluginGroup->GetPluginArtClipping(artHandle, &clipping);
-
-			// Is it clipping?
-			if (clipping)
-			{
-				// Remember where the clipping path is
-				clipIndex = artHandles.size();
-				hasClipIndex = true;
-			}
-		}
-		else
+		// Is this a clipping path (or clipping kPluginArt/Pathfinder)?
+		if (artTable.HasFlag(index, ArtTable::kNodeClip))
 		{
-			// Not kPluginArt, so check style attribute
-			if (style.clip)
-			{
-				// Remember where the clipping path is
-				clipIndex = artHandles.size();
-				hasClipIndex = true;
-			}
+			// Remember where the clipping path is
+			clipIndex = artNodes.size();
+			hasClipIndex = true;
 		}
 
-		// Add this art handle
-		artHandles.push_back(artHandle);
-
-		// Find the next sibling
-		sAIArt->GetArtSibling(artHandle, &artHandle);
+		// Add this art
+		artNodes.push_back(index);
 	}
-	while (artHandle != nullptr);
 
 	// Did we find a clipping path?
 	if (hasClipIndex)
 	{
-		// Remember the clip art handle
-		AIArtHandle clipArtHandle = artHandles[clipIndex];
+		// Remember the clip art
+		uint32_t clipNode = artNodes[clipIndex];
 
 		// Shift everything from the clip "up" by 1
-		for (size_t i = clipIndex; i < (artHandles.size() - 1); i++)
+		for (size_t i = clipIndex; i < (artNodes.size() - 1); i++)
 		{
-			artHandles[i] = artHandles[i + 1];
+			artNodes[i] = artNodes[i + 1];
 		}
 
-		// Move the clip art handle to the end
-		artHandles[(artHandles.size() - 1)] = clipArtHandle;
+		// Move the clip art to the end
+		artNodes[(artNodes.size() - 1)] = clipNode;
 	}
 
 	// Loop through all art in this layer
 	// Do it backwards, because of canvas "painter model"
-	for (size_t i = artHandles.size(); i > 0; i--)
+	for (size_t i = artNodes.size(); i > 0; i--)
 	{
-		artHandle = artHandles[(i - 1)];
-
-		// Is this art visible?
-		AIBoolean isArtVisible = false;
-		ai::int32 attr = 0;
-		sAIArt->GetArtUserAttr(artHandle, kArtHidden, &attr);
-		isArtVisible = !((attr &kArtHidden) == kArtHidden);
+		index = artNodes[(i - 1)];
+		AIArtHandle artHandle = artTable.Node(index).handle;
 
 		// Only render if art is visible
-		if (isArtVisible)
+		if (!artTable.HasFlag(index, ArtTable::kNodeHidden))
 		{
-			// Get art name
-			ai::UnicodeString artName;
-			AIBoolean isDefaultName = false;
-			sAIArt->GetArtName(artHandle, artName, &isDefaultName);
-
 			// Add name to breadcrumbs
-			AddBreadcrumb(artName.as_UTF8(), depth);
+			AddBreadcrumb(index, depth);
 
 			// Do we need to rasterize this art?
 			AIBoolean rasterizeArt = false;
 
 			// Does this art have an associated opacity mask?
-			AIMaskRef mask;
-			sAIMask->GetMask(artHandle, &mask);
-
-			// Did we find a mask?
-			if (mask != nullptr)
+			if (artTable.HasFlag(index, ArtTable::kNodeMasked))
 			{
 				// Output a warning
-				outFile << "\n" << Indent(depth) << "// This artwork uses an unsupported opacity mask";
+				commands.Text() << "\n" << Indent(depth) << "// This artwork uses an unsupported opacity mask";
 
 				// Rasterize the art
 				rasterizeArt = true;
@@ -284,7 +259,7 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 			if (blendingMode != kAINormalBlendingMode)
 			{
 				// Output a warning
-				outFile << "\n" << Indent(depth) << "// This artwork uses an unsupported \"" << std::string(blendingModes[blendingMode]) << "\" blending mode";
+				commands.Text() << "\n" << Indent(depth) << "// This artwork uses an unsupported \"" << std::string(blendingModes[blendingMode]) << "\" blending mode";
 			}
 
 			// Do we need to increase depth because of a drop shadow?
@@ -304,15 +279,17 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 				RenderDropShadow(dropShadow, depth);
 			}
 
-			// Get opacity
-			AIReal opacity = sAIBlendStyle->GetOpacity(artHandle);
+			// Get opacity and type
+			AIReal opacity = artTable.Node(index).opacity;
+			short type = artTable.Node(index).type;
+			documentResources->statistics.BeginArt(type, commands.commands.size());
 
 			// Are we rasterizing this art?
 			if (rasterizeArt)
 			{
 				// Rasterize the art
 				std::string fileName = GetUniqueFileName(documentResources->folderPath, "image", ".png");
-				outFile << "\n" << Indent(depth) << "// This unsupported artwork has been rasterized";
+				commands.Text() << "\n" << Indent(depth) << "// This unsupported artwork has been rasterized";
 				RenderUnsupportedArt(artHandle, fileName, depth);
 			}
 			else
@@ -324,16 +301,12 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 					currentState->globalAlpha = opacity;
 
 					// Change global alpha (based on the "base" alpha value)
-					outFile << "\n" << Indent(depth) << contextName << ".globalAlpha = alpha * " <<
-						setiosflags(ios::fixed) << setprecision(2) << currentState->globalAlpha << ";";
+					commands.GlobalAlpha(depth, currentState->globalAlpha);
 				}
 
-				// Get type
-				short type = 0;
-				sAIArt->GetArtType(artHandle, &type);
 				if (debug)
 				{
-					outFile << "\n" << Indent(depth) << "// Art type = " << std::string(m_artTypes[type]) << " (" << type << ")";
+					commands.Text() << "\n" << Indent(depth) << "// Art type = " << ArtTypeName(type) << " (" << type << ")";
 				}
 
 				// Process based on art type
@@ -342,12 +315,12 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 					case kGroupArt:
 					{
 						// Render this sub-group
-						RenderGroupArt(artHandle, depth);
+						RenderGroupArt(index, depth);
 						break;
 					}
 					case kPluginArt:
 					{
-						RenderPluginArt(artHandle, depth);
+						RenderPluginArt(index, depth);
 						break;
 					}
 					case kSymbolArt:
@@ -357,12 +330,12 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 					}
 					case kCompoundPathArt:
 					{
-						RenderCompoundPathArt(artHandle, depth);
+						RenderCompoundPathArt(index, depth);
 						break;
 					}
 					case kPathArt:
 					{
-						RenderPathArt(artHandle, depth);
+						RenderPathArt(index, depth);
 						break;
 					}
 					case kTextFrameArt:
@@ -389,6 +362,7 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 					}
 				}
 			}
+			documentResources->statistics.EndArt(commands.commands.size());
 
 			// Were we rendering a drop shadow?
 			if (hasDropShadow)
@@ -407,154 +381,44 @@ void Canvas::RenderArt(AIArtHandle artHandle, unsigned int depth)
 // Returns the number of effects, the blending mode, and drop shadow information
 void Canvas::ParseArtStyle(AIArtHandle artHandle, unsigned int depth, ASInt32& postEffectCount, AIBlendingMode& blendingMode, AIBoolean& hasDropShadow, DropShadow& dropShadow)
 {
-	// Simple way to describe art types for debugging purposes
-//	static const char *dictTypes[] = 
-//	{
-//		"UnknownType", "IntegerType", "BooleanType", "RealType", "StringType", "DictType", "ArrayType", "BinaryType", "PointType",
-//		"MatrixType", "PatternRefType", "BrushPatternRefType", "CustomColorRefType", "GradientRefType", "PluginObjectRefType",
-//		"FillStyleType", "StrokeStyleType", "UIDType", "UIDREFType", "XMLNodeType", "SVGFilterType", "ArtStyleType", "SymbolPatternRefType",
-//		"GraphDesignRefType", "BlendStyleType", "GraphicObjectType"
-//	};
-
 	// Does this artwork have a drop shadow?
 	hasDropShadow = false;
 
-	// Get the style for this art handle
-	AIArtStyleHandle artStyle = nullptr;
-    sAIArtStyle->GetArtStyle(artHandle, &artStyle);
-
-	// Create a new style parser 
-	AIStyleParser parser(nullptr);
-    sAIArtStyleParser->NewParser(&parser);
-    
-	// Parse the art style
-    sAIArtStyleParser->ParseStyle(parser, artStyle);
-
-	// Get blend field
-	AIParserBlendField blendField;
-	sAIArtStyleParser->GetStyleBlendField(parser, &blendField); 
-	
 	// Get the blending mode
-	blendingMode = sAIBlendStyle->GetBlendingMode(artHandle);
+	blendingMode = artSource->GetBlendingMode(artHandle);
+
+	// Get the Live Effects for this art handle (art that isn't in an Illustrator document has none)
+	std::vector<LiveEffect> liveEffects;
+	artSource->GetLiveEffects(artHandle, liveEffects);
 
 	// How many post-effects are attached to this art style?
-	postEffectCount = sAIArtStyleParser->CountPostEffects(parser);
+	postEffectCount = (ASInt32)liveEffects.size();
 
 	// Loop through all post-effect art styles
-    for (ASInt32 postIndex = 0; (postIndex < postEffectCount); ++postIndex)
-    {
-		// Parse the Live Effects
-        AIParserLiveEffect liveEffect;
-        sAIArtStyleParser->GetNthPostEffect(parser, postIndex, &liveEffect);
-
-		// Get the Live Effect handle
-		AILiveEffectHandle liveEffectHandle;
-		sAIArtStyleParser->GetLiveEffectHandle(liveEffect, &liveEffectHandle);
-		
-		// Get the name of the effect (function appears to allocate its own memory???)
-		const char *liveEffectName = nullptr;
-		// TODO: Do we need to release this memory somewhere? Or does the fact that we retrieved the handle via the AIArtStyleParser do the trick
-		//       (since we clean-up the parser later)?
-		sAILiveEffect->GetLiveEffectName(liveEffectHandle, &liveEffectName);
+	for (size_t i = 0; i < liveEffects.size(); i++)
+	{
+		const LiveEffect& liveEffect = liveEffects[i];
 		if (debug)
 		{
-			outFile << "\n" << Indent(depth) << "// Live Effect name = " << liveEffectName;
+			commands.Text() << "\n" << Indent(depth) << "// Live Effect name = " << liveEffect.name;
 		}
 
-        // Check to see if the name is Adobe Drop Shadow
-		if (strcmp(liveEffectName, "Adobe Drop Shadow") == 0)
+		// Is this a drop shadow?
+		if (liveEffect.isDropShadow)
 		{
-			// Set default drop shadow values
-			dropShadow.horz = 0.0f;
-			dropShadow.vert = 0.0f;
-			dropShadow.blur = 0.0f;
-			dropShadow.opac = 1.0f;
-
 			// Note that this artwork has a drop shadow assigned
 			hasDropShadow = true;
-
-			// Obtain the parameters dictionary
-			AILiveEffectParameters params;
-			sAIArtStyleParser->GetLiveEffectParams(liveEffect, &params);
-
-			// Do we have any parameters?
-			if (params)
-			{
-				// Create an iterator for the parameters dictionary items
-				AIDictionaryIterator dictionaryIter = nullptr;
-				sAIDictionary->Begin(params, &dictionaryIter);
-
-				// Iterate through the parameter dictionary entries
-				int a = 0;
-				while ( !sAIDictionaryIterator->AtEnd(dictionaryIter) )
-				{
-					// Get the dictionary key
-					AIDictKey dictKey = sAIDictionaryIterator->GetKey(dictionaryIter);
-
-					// Get the key string
-					const char *keyString = nullptr;
-					keyString = sAIDictionary->GetKeyString(dictKey);
-
-					// Clean-up key string
-					char betterKeyString[256];
-					#ifdef MAC_ENV
-					strcpy(betterKeyString, keyString);
-					#endif
-					#ifdef WIN_ENV
-					strcpy_s(betterKeyString, keyString);
-					#endif
-					if (betterKeyString[0] == '-')
-						betterKeyString[0] = ' ';
-
-					// For matching keys, retrieve parameter values
-					if (strcmp(betterKeyString, "horz") == 0)
-					{
-						// Get horizontal shadow offset
-						sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.horz);
-					}
-					else if (strcmp(betterKeyString, "vert") == 0)
-					{
-						// Get vertical shadow offset
-						sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.vert);
-					}
-					else if (strcmp(betterKeyString, "blur") == 0)
-					{
-						// Get vertical shadow offset
-						sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.blur);
-					}
-					else if (strcmp(betterKeyString, "opac") == 0)
-					{
-						// Get shadow opacity
-						sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.opac);
-					}
-					else if (strcmp(betterKeyString, "sclr") == 0)
-					{
-						// Get shadow color
-						// TODO: Check to see if we have to do any reference counting for reading this key (and other keys)
-						AIEntryRef entryRef = sAIDictionary->Get(params, dictKey);
-						sAIEntry->ToFillStyle(entryRef, &dropShadow.shadowStyle);
-					}
-
-					// Move to the next dictionary entry
-					sAIDictionaryIterator->Next(dictionaryIter);
-					a++;
-				}
-				// Release the dictionary iterator
-				sAIDictionaryIterator->Release(dictionaryIter);
-			}
+			dropShadow = liveEffect.dropShadow;
 		}
 		else
 		{
 			// A Live Effect we don't recognize
 			if (debug)
 			{
-				outFile << "\n" << Indent(depth) << "//     Unsupported Live Effect: \"" << liveEffectName << "\"";
+				commands.Text() << "\n" << Indent(depth) << "//     Unsupported Live Effect: \"" << liveEffect.name << "\"";
 			}
 		}
-    }
-
-	// Dispose the art style parser
-	sAIArtStyleParser->DisposeParser(parser);
+	}
 }
 
 // Sets/restores the current state of the canvas
@@ -570,7 +434,7 @@ void Canvas::SetContextDrawingState(unsigned int depth)
 			PopState();
 
 			// Restore canvas state
-			outFile << "\n" << Indent((states.size() + 1)) << contextName << ".restore();";
+			commands.Restore((unsigned int)(states.size() + 1));
 		}
 	}
 	else if (depth > states.size())
@@ -582,7 +446,7 @@ void Canvas::SetContextDrawingState(unsigned int depth)
 			PushState();
 
 			// Save canvas state
-			outFile << "\n" << Indent((states.size() + 1)) << contextName << ".save();";
+			commands.Save((unsigned int)states.size() + 1);
 		}
 	}
 }
@@ -595,27 +459,33 @@ void Canvas::RenderDropShadow(const DropShadow& dropShadow, unsigned int depth)
 	// Allocate memory for shadow fill color value string
 	std::string shadowColor;
 	shadowColor = GetColor(dropShadow.shadowStyle.color, dropShadow.opac);
-	outFile << "\n" << Indent(depth) << contextName << ".shadowColor = " << shadowColor << ";";
+	commands.ShadowColor(depth, shadowColor);
 
 	// Shadow offsets
-	outFile << "\n" << Indent(depth) << contextName << ".shadowOffsetX = " << setiosflags(ios::fixed) << setprecision(1) << dropShadow.horz << ";";
-	outFile << "\n" << Indent(depth) << contextName << ".shadowOffsetY = " << setiosflags(ios::fixed) << setprecision(1) << dropShadow.vert << ";";
+	commands.ShadowOffsetX(depth, dropShadow.horz);
+	commands.ShadowOffsetY(depth, dropShadow.vert);
 
 	// Shadow blur
 	// TODO: Note that it appears that we have to double the Illustrator value to achieve equivalent results with <canvas>
-	outFile << "\n" << Indent(depth) << contextName << ".shadowBlur = " << setiosflags(ios::fixed) << setprecision(1) << (dropShadow.blur * 2.0f) << ";";
+	commands.ShadowBlur(depth, dropShadow.blur * 2.0f);
 }
 
 // There's no direct equivalent, so just rasterize to a bitmap
 void Canvas::RenderUnsupportedArt(AIArtHandle artHandle, const std::string& fileName, unsigned int depth)
 {
-	(void)depth;
+	// Only art in an Illustrator document can be rasterized
+	if (!artSource->CanRasterize())
+	{
+		commands.Text() << "\n" << Indent(depth) << "// This artwork can't be rasterized outside of Illustrator";
+		return;
+	}
 
 	// Full path to file
 	std::string fullPath = documentResources->folderPath + fileName;
 
 	// Rasterize to a 32-bit PNG that includes alpha
-	RasterizeArtToPNG(artHandle, fullPath);
+	artSource->RasterizeArtToPNG(artHandle, fullPath);
+	documentResources->statistics.AddRasterized();
 
 	// Get the actual dimensions of the rasterized PNG file
 	// Note that the AIArtOptSuite functions seems to rasterize to different sizes, which is why we do this step
@@ -625,7 +495,7 @@ void Canvas::RenderUnsupportedArt(AIArtHandle artHandle, const std::string& file
 
 	if (debug)
 	{
-		outFile << "\n// Actual PNG file dimensions, width = " << pngWidth << ", height = " << pngHeight;
+		commands.Text() << "\n// Actual PNG file dimensions, width = " << pngWidth << ", height = " << pngHeight;
 	}
 
 	// Add a new image
@@ -635,17 +505,16 @@ void Canvas::RenderUnsupportedArt(AIArtHandle artHandle, const std::string& file
 	image->pathIsAbsolute = false;
 
 	// Get image "alt" name
-	ai::UnicodeString artName;
+	std::string cleanName;
 	AIBoolean isDefaultName = false;
-	sAIArt->GetArtName(artHandle, artName, &isDefaultName);
-	std::string cleanName = artName.as_Platform();
+	artSource->GetArtName(artHandle, cleanName, &isDefaultName);
 	CleanFunction(cleanName);
 	CleanString(cleanName, false);
 	image->name = cleanName;
 
 	// Get the art bounding box (which includes transformations)
 	AIRealRect bounds;
-	sAIArt->GetArtBounds(artHandle, &bounds);
+	artSource->GetArtBounds(artHandle, &bounds);
 
 	// Transform the art bounding box
 	TransformRect(bounds);
@@ -655,89 +524,8 @@ void Canvas::RenderUnsupportedArt(AIArtHandle artHandle, const std::string& file
 	AIReal y = bounds.top + (((bounds.bottom - bounds.top) - pngHeight) / 2.0f);
 
 	// Draw image
-	image->RenderDrawImage(contextName, x, y);
-	image->DebugBounds(contextName, bounds);
-}
-
-// Given an art handle, rasterizes to a file at the given path
-// NOTE: While width and height are passed, the resulting file is often of a different size, which negatively affects positioning
-// See discussion thread: http://forums.adobe.com/thread/603776?tstart=0
-void Canvas::RasterizeArtToPNG(AIArtHandle artHandle, const std::string& path)
-{
-	ai::FilePath filePath;
-	filePath.Set(ai::UnicodeString(path));
-
-    AIRealRect bounds;
-    sAIArt->GetArtBounds(artHandle, &bounds);
-    AIReal artWidth = bounds.right - bounds.left;
-    AIReal artHeight = bounds.top - bounds.bottom;
-
-	AIErr result = kNoErr;
-	AIDataFilter *dstFilter = nullptr;
-	AIDataFilter *filter = nullptr;
-	if (!result)
-			result = sAIDataFilter->NewFileDataFilter(filePath, "write", 'prw', 'PNGf', &filter);
-	if (!result) {
-			result = sAIDataFilter->LinkDataFilter(dstFilter, filter);
-			dstFilter = filter;
-	}
-
-	// Set PNG parameters
-	AIImageOptPNGParams2 params;
-    params.versionOneSuiteParams.interlaced = false;
-    params.versionOneSuiteParams.numberOfColors = 16777216;
-    params.versionOneSuiteParams.transparentIndex = 0;
-    params.versionOneSuiteParams.resolution = 72.0f;
-    params.versionOneSuiteParams.outAlpha = true;
-    params.versionOneSuiteParams.outWidth = (ASInt32)artWidth;
-    params.versionOneSuiteParams.outHeight = (ASInt32)artHeight;
-
-    //We assume that the basic resolution of illustrator is 72 dpi
-    AIReal resolutionRatio =  1.0f;
-    AIReal minDim = min(artWidth,artHeight) * resolutionRatio;
-    AIReal maxDim = max(artWidth,artHeight) * resolutionRatio;
-    AIReal ratio = 1;
-
-    if (minDim < 1)
-    {
-            ratio = 1 / minDim;
-            minDim *= ratio;
-            maxDim *= ratio;
-    }
-
-    if (maxDim > 65535)
-    {
-            ratio *= 65535 / maxDim;
-    }
-
-    //Here we tune the resolution parameter to comply to minRasterizationDimension and
-    //maxRasterizationDimension constraints
-    //We assume that the basic resolution of illustrator is 72 dpi
-    params.versionOneSuiteParams.resolution *= (AIFloat)ratio;
-
-    params.antialias = true;
-    /* A cropping box for the art. If empty or degenerate, do not crop. */
-	AIRealRect crop;
-	crop.left = 0.0f;
-	crop.top = 0.0f;
-	crop.right = 0.0f;
-	crop.bottom = 0.0f;
-    params.cropBox = crop;
-    params.backgroundIsTransparent = true;
-    /* When backgroundIsTransparent is false, rasterize against this matte color. */
-    /*params.matteColor.red = 1.0f;
-    params.matteColor.green = 1.0f;
-    params.matteColor.blue = 1.0f; */
-
-	// Make PNG
-    result = sAIImageOpt->MakePNG24 (artHandle, dstFilter, params, ProgressProc);
-
-    if (dstFilter)
-	{
-		AIErr tmpresult = sAIDataFilter->UnlinkDataFilter(dstFilter, &dstFilter);
-		if (!result)
-				result = tmpresult;
-	}
+	image->RenderDrawImage(commands, x, y);
+	image->DebugBounds(commands, contextName, bounds);
 }
 
 // Get PNG dimensions
@@ -897,10 +685,10 @@ AIReal Canvas::GetJPGDPI(const std::string& path)
 				}
 			}
 		}
-	}
 
-	// Close the JPG file
-	fclose(jpgFile);
+		// Close the JPG file
+		fclose(jpgFile);
+	}
 
 	// Return DPI
 	return dpi;
@@ -919,20 +707,20 @@ uint16_t Canvas::ReverseInt(uint16_t i)
 
 void Canvas::ReportRasterRecordInfo(const AIRasterRecord& rasterRecord)
 {
-	outFile << "\n\n// Raster Record Info";
-	outFile << "\n//   flags = " << rasterRecord.flags;
-	outFile << "\n//   bounds = left:" << rasterRecord.bounds.left << ", top:" << rasterRecord.bounds.top <<
+	commands.Text() << "\n\n// Raster Record Info";
+	commands.Text() << "\n//   flags = " << rasterRecord.flags;
+	commands.Text() << "\n//   bounds = left:" << rasterRecord.bounds.left << ", top:" << rasterRecord.bounds.top <<
 		", right:" << rasterRecord.bounds.right << ", bottom:" << rasterRecord.bounds.bottom;
-	outFile << "\n//   byteWidth = " << rasterRecord.byteWidth;
-	outFile << "\n//   colorSpace = ";
+	commands.Text() << "\n//   byteWidth = " << rasterRecord.byteWidth;
+	commands.Text() << "\n//   colorSpace = ";
 	ReportColorSpaceInfo(rasterRecord.colorSpace);
-	outFile << "\n//   bitsPerPixel = " << rasterRecord.bitsPerPixel;
-	outFile << "\n//   originalColorSpace = ";
+	commands.Text() << "\n//   bitsPerPixel = " << rasterRecord.bitsPerPixel;
+	commands.Text() << "\n//   originalColorSpace = ";
 
 	// If originalColorSpace = -1, then raster hasn't been through the color converter
 	if (rasterRecord.originalColorSpace == -1)
 	{
-		outFile << "(hasn't been converted yet)";
+		commands.Text() << "(hasn't been converted yet)";
 	}
 	else
 	{
@@ -949,71 +737,60 @@ void Canvas::ReportColorSpaceInfo(ai::int16 colorSpace)
 	};
 
 	// Color space info
-	outFile << std::string(colorSpaces[colorSpace]) << " (" << colorSpace << ")";
+	commands.Text() << std::string(colorSpaces[colorSpace]) << " (" << colorSpace << ")";
 
 	// Alpha?
 	if (colorSpace & kColorSpaceHasAlpha)
 	{
-		outFile << " with alpha";
+		commands.Text() << " with alpha";
 	}
 }
 
-void Canvas::RenderGroupArt(AIArtHandle artHandle, unsigned int depth)
+void Canvas::RenderGroupArt(uint32_t index, unsigned int depth)
 {
-	// Get the first art element in the group
-	AIArtHandle childArtHandle = nullptr;
-	sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
-
 	// Render this sub-group
-	RenderArt(childArtHandle, depth + 1);
+	RenderArtNodes(documentResources->artTable.Node(index).child, depth + 1);
 }
 
-void Canvas::RenderPluginArt(AIArtHandle artHandle, unsigned int depth)
+void Canvas::RenderPluginArt(uint32_t index, unsigned int depth)
 {
+	ArtTable& artTable = documentResources->artTable;
+	AIArtHandle artHandle = artTable.Node(index).handle;
+
 	// For Illustrator plug-in art types, like "Compound Shape" and "Blend" 
 	// For simplicity, we render the "Result Group" (instead of the "Edit Group", which contains all of the original art)
 
 	// What kind of plug-in art is this?
-	// TODO: Do we really need to allocate memory here? Or does the call do it for us?
-	char **pluginArtName = (char **)calloc(1024, sizeof(char));
-	sAIPluginGroup->GetPluginArtName(artHandle, pluginArtName);
+	std::string pluginArtName;
+	artSource->GetPluginArtName(artHandle, pluginArtName);
 	if (debug)
 	{
-		outFile << "\n" << Indent(depth) << "// Plug-in art name = " << std::string(*pluginArtName);
+		commands.Text() << "\n" << Indent(depth) << "// Plug-in art name = " << pluginArtName;
 	}
 
 	// Is this the Pathfinder Suite? If so, we need to grab the style from this art handle
-	if (strcmp(*pluginArtName, "Pathfinder Suite") == 0)
+	if (pluginArtName == "Pathfinder Suite")
 	{
 		// Set pathfinder style
-		AIBoolean outHasAdvFill = false;
-		sAIPathStyle->GetPathStyle(artHandle, &pathfinderStyle, &outHasAdvFill);
+		pathfinderStyle = artTable.Style(index);
 		usePathfinderStyle = true;
 
-		// Determine if this plug-in art is clipping
-		AIBoolean clipping = false;
-		sAIPluginGroup->GetPluginArtClipping(artHandle, &clipping);
-
 		// Set clip on our "special style" so we know to clip later
-		pathfinderStyle.clip = clipping;
+		pathfinderStyle.clip = artTable.HasFlag(index, ArtTable::kNodeClip);
 	}
 
 	AIArtHandle resultArtHandle = nullptr;
 
 	// Get the result art handle
-	sAIPluginGroup->GetPluginArtResultArt(artHandle, &resultArtHandle);
+	artSource->GetPluginArtResultArt(artHandle, &resultArtHandle);
 
 	// Get the first art element in the result group
 	AIArtHandle childArtHandle = nullptr;
-	sAIArt->GetArtFirstChild(resultArtHandle, &childArtHandle);
+	artSource->GetArtFirstChild(resultArtHandle, &childArtHandle);
 
 	// Render this sub-group
 	// Stay at this depth, so we don't create a unique canvas context
 	RenderArt(childArtHandle, depth);
-
-	// Release memory
-	free(pluginArtName);
-	pluginArtName = nullptr;
 }
 
 void Canvas::RenderSymbolArt(AIArtHandle artHandle, unsigned int depth)
@@ -1024,26 +801,24 @@ void Canvas::RenderSymbolArt(AIArtHandle artHandle, unsigned int depth)
 
 	// Get the symbol transformation
 	AIRealMatrix transform;
-	sAISymbol->GetSoftTransformOfSymbolArt(artHandle, &transform);
+	artSource->GetSoftTransformOfSymbolArt(artHandle, &transform);
 
 	// Concat by [1 0 0 -1 0 0] as coordinates are going positive the other direction.
 	AIRealMatrix flipY = 
 	{
 		1, 0, 0,  - 1, 0, 0
 	};
-	sAIRealMath->AIRealMatrixConcat(&flipY, &transform, &transform);
+	RealMatrixConcat(&flipY, &transform, &transform);
 
 	// Concatenate symbol matrix with current internal transform
-	sAIRealMath->AIRealMatrixConcat(&transform, &currentState->internalTransform, &transform);
+	RealMatrixConcat(&transform, &currentState->internalTransform, &transform);
 	
 	// Render symbol transformation
-	outFile << "\n" << Indent(depth) << contextName << ".transform(";
-	RenderTransform(transform);
-	outFile << ");";
+	commands.Transform(depth, transform);
 
 	// Get the symbol pattern
 	AIPatternHandle symbolPatternHandle = nullptr;
-	sAISymbol->GetSymbolPatternOfSymbolArt(artHandle, &symbolPatternHandle);
+	artSource->GetSymbolPatternOfSymbolArt(artHandle, &symbolPatternHandle);
 
 	// Find the symbol pattern
 	Pattern* symbolPattern = documentResources->patterns.Find(symbolPatternHandle);
@@ -1053,7 +828,7 @@ void Canvas::RenderSymbolArt(AIArtHandle artHandle, unsigned int depth)
 	if (symbolPattern)
 	{
 		// Call the symbol function
-		outFile << "\n" << Indent(depth) << symbolPattern->name << "(" << contextName << ");";
+		commands.Call(depth, symbolPattern->name);
 	}
 
 	// Restore canvas state
@@ -1061,55 +836,40 @@ void Canvas::RenderSymbolArt(AIArtHandle artHandle, unsigned int depth)
 	SetContextDrawingState(depth);
 }
 
-void Canvas::RenderCompoundPathArt(AIArtHandle artHandle, unsigned int depth)
+void Canvas::RenderCompoundPathArt(uint32_t index, unsigned int depth)
 {
-	// Get the first art element in the group
-	AIArtHandle childArtHandle = nullptr;
-	sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
-
-	outFile << "\n" << Indent(depth) << contextName << ".beginPath();";
+	commands.BeginPath(depth);
 
 	// Render this sub-group
-	RenderArt(childArtHandle, depth);
-
-	// Get the "normal" style for this path
-	AIPathStyle style;
-	AIBoolean outHasAdvFill = false;
-	sAIPathStyle->GetPathStyle(artHandle, &style, &outHasAdvFill);
+	RenderArtNodes(documentResources->artTable.Node(index).child, depth);
 
-	// Apply style
-	RenderPathStyle(style, depth);
+	// Apply the "normal" style for this path
+	RenderPathStyle(documentResources->artTable.Node(index).style, depth);
 
 	// Render this sub-group
 	//RenderPathArt(childArtHandle, depth + 1);
 }
 
-void Canvas::RenderPathArt(AIArtHandle artHandle, unsigned int depth)
+void Canvas::RenderPathArt(uint32_t index, unsigned int depth)
 {
+	ArtTable& artTable = documentResources->artTable;
+
 	// Skip if this path is a "guide"
-	AIBoolean isGuide = false;
-	sAIPath->GetPathGuide(artHandle, &isGuide);
-	if (!isGuide)
+	if (!artTable.HasFlag(index, ArtTable::kNodeGuide))
 	{
 		// Is this art part of a compound path?
-		AIBoolean isCompound = false;
-		ai::int32 attr = 0;
-		sAIArt->GetArtUserAttr(artHandle, kArtPartOfCompound, &attr);
-		isCompound = ((attr &kArtPartOfCompound) == kArtPartOfCompound);
+		AIBoolean isCompound = artTable.HasFlag(index, ArtTable::kNodeCompound);
 		if (debug)
 		{
-			outFile << "\n\n" << Indent(depth) << "// Art is compound = " << isCompound;
+			commands.Text() << "\n\n" << Indent(depth) << "// Art is compound = " << isCompound;
 		}
 
-		// Get the "normal" style for this path
-		AIPathStyle style;
-		AIBoolean outHasAdvFill = false;
-		sAIPathStyle->GetPathStyle(artHandle, &style, &outHasAdvFill);
+		AIArtHandle artHandle = artTable.Node(index).handle;
 
 		// Begin path
 		if (!isCompound)
 		{
-			outFile << "\n" << Indent(depth) << contextName << ".beginPath();";
+			commands.BeginPath(depth);
 		}
 
 		// Write each path as a figure
@@ -1129,8 +889,8 @@ void Canvas::RenderPathArt(AIArtHandle artHandle, unsigned int depth)
 			}
 			else
 			{
-				// Apply style
-				RenderPathStyle(style, depth);
+				// Apply the "normal" style for this path
+				RenderPathStyle(artTable.Node(index).style, depth);
 			}
 		}
 	}
@@ -1141,91 +901,114 @@ void Canvas::RenderPathFigure(AIArtHandle artHandle, unsigned int depth)
 {
 	// Is this a closed path?
 	AIBoolean pathClosed = false;
-	sAIPath->GetPathClosed(artHandle, &pathClosed);
-
-	// Get the path starting point
-	AIPathSegment segment;
-	sAIPath->GetPathSegments(artHandle, 0, 1, &segment);
+	artSource->GetPathClosed(artHandle, &pathClosed);
 
-	// Remember the first segment, in case we have to create an extra segment to close the figure
-	AIPathSegment firstSegment = segment;
+	// Get all of the segments at once
+	SegmentBuffer& segments = documentResources->segments;
+	size_t segmentCount = segments.Fetch(artHandle);
+	documentResources->statistics.AddSegments(segmentCount);
+	if (segmentCount == 0)
+	{
+		return;
+	}
 
-	// Transform starting point
-	TransformPoint(segment.p);
-	TransformPoint(segment.in);
-	TransformPoint(segment.out);
+	// Transform all of the points
+	// If we're processing a symbol, we don't need to transform anything, since symbols are defined in their own coordinate space
+	if (currentState->isProcessingSymbol)
+	{
+		segments.Harden();
+	}
+	else
+	{
+		segments.Transform(currentState->internalTransform);
+	}
 
 	// Move to the first point
-	outFile << "\n" << Indent(depth) << contextName << ".moveTo(" <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		segment.p.h << ", " << segment.p.v << ");";
-
-	// How many segments are in this path?
-	short segmentCount = 0;
-	sAIPath->GetPathSegmentCount(artHandle, &segmentCount);
-
-	// Track the last out point
-	AIPathSegment previousSegment = segment;
+	commands.MoveTo(depth, segments.px[0], segments.py[0]);
 
 	// Loop through each segment
-	for (short segmentIndex = 1; segmentIndex < segmentCount; segmentIndex++)
+	for (size_t segmentIndex = 1; segmentIndex < segmentCount; segmentIndex++)
 	{
-		sAIPath->GetPathSegments(artHandle, segmentIndex, 1, &segment);
-
-		RenderSegment(previousSegment, segment, depth);
-
-		previousSegment = segment;
+		RenderSegment(segments, segmentIndex - 1, segmentIndex, depth);
 	}
 
 	// Handle closing segment
 	if (pathClosed)
 	{
 		// Create "phantom" extra segment to accomodate curve
-		RenderSegment(previousSegment, firstSegment, depth);
+		RenderSegment(segments, segmentCount - 1, 0, depth);
 
 		// Close the path
-		outFile << "\n" << Indent(depth) << contextName << ".closePath();";
+		commands.ClosePath(depth);
 	}
 }
 
-void Canvas::RenderSegment(AIPathSegment& previousSegment, AIPathSegment& segment, unsigned int depth)
+// Output the segment from previous to current (both already transformed)
+void Canvas::RenderSegment(const SegmentBuffer& segments, size_t previous, size_t current, unsigned int depth)
 {
-	// Transform points
-	TransformPoint(segment.p);
-	TransformPoint(segment.in);
-	TransformPoint(segment.out);
-
-	// Is this a straight line segment?
-	AIBoolean isLine = ((previousSegment.p.h == previousSegment.out.h && previousSegment.p.v == previousSegment.out.v) &&
-						(segment.p.h == segment.in.h && segment.p.v == segment.in.v));
-
 	// Draw a segment
 
 	// Is this a line?
-	if (isLine)
+	if (segments.IsLine(previous, current))
 	{
 		// Draw straight line
-		outFile << "\n" << Indent(depth) << contextName << ".lineTo(" <<
-			setiosflags(ios::fixed) << setprecision(1) << 
-			segment.p.h << ", " << segment.p.v << ");";
+		commands.LineTo(depth, segments.px[current], segments.py[current]);
 	}
 	else
 	{
 		// Output Bezier segment
-		outFile << "\n" << Indent(depth) << contextName << ".bezierCurveTo(" <<
-			setiosflags(ios::fixed) << setprecision(1)
-			<< previousSegment.out.h << ", " << previousSegment.out.v << ", "
-			<< segment.in.h << ", " << segment.in.v << ", "
-			<< segment.p.h << ", " << segment.p.v << ");";
+		commands.BezierCurveTo(depth, segments.outx[previous], segments.outy[previous], segments.inx[current], segments.iny[current], segments.px[current], segments.py[current]);
 	}
 }
 
+// Apply a style from the document's style collection (its fill and stroke strings are only built once)
+void Canvas::RenderPathStyle(uint32_t styleIndex, unsigned int depth)
+{
+	StyleCollection& styles = documentResources->artTable.styles;
+	const AIPathStyle& style = styles.Style(styleIndex);
+
+	if (!styles.HasStrings(styleIndex))
+	{
+		std::string fillStyle;
+		std::string strokeStyle;
+		GetPathStyleStrings(style, fillStyle, strokeStyle);
+		styles.SetStrings(styleIndex, fillStyle, strokeStyle);
+	}
+
+	RenderPathStyle(style, styles.FillStyle(styleIndex), styles.StrokeStyle(styleIndex), depth);
+}
+
 void Canvas::RenderPathStyle(const AIPathStyle& style, unsigned int depth)
+{
+	std::string fillStyle;
+	std::string strokeStyle;
+	GetPathStyleStrings(style, fillStyle, strokeStyle);
+
+	RenderPathStyle(style, fillStyle, strokeStyle, depth);
+}
+
+// Get the fill and stroke style strings for a style (only for paints that are used)
+void Canvas::GetPathStyleStrings(const AIPathStyle& style, std::string& fillStyle, std::string& strokeStyle)
+{
+	if (!style.clip)
+	{
+		if (style.fillPaint)
+		{
+			GetFillStyle(style.fill.color, 1.0f, fillStyle);
+		}
+		if (style.strokePaint)
+		{
+			GetFillStyle(style.stroke.color, 1.0f, strokeStyle);
+		}
+	}
+}
+
+void Canvas::RenderPathStyle(const AIPathStyle& style, const std::string& fillStyle, const std::string& strokeStyle, unsigned int depth)
 {
 	// Is this clipping?
 	if (style.clip)
 	{
-		outFile << "\n" << Indent(depth) << contextName << ".clip();";
+		commands.Clip(depth);
 	}
 	else
 	{
@@ -1235,23 +1018,23 @@ void Canvas::RenderPathStyle(const AIPathStyle& style, unsigned int depth)
 			// Investigate style.evenodd
 			// http://www.whatwg.org/specs/web-apps/current-work/multipage/the-canvas-element.html
 
-			RenderFillInfo(style.fill.color, depth);
+			RenderFillInfo(style.fill.color, fillStyle, depth);
 			if (style.evenodd)
 			{
-				outFile << "\n" << Indent(depth) << contextName << ".fill(\"evenodd\");";
+				commands.FillEvenOdd(depth);
 			}
 			else
 			{
 				// Non-zero is the default, so no need to specify
-				outFile << "\n" << Indent(depth) << contextName << ".fill();";
+				commands.Fill(depth);
 			}
 		}
 
 		// Output stroke information
 		if (style.strokePaint)
 		{
-			RenderStrokeInfo(style.stroke, depth);
-			outFile << "\n" << Indent(depth) << contextName << ".stroke();";
+			RenderStrokeInfo(style.stroke, strokeStyle, depth);
+			commands.Stroke(depth);
 		}
 	}
 }
@@ -1260,58 +1043,49 @@ void Canvas::RenderPlacedArt(AIArtHandle artHandle, unsigned int depth)
 {
 	// Get type of placed art
 	short placedType = 0;
-	sAIPlaced->GetPlacedType(artHandle, &placedType);
+	artSource->GetPlacedType(artHandle, &placedType);
 	if (debug)
 	{
-		outFile << "\n" << Indent(depth) << "// Placed art type = " << placedType;
+		commands.Text() << "\n" << Indent(depth) << "// Placed art type = " << placedType;
 	}
 
 	// Only bother if this isn't EPS art (should then be linked raster art)
 	if (placedType != kEPSType)
 	{
 		// Get file path
-		ai::UnicodeString path;
-		sAIPlaced->GetPlacedFilePathFromArt(artHandle, path);
+		std::string path;
+		artSource->GetPlacedFilePath(artHandle, path);
 		if (debug)
 		{
-			outFile << "\n" << Indent(depth) << "// Placed art file path = " << path.as_Platform();
+			commands.Text() << "\n" << Indent(depth) << "// Placed art file path = " << path;
 		}
 
 		// Add a new image
-		Image* image = documentResources->images.Add(path.as_Platform());
+		Image* image = documentResources->images.Add(path);
 
 		// Image is an absolute path
 		image->pathIsAbsolute = true;
 
 		// Get image "alt" name
-		ai::UnicodeString artName;
+		std::string cleanName;
 		AIBoolean isDefaultName = false;
-		sAIArt->GetArtName(artHandle, artName, &isDefaultName);
-		std::string cleanName = artName.as_Platform();
+		artSource->GetArtName(artHandle, cleanName, &isDefaultName);
 		CleanFunction(cleanName);
 		CleanString(cleanName, false);
 		image->name = cleanName;
 
-		// Get placed dimensions
-		AIRealPoint size;
-		AIRealRect viewBounds;
-		AIRealMatrix viewMatrix;
-		AIRealRect imageBounds;
-		AIRealMatrix imageMatrix;
-		sAIPlaced->GetPlacedDimensions(artHandle, &size, &viewBounds, &viewMatrix, &imageBounds, &imageMatrix);
-
 		// Get the art bounding box (which includes transformations)
 		AIRealRect bounds;
-		sAIArt->GetArtBounds(artHandle, &bounds);
+		artSource->GetArtBounds(artHandle, &bounds);
 
 		// Transform the art bounding box
 		TransformRect(bounds);
 
-		image->DebugBounds(contextName, bounds);
+		image->DebugBounds(commands, contextName, bounds);
 
 		// Get the transformation matrix for this placed art
 		AIRealMatrix transform;
-		sAIPlaced->GetPlacedMatrix(artHandle, &transform);
+		artSource->GetPlacedMatrix(artHandle, &transform);
 
 		// Flip the image
 		transform.c *= -1.0f;
@@ -1322,7 +1096,7 @@ void Canvas::RenderPlacedArt(AIArtHandle artHandle, unsigned int depth)
 		transform.ty = (bounds.top + bounds.bottom) / 2.0f;
 
 		// Get JPG DPI
-		AIReal dpi = GetJPGDPI(path.as_Platform());
+		AIReal dpi = GetJPGDPI(path);
 
 		// Modify transform values based on DPI setting
 		AIReal ratio = 72.0f / dpi;
@@ -1336,18 +1110,16 @@ void Canvas::RenderPlacedArt(AIArtHandle artHandle, unsigned int depth)
 		SetContextDrawingState(depth);
 
 		// Render transform
-		outFile << "\n" << Indent(depth) << contextName << ".transform(";
-		RenderTransform(transform);
-		outFile << ");";
+		commands.Transform(depth, transform);
 
 		// Get actual image dimensions (files that aren't 72 DPI don't report real sizes, so need to do this)
 		AIRasterRecord info;
 		AIBoolean isRaster = true;
-		sAIPlaced->GetRasterInfo(artHandle, &info, &isRaster);
+		artSource->GetPlacedRasterInfo(artHandle, &info, &isRaster);
 
 		// Draw image
 		// Draw so that the center point is position at 0, 0 (so transformation happens correctly)
-		image->RenderDrawImage(contextName, (-1.0f * (info.bounds.right / 2.0f)), (-1.0f * (info.bounds.bottom / 2.0f)));
+		image->RenderDrawImage(commands, (-1.0f * (info.bounds.right / 2.0f)), (-1.0f * (info.bounds.bottom / 2.0f)));
 
 		// Restore canvas state
 		depth--;
@@ -1357,29 +1129,28 @@ void Canvas::RenderPlacedArt(AIArtHandle artHandle, unsigned int depth)
 
 void Canvas::RenderRasterArt(AIArtHandle artHandle, unsigned int depth)
 {
-	// Get the raster record
-	AIRasterRecord rasterRecord;
-	sAIRaster->GetRasterInfo(artHandle, &rasterRecord);
+	// Embedded images are written by rasterizing them
+	if (!artSource->CanRasterize())
+	{
+		commands.Text() << "\n" << Indent(depth) << "// This artwork can't be rasterized outside of Illustrator";
+		return;
+	}
 
 	// Get the original file path
 	// TODO: Is this *always* present? NO, it isn't. Need to add a base filename for empty paths.
-	ai::UnicodeString path;
-	sAIRaster->GetRasterFilePathFromArt(artHandle, path);
+	std::string path;
+	artSource->GetRasterFilePath(artHandle, path);
 	if (debug)
 	{
-		outFile << "\n" << Indent(depth) << "// Raster file path from art = " << path.as_Platform();
+		commands.Text() << "\n" << Indent(depth) << "// Raster file path from art = " << path;
 	}
 
 	// Did we get a filename?
-	std::string fileName = path.as_UTF8();
+	std::string fileName = path;
 	if (fileName.length() > 0)
 	{
-		// Construct a FilePath
-		ai::UnicodeString usFileName(fileName);
-		ai::FilePath aiFilePath(usFileName);
-
 		// Extract file name
-		fileName = aiFilePath.GetFileNameNoExt().as_Platform();
+		fileName = GetFileNameNoExt(fileName);
 	}
 	else
 	{
@@ -1395,7 +1166,7 @@ void Canvas::RenderRasterArt(AIArtHandle artHandle, unsigned int depth)
 
 	// NOTE: Remember that a single image/filename can be embedded multiple times using different
 	//       transformations in a single Illustrator document. So, they need to be unique when they're rasterized anyway.
-	RasterizeArtToPNG(artHandle, fullPath);
+	artSource->RasterizeArtToPNG(artHandle, fullPath);
 
 	// Add a new image
 	Image* image = documentResources->images.Add(uniqueFileName);
@@ -1404,35 +1175,29 @@ void Canvas::RenderRasterArt(AIArtHandle artHandle, unsigned int depth)
 	image->pathIsAbsolute = false;
 
 	// Get image "alt" name
-	ai::UnicodeString artName;
+	std::string cleanName;
 	AIBoolean isDefaultName = false;
-	sAIArt->GetArtName(artHandle, artName, &isDefaultName);
-	std::string cleanName = artName.as_Platform();
+	artSource->GetArtName(artHandle, cleanName, &isDefaultName);
 	CleanFunction(cleanName);
 	CleanString(cleanName, false);
 	image->name = cleanName;
 
 	// Get the art bounding box (which includes transformations)
 	AIRealRect bounds;
-	sAIArt->GetArtBounds(artHandle, &bounds);
+	artSource->GetArtBounds(artHandle, &bounds);
 
 	// Transform the art bounding box
 	TransformRect(bounds);
 
 	// Draw image
-	image->RenderDrawImage(contextName, bounds.left, bounds.top);
-	image->DebugBounds(contextName, bounds);
+	image->RenderDrawImage(commands, bounds.left, bounds.top);
+	image->DebugBounds(commands, contextName, bounds);
 }
 
 // 10/11/2012: Added alpha support
-void Canvas::RenderMidPointColor(const AIColor& color1, AIReal alpha1, const AIColor& color2, AIReal alpha2)
+// Colors have already been converted to RGB
+void Canvas::RenderMidPointColor(const AIColor& rgbColor1, AIReal alpha1, const AIColor& rgbColor2, AIReal alpha2)
 {
-	// Convert colors to RGB color space
-	AIColor rgbColor1;
-	AIColor rgbColor2;
-	ConvertColorToRGB(color1, rgbColor1);
-	ConvertColorToRGB(color2, rgbColor2);
-
 	// Calculate mid-point
 	AIReal percentage = 0.5;
 
@@ -1441,15 +1206,15 @@ void Canvas::RenderMidPointColor(const AIColor& color1, AIReal alpha1, const AIC
         alpha2 != 1.0f)
 	{
 		// Include alpha
-        outFile << "rgba(" <<
+        commands.Text() << "rgba(" <<
 		(int)((rgbColor1.c.rgb.red + (percentage *(rgbColor2.c.rgb.red - rgbColor1.c.rgb.red)))*(float)255) << ", " <<
 		(int)((rgbColor1.c.rgb.green + (percentage *(rgbColor2.c.rgb.green - rgbColor1.c.rgb.green)))*(float)255) << ", " <<
 		(int)((rgbColor1.c.rgb.blue + (percentage *(rgbColor2.c.rgb.blue - rgbColor1.c.rgb.blue)))*(float)255) << ", " <<
-        setiosflags(ios::fixed) << setprecision(2) << (alpha1 + (percentage * (alpha2 - alpha1))) << ")";
+        Fixed<2>(alpha1 + (percentage * (alpha2 - alpha1))) << ")";
 	}
 	else
 	{
-        outFile << "rgb(" <<
+        commands.Text() << "rgb(" <<
 		(int)((rgbColor1.c.rgb.red + (percentage *(rgbColor2.c.rgb.red - rgbColor1.c.rgb.red)))*(float)255) << ", " <<
 		(int)((rgbColor1.c.rgb.green + (percentage *(rgbColor2.c.rgb.green - rgbColor1.c.rgb.green)))*(float)255) << ", " <<
 		(int)((rgbColor1.c.rgb.blue + (percentage *(rgbColor2.c.rgb.blue - rgbColor1.c.rgb.blue)))*(float)255) << ")";
@@ -1459,8 +1224,8 @@ void Canvas::RenderMidPointColor(const AIColor& color1, AIReal alpha1, const AIC
 void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int depth)
 {
 	// What kind of gradient is it?
-	short type;
-	sAIGradient->GetGradientType(gradientStyle.gradient, &type);
+	short type = kLinearGradient;
+	artSource->GetGradientType(gradientStyle.gradient, &type);
 
 	// Grab the transformation matrix
 	AIRealMatrix matrix = gradientStyle.matrix;
@@ -1469,11 +1234,11 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 	if (currentState->isProcessingSymbol)
 	{
 		// If this is a symbol, we need to harden the matrix
-		sAIHardSoft->AIRealMatrixHarden(&matrix);
+		artSource->AIRealMatrixHarden(&matrix);
 	}
 	else
 	{
-		sAIRealMath->AIRealMatrixConcat(&matrix, &currentState->internalTransform, &matrix);
+		RealMatrixConcat(&matrix, &currentState->internalTransform, &matrix);
 	}
 
 	// Is there any transformation other than translation?
@@ -1492,9 +1257,7 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 		SetContextDrawingState(depth);
 
 		// Set gradient transform
-		outFile << "\n" << Indent(depth) << contextName << ".transform(";
-		RenderTransform(matrix);
-		outFile << ");";
+		commands.Transform(depth, matrix);
 	}
 
 	// Grab the origin
@@ -1505,8 +1268,8 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 		case (kLinearGradient): 
 		{
 			AIRealPoint p2;
-			sAIRealMath->AIRealPointLengthAngle(gradientStyle.gradientLength, sAIRealMath->DegreeToRadian(gradientStyle.gradientAngle), &p2);
-			sAIRealMath->AIRealPointAdd(&p1, &p2, &p2);
+			RealPointLengthAngle(gradientStyle.gradientLength, DegreeToRadian(gradientStyle.gradientAngle), &p2);
+			RealPointAdd(&p1, &p2, &p2);
 
 			// If we aren't transforming with a matrix, simply transform the individual points
 			if (!isTransformed)
@@ -1515,9 +1278,8 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 				TransformPointWithMatrix(p2, matrix);
 			}
 
-			outFile << "\n" << Indent(depth) << "gradient = " << contextName << ".createLinearGradient(" <<
-				setiosflags(ios::fixed) << setprecision(1) <<
-				p1.h << ", " << p1.v << ", " << p2.h << ", " << p2.v << ");";
+			commands.Text() << "\n" << Indent(depth) << "gradient = " << contextName << ".createLinearGradient(" <<
+				Fixed<1>(p1.h) << ", " << Fixed<1>(p1.v) << ", " << Fixed<1>(p2.h) << ", " << Fixed<1>(p2.v) << ");";
 
 			RenderGradientStops(gradientStyle, depth);
 
@@ -1526,8 +1288,8 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 		case (kRadialGradient): 
 		{
 			AIRealPoint p2;
-			sAIRealMath->AIRealPointLengthAngle((gradientStyle.hiliteLength * gradientStyle.gradientLength), sAIRealMath->DegreeToRadian(gradientStyle.hiliteAngle), &p2);
-			sAIRealMath->AIRealPointAdd(&p1, &p2, &p2);
+			RealPointLengthAngle((gradientStyle.hiliteLength * gradientStyle.gradientLength), DegreeToRadian(gradientStyle.hiliteAngle), &p2);
+			RealPointAdd(&p1, &p2, &p2);
 
 			// If we aren't transforming with a matrix, simply transform the individual points
 			if (!isTransformed)
@@ -1537,9 +1299,8 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 			}
 
 			// Don't pre-transform any points, because our world transformation will do it for us
-			outFile << "\n" << Indent(depth) << "gradient = " << contextName << ".createRadialGradient(" <<
-				setiosflags(ios::fixed) << setprecision(1) <<
-				p2.h << ", " << p2.v << ", " << 0.0f << ", " << p1.h << ", " << p1.v << ", " << gradientStyle.gradientLength << ");";
+			commands.Text() << "\n" << Indent(depth) << "gradient = " << contextName << ".createRadialGradient(" <<
+				Fixed<1>(p2.h) << ", " << Fixed<1>(p2.v) << ", " << Fixed<1>(0.0f) << ", " << Fixed<1>(p1.h) << ", " << Fixed<1>(p1.v) << ", " << Fixed<1>(gradientStyle.gradientLength) << ");";
 
 			RenderGradientStops(gradientStyle, depth);
 
@@ -1552,31 +1313,42 @@ void Canvas::RenderGradient(const AIGradientStyle& gradientStyle, unsigned int d
 // 10/11/2012: Added gradient stop support for CS6
 void Canvas::RenderGradientStops(const AIGradientStyle& gradientStyle, unsigned int depth)
 {
-	AIGradientStop gradientStop;
-	AIGradientStop gradientStopNext;
-	short count, index;
+	short count = 0;
 	AIReal stopPoint;
 
-	sAIGradient->GetGradientStopCount(gradientStyle.gradient, &count);
+	artSource->GetGradientStopCount(gradientStyle.gradient, &count);
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// Get all of the stops, then convert their colors together
+	std::vector<AIGradientStop> gradientStops(count);
+	std::vector<AIColor> colors(count);
+	std::vector<AIColor> rgbColors(count);
+	for (short index = 0; index < count; index++)
+	{
+		artSource->GetNthGradientStop(gradientStyle.gradient, index, &gradientStops[index]);
+		colors[index] = gradientStops[index].color;
+	}
+	documentResources->colors.ConvertToRGB(colors.data(), count, rgbColors.data());
 
-	for (index = 0; index < count; index++)
+	for (short index = 0; index < count; index++)
 	{
-		sAIGradient->GetNthGradientStop(gradientStyle.gradient, index, &gradientStop);
+		const AIGradientStop& gradientStop = gradientStops[index];
 		stopPoint = gradientStop.rampPoint / (float)100;
-		outFile << "\n" << Indent(depth) << "gradient.addColorStop(" <<
-			setiosflags(ios::fixed) << setprecision(2) <<
-			stopPoint << ", " << GetColor(gradientStop.color, gradientStop.opacity) << ");";
+		commands.Text() << "\n" << Indent(depth) << "gradient.addColorStop(" <<
+			Fixed<2>(stopPoint) << ", " << GetRGBColor(rgbColors[index], gradientStop.opacity) << ");";
 
 		// Handle midpoints that aren't exacly at 50% (ignore midpoint for last stop)
 		if (gradientStop.midPoint != 50.0f && index < (count - 1))
 		{
-			sAIGradient->GetNthGradientStop(gradientStyle.gradient, index + 1, &gradientStopNext);
+			const AIGradientStop& gradientStopNext = gradientStops[index + 1];
 			stopPoint = (gradientStop.rampPoint + ((gradientStop.midPoint / (float)100)*(gradientStopNext.rampPoint - gradientStop.rampPoint))) / (float)100;
-			outFile << "\n" << Indent(depth) << "gradient.addColorStop(" <<
-				setiosflags(ios::fixed) << setprecision(2) <<
-				stopPoint << ", \"";
-			RenderMidPointColor(gradientStop.color, gradientStop.opacity, gradientStopNext.color, gradientStopNext.opacity);
-			outFile << "\");";
+			commands.Text() << "\n" << Indent(depth) << "gradient.addColorStop(" <<
+				Fixed<2>(stopPoint) << ", \"";
+			RenderMidPointColor(rgbColors[index], gradientStop.opacity, rgbColors[index + 1], gradientStopNext.opacity);
+			commands.Text() << "\");";
 		}
 	}
 }
@@ -1590,6 +1362,12 @@ void Canvas::RenderFillInfo(const AIColor& fillColor, unsigned int depth)
 	// Get fill style value
 	GetFillStyle(fillColor, 1.0f, fillStyle);
 
+	RenderFillInfo(fillColor, fillStyle, depth);
+}
+
+// Output fill information (with a fill style string from GetFillStyle)
+void Canvas::RenderFillInfo(const AIColor& fillColor, const std::string& fillStyle, unsigned int depth)
+{
 	// Render based on the kind of fill style
 	switch (fillColor.kind)
 	{
@@ -1605,7 +1383,7 @@ void Canvas::RenderFillInfo(const AIColor& fillColor, unsigned int depth)
 				currentState->fillStyle = fillStyle;
 
 				// Change the fill style
-				outFile << "\n" << Indent(depth) << contextName << ".fillStyle = " << currentState->fillStyle << ";";
+				commands.FillStyle(depth, currentState->fillStyle);
 			}
 			break;
 		}
@@ -1627,18 +1405,16 @@ void Canvas::RenderFillInfo(const AIColor& fillColor, unsigned int depth)
 
 				// Create the pattern
 				// Don't save context, since this is a different/sub canvas
-				outFile << "\n" << Indent(depth) << "pattern = " << contextName << ".createPattern(" <<
+				commands.Text() << "\n" << Indent(depth) << "pattern = " << contextName << ".createPattern(" <<
 					"document.getElementById(\"pattern" << pattern->canvasIndex << "\"), \"repeat\");";
 
 				// Set pattern fill transform
 				// TODO: Need to figure out how to determine proper X and Y offsets
 				// TODO: We should be able to avoid this, if the transform is identity
-				outFile << "\n" << Indent(depth) << contextName << ".transform(";
-				RenderTransform(fillColor.c.p.transform);
-				outFile << ");";
+				commands.Transform(depth, fillColor.c.p.transform);
 
 				// Change fill style to pattern
-				outFile << "\n" << Indent(depth) << contextName << ".fillStyle = " << currentState->fillStyle << ";";
+				commands.FillStyle(depth, currentState->fillStyle);
 			}
 
 			break;
@@ -1664,7 +1440,7 @@ void Canvas::RenderFillInfo(const AIColor& fillColor, unsigned int depth)
 			//outFile << ");");
 
 			// Change the fill style
-			outFile << "\n" << Indent(depth) << contextName << ".fillStyle = " << currentState->fillStyle << ";";
+			commands.FillStyle(depth, currentState->fillStyle);
 			break;
 		}
         case kNoneColor:
@@ -1714,45 +1490,49 @@ void Canvas::GetFillStyle(const AIColor& color, AIReal alpha, std::string& fillS
 // Report on a pattern style
 void Canvas::ReportPatternStyleInfo(const AIPatternStyle& patternStyle)
 {
-	outFile << "\n\n// Pattern Info";
-	outFile << "\n//   shiftDist = " <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		patternStyle.shiftDist;
-	outFile << "\n//   shiftAngle = %.2f" <<
-		setiosflags(ios::fixed) << setprecision(2) <<
-		patternStyle.shiftAngle;
-	outFile << "\n//   scale = " <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		patternStyle.scale.h << ", " << patternStyle.scale.v;
-	outFile << "\n//   rotate = " <<
-		setiosflags(ios::fixed) << setprecision(2) <<
-		patternStyle.rotate;
-	outFile << "\n//   reflect = " << patternStyle.reflect;
-	outFile << "\n//   reflectAngle = " <<
-		setiosflags(ios::fixed) << setprecision(2) <<
-		patternStyle.reflectAngle;
-	outFile << "\n//   shearAngle = " <<
-		setiosflags(ios::fixed) << setprecision(2) <<
-		patternStyle.shearAngle;
-	outFile << "\n//   shiftDist = " <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		patternStyle.shiftDist;
-	outFile << "\n//   shiftAxis = " <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		patternStyle.shearAxis;
-	outFile << "\n//   transform = ";
-	RenderTransform(patternStyle.transform);
+	commands.Text() << "\n\n// Pattern Info";
+	commands.Text() << "\n//   shiftDist = " <<
+		Fixed<1>(patternStyle.shiftDist);
+	commands.Text() << "\n//   shiftAngle = %.2f" <<
+		Fixed<2>(patternStyle.shiftAngle);
+	commands.Text() << "\n//   scale = " <<
+		Fixed<1>(patternStyle.scale.h) << ", " << Fixed<1>(patternStyle.scale.v);
+	commands.Text() << "\n//   rotate = " <<
+		Fixed<2>(patternStyle.rotate);
+	commands.Text() << "\n//   reflect = " << patternStyle.reflect;
+	commands.Text() << "\n//   reflectAngle = " <<
+		Fixed<2>(patternStyle.reflectAngle);
+	commands.Text() << "\n//   shearAngle = " <<
+		Fixed<2>(patternStyle.shearAngle);
+	commands.Text() << "\n//   shiftDist = " <<
+		Fixed<1>(patternStyle.shiftDist);
+	commands.Text() << "\n//   shiftAxis = " <<
+		Fixed<1>(patternStyle.shearAxis);
+	commands.Text() << "\n//   transform = ";
+	RenderTransform(patternStyle.transform, commands.Text());
 }
 
 // Output stroke information
 void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int depth)
+{
+	// Allocate memory for stroke style value string
+	std::string strokeStyleValue;
+
+	// Get the stroke color value
+	GetFillStyle(strokeStyle.color, 1.0f, strokeStyleValue);
+
+	RenderStrokeInfo(strokeStyle, strokeStyleValue, depth);
+}
+
+// Output stroke information (with a stroke style string from GetFillStyle)
+void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, const std::string& strokeStyleValue, unsigned int depth)
 {
 	// Does this stroke use features that we can't convert?
 	// TODO: Check for some false positives here...seem to see it where there aren't custom dash styles on occasion
 	if (strokeStyle.dash.length != 0)
 	{
 		// Stroke uses a dash style that has no canvas equivalent
-		outFile << "\n" << Indent(depth) << "// This artwork uses an unsupported dash style";
+		commands.Text() << "\n" << Indent(depth) << "// This artwork uses an unsupported dash style";
 	}
 
 	// Stroke thickness
@@ -1762,9 +1542,7 @@ void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int dep
 		currentState->lineWidth = strokeStyle.width;
 
 		// Output line width change
-		outFile << "\n" << Indent(depth) << contextName << ".lineWidth = " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			currentState->lineWidth << ";";
+		commands.LineWidth(depth, currentState->lineWidth);
 	}
 
 	// Stroke color
@@ -1775,12 +1553,6 @@ void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int dep
         case kCustomColor:
         case kThreeColor:
 		{
-			// Allocate memory for stroke style value string
-			std::string strokeStyleValue;
-
-			// Get the stroke color value
-			strokeStyleValue = GetColor(strokeStyle.color, 1.0f);
-
 			// Is the stroke color different?
 			if (strokeStyleValue != currentState->strokeStyle)
 			{
@@ -1788,7 +1560,7 @@ void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int dep
 				currentState->strokeStyle = strokeStyleValue;
 
 				// Change the stroke style
-				outFile << "\n" << Indent(depth) << contextName << ".strokeStyle = " << currentState->strokeStyle << ";";
+				commands.StrokeStyle(depth, currentState->strokeStyle);
 			}
 			break;
 		}
@@ -1807,28 +1579,8 @@ void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int dep
 		// Assign new cap style
 		currentState->lineCap = strokeStyle.cap;
 
-		// Output new stroke style
-		switch (currentState->lineCap)
-		{
-			case (kAIButtCap): 
-			{
-				// Butt line caps
-				outFile << "\n" << Indent(depth) << contextName << ".lineCap = \"butt\";";
-				break;
-			}
-			case (kAIRoundCap): 
-			{
-				// Round line caps
-				outFile << "\n" << Indent(depth) << contextName << ".lineCap = \"round\";";
-				break;
-			}
-			case (kAIProjectingCap): 
-			{
-				// Projecting/square line caps 
-				outFile << "\n" << Indent(depth) << contextName << ".lineCap = \"square\";";
-				break;
-			}
-		}
+		// Output new cap style ("butt", "round", or "square")
+		commands.LineCap(depth, currentState->lineCap);
 	}
 
 
@@ -1839,39 +1591,20 @@ void Canvas::RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int dep
 		// Assign new join style
 		currentState->lineJoin = strokeStyle.join;
 
-		// Output new join style
-		switch (currentState->lineJoin)
-		{
-			case (kAIMiterJoin): 
-			{
-				// Miter line joins (the default join type)
-				outFile << "\n" << Indent(depth) << contextName << ".lineJoin = \"miter\";";
-
-				// Accomodate the miter limit (see NOTES to understand why this won't work) - set to "1" for now, which is basically the same as "Bevel"
-				// Although we don't include "Miter", since it's the default, we do need this hack ("10" is the canvas default)
-				// TODO: Report miter bug to IE9 team (Safari, Chrome, and Firefox work fine)
-				AIReal miterLimit = strokeStyle.miterLimit;
-				outFile << "\n" << Indent(depth) << contextName << ".miterLimit = " <<
-					setiosflags(ios::fixed) << setprecision(1) <<
-					miterLimit << ";";
+		// Output new join style ("miter", "round", or "bevel")
+		commands.LineJoin(depth, currentState->lineJoin);
 
-				// Assign new miter limit
-				currentState->miterLimit = miterLimit;
-
-				break;
-			}
-			case (kAIRoundJoin): 
-			{
-				// Round line joins
-				outFile << "\n" << Indent(depth) << contextName << ".lineJoin = \"round\";";
-				break;
-			}
-			case (kAIBevelJoin): 
-			{
-				// Bevel line joins
-				outFile << "\n" << Indent(depth) << contextName << ".lineJoin = \"bevel\";";
-				break;
-			}
+		// Miter line joins (the default join type)
+		if (currentState->lineJoin == kAIMiterJoin)
+		{
+			// Accomodate the miter limit (see NOTES to understand why this won't work) - set to "1" for now, which is basically the same as "Bevel"
+			// Although we don't include "Miter", since it's the default, we do need this hack ("10" is the canvas default)
+			// TODO: Report miter bug to IE9 team (Safari, Chrome, and Firefox work fine)
+			AIReal miterLimit = strokeStyle.miterLimit;
+			commands.MiterLimit(depth, miterLimit);
+
+			// Assign new miter limit
+			currentState->miterLimit = miterLimit;
 		}
 	}
 }
@@ -1884,124 +1617,76 @@ void Canvas::RenderTextFrameArt(AIArtHandle artHandle, unsigned int depth)
 
 void Canvas::RenderGlyphRuns(AIArtHandle textFrameArt, unsigned int depth)
 {
-	// Create ITextFrame object.
-	TextFrameRef textFrameRef = nullptr;
-	sAITextFrame->GetATETextFrame(textFrameArt, &textFrameRef);
-	ATE::ITextFrame frame(textFrameRef);
-
-	// Get the text frame matrix
-	AIRealMatrix textFrameMatrix;
-	textFrameMatrix = frame.GetMatrix();
+	// Get the text frame (its matrix, lines and glyph runs)
+	TextFrame textFrame;
+	artSource->GetTextFrame(textFrameArt, textFrame);
 
-	// Get the text lines
-	ATE::ITextLinesIterator lines = frame.GetTextLinesIterator();
-	while (lines.IsNotDone())
+	// Loop through the text lines
+	for (size_t line = 0; line < textFrame.lines.size(); line++)
 	{
-		ATE::ITextLine line = lines.Item();
-		ATE::IGlyphRunsIterator glyphRuns = line.GetGlyphRunsIterator();
+		const std::vector<GlyphRun>& glyphRuns = textFrame.lines[line].glyphRuns;
 
 		// Text for a set of glyph runs
-		char *text = (char *)malloc(1);
-		*text = '\0';
+		std::string text;
 
 		// Do we need to grab an origin?
 		// TODO: Seems messy...can we clean this logic up?
 		AIBoolean grabOrigin = true;
 
-		// Last glyph state so we can track changes
-		GlyphState lastGlyphState;
+		// Last glyph state so we can track changes (features that aren't assigned compare as zero)
+		GlyphState lastGlyphState = GlyphState();
 
-		// Loop through all glyph runs
-		while (glyphRuns.IsNotDone())
+		// Loop through all glyph runs (each has contents)
+		for (size_t run = 0; run < glyphRuns.size(); run++)
 		{
-			// Get next glyph run
-			ATE::IGlyphRun glyphRun = glyphRuns.Item();
+			// Get the state/style information for this glyph run
+			GlyphState glyphState = GlyphState();
+			GetGlyphState(glyphRuns[run], glyphState, textFrame.matrix, depth);
 
-			// Initialize state/style information for this run
-			GlyphState glyphState;
-			ASInt32 count = 0;
-			char *contents = nullptr;
-
-			// Any contents?
-			count = glyphRun.GetCharacterCount();
-			if (count > 0)
+			// We don't want to output every glyph run individually, so see if anything has changed that will force us to render
+			// TODO: We need a better way to handle this!
+			if (!GlyphStatesMatch(lastGlyphState, glyphState) && !grabOrigin)
 			{
-				// Get text contents of glyph run
-				contents = (char *)calloc(count + 1, sizeof(char));
-				glyphRun.GetContents(contents, count);
-
-				// Get the state/style information for this glyph run
-				// TODO: Remember to clear the memory from this instance
-				GetGlyphState(glyphRun, glyphState, textFrameMatrix, depth);
+				// Output
+				RenderGlyphRun(text, lastGlyphState, depth);
 
-				// We don't want to output every glyph run individually, so see if anything has changed that will force us to render
-				// TODO: We need a better way to handle this!
-				if (!GlyphStatesMatch(lastGlyphState, glyphState) && !grabOrigin)
-				{
-					// Output
-					RenderGlyphRun(text, lastGlyphState, depth);
-
-					// Since we've rendered this text, clear it
-					text = (char *)realloc(text, 1);
-					*text = '\0';
-
-					// Also need to capture a new origin
-					grabOrigin = true;
-				}
+				// Since we've rendered this text, clear it
+				text.clear();
 
-				// Add current contents
-				size_t length = strlen(text) + strlen(contents) + 1;
-				text = (char *)realloc(text, length);
-#ifdef MAC_ENV
-				strcat(text, contents);
-#endif
-#ifdef WIN_ENV
-				strcat_s(text, length, contents);
-#endif
+				// Also need to capture a new origin
+				grabOrigin = true;
+			}
 
-				// Remember last state
-				// TODO: Do strings copy okay here?
-				AIReal oldTx = lastGlyphState.glyphMatrix.tx;
-				AIReal oldTy = lastGlyphState.glyphMatrix.ty;
-				lastGlyphState = glyphState;
+			// Add current contents
+			text += glyphRuns[run].contents;
 
-				// Carry forward the initial origin, but only if we don't need to capture the origin (where we initially capture it)
-				if (!grabOrigin)
-				{
-					lastGlyphState.glyphMatrix.tx = oldTx;
-					lastGlyphState.glyphMatrix.ty = oldTy;
-				}
+			// Remember last state
+			AIReal oldTx = lastGlyphState.glyphMatrix.tx;
+			AIReal oldTy = lastGlyphState.glyphMatrix.ty;
+			lastGlyphState = glyphState;
 
-				// No longer the first pass
-				grabOrigin = false;
-
-				// Release memory
-				free(contents);
-				contents = nullptr;
+			// Carry forward the initial origin, but only if we don't need to capture the origin (where we initially capture it)
+			if (!grabOrigin)
+			{
+				lastGlyphState.glyphMatrix.tx = oldTx;
+				lastGlyphState.glyphMatrix.ty = oldTy;
 			}
 
-			// Get the next glyph run
-			glyphRuns.Next();
+			// No longer the first pass
+			grabOrigin = false;
 		}
 
 		// Do we have any text yet to render?
-		if (strlen(text) > 0)
+		if (text.length() > 0)
 		{
 			// Render it
 			RenderGlyphRun(text, lastGlyphState, depth);
 		}
-
-		// Release memory
-		free(text);
-		text = nullptr;
-
-		// Get the next line
-		lines.Next();
 	}
 }
 
 // Output the actual glyph run
-void Canvas::RenderGlyphRun(char *contents, const GlyphState& glyphState, unsigned int depth)
+void Canvas::RenderGlyphRun(const std::string& contents, const GlyphState& glyphState, unsigned int depth)
 {
 	// Have any font attributes changed?
 	if (glyphState.fontSize != currentState->fontSize ||
@@ -2009,12 +1694,12 @@ void Canvas::RenderGlyphRun(char *contents, const GlyphState& glyphState, unsign
 		glyphState.fontStyleName != currentState->fontStyleName)
 	{
 		// Output font and style information
-		outFile << "\n" << Indent(depth) << contextName << ".font = \"";
+		commands.Text() << "\n" << Indent(depth) << contextName << ".font = \"";
 		if (glyphState.fontStyleName != "Regular")
 		{
-			outFile << glyphState.fontStyleName << " ";
+			commands.Text() << glyphState.fontStyleName << " ";
 		}
-		outFile << setiosflags(ios::fixed) << setprecision(1) << glyphState.fontSize << "px '" << glyphState.fontName << "'\";";
+		commands.Text() << Fixed<1>(glyphState.fontSize) << "px '" << glyphState.fontName << "'\";";
 
 		// Remember current font state
 		currentState->fontSize = glyphState.fontSize;
@@ -2031,9 +1716,7 @@ void Canvas::RenderGlyphRun(char *contents, const GlyphState& glyphState, unsign
 		SetContextDrawingState(depth);
 
 		// Render transform
-		outFile << "\n" << Indent(depth) << contextName << ".transform(";
-		RenderTransform(glyphState.glyphMatrix);
-		outFile << ");";
+		commands.Transform(depth, glyphState.glyphMatrix);
 	}
 
 	// Fill the text?
@@ -2046,16 +1729,14 @@ void Canvas::RenderGlyphRun(char *contents, const GlyphState& glyphState, unsign
 		if (isTransformed)
 		{
 			// Allow transformation to position text
-			outFile << "\n" << Indent(depth) << contextName << ".fillText(\"" << contents << "\", " <<
-				setiosflags(ios::fixed) << setprecision(1) <<
+			commands.Text() << "\n" << Indent(depth) << contextName << ".fillText(\"" << contents << "\", " <<
 				0 << ", " << 0 << ");";
 		}
 		else
 		{
 			// Since there's no transformation, simply output text at correct point
-			outFile << "\n" << Indent(depth) << contextName << ".fillText(\"" << contents << "\", " <<
-				setiosflags(ios::fixed) << setprecision(1) <<
-				glyphState.glyphMatrix.tx << ", " << glyphState.glyphMatrix.ty << ");";
+			commands.Text() << "\n" << Indent(depth) << contextName << ".fillText(\"" << contents << "\", " <<
+				Fixed<1>(glyphState.glyphMatrix.tx) << ", " << Fixed<1>(glyphState.glyphMatrix.ty) << ");";
 		}
 	}
 
@@ -2069,16 +1750,14 @@ void Canvas::RenderGlyphRun(char *contents, const GlyphState& glyphState, unsign
 		if (isTransformed)
 		{
 			// Allow transformation to position text
-			outFile << "\n" << Indent(depth) << contextName << ".strokeText(\"" << contents << "\", " <<
-				setiosflags(ios::fixed) << setprecision(1) <<
+			commands.Text() << "\n" << Indent(depth) << contextName << ".strokeText(\"" << contents << "\", " <<
 				0 << ", " << 0 << ");";
 		}
 		else
 		{
 			// Since there's no transformation, simply output text at correct point
-			outFile << "\n" << Indent(depth) << contextName << ".strokeText(\"" << contents << "\", " <<
-				setiosflags(ios::fixed) << setprecision(1) <<
-				glyphState.glyphMatrix.tx << ", " << glyphState.glyphMatrix.ty << ");";
+			commands.Text() << "\n" << Indent(depth) << contextName << ".strokeText(\"" << contents << "\", " <<
+				Fixed<1>(glyphState.glyphMatrix.tx) << ", " << Fixed<1>(glyphState.glyphMatrix.ty) << ");";
 		}
 	}
 
@@ -2118,328 +1797,109 @@ AIBoolean Canvas::GlyphStatesMatch(const GlyphState& state1, const GlyphState& s
 }
 
 // Gets all of the important state information for a glyph run
-void Canvas::GetGlyphState(const ATE::IGlyphRun& glyphRun, GlyphState& glyphState, const AIRealMatrix& textFrameMatrix, unsigned int depth)
+void Canvas::GetGlyphState(const GlyphRun& glyphRun, GlyphState& glyphState, const AIRealMatrix& textFrameMatrix, unsigned int depth)
 {
-	// Get character features
-	ATE::ICharFeatures features = glyphRun.GetCharFeatures();
-
-	// To test for local feature assignments
-	bool isAssigned = false;
-
 	// Get font size
 	// TODO: Is there ever a case when the font size *isn't* assigned? What's the default in that situation?
-	glyphState.fontSize = features.GetFontSize(&isAssigned);
+	glyphState.fontSize = glyphRun.fontSize;
 
 	// Get font info
-	ATE::IFont font = features.GetFont(&isAssigned);
-	if (isAssigned)
+	if (glyphRun.hasFont)
 	{
-		// Allocate memory for font names and styles
-		char *systemFontName = (char*)calloc(1024, sizeof(char));
-		char *fontStyleName = (char*)calloc(1024, sizeof(char));
-
-		// Local font is assigned
-		FontRef fontRef = font.GetRef();
-		AIFontKey fontKey = nullptr;
-		sAIFont->FontKeyFromFont(fontRef, &fontKey);
-
 		// Get system font name
 		// TODO: Note that this may be Windows-specific...need to figure out the Apple equivalent
-		sAIFont->GetSystemFontName(fontKey, systemFontName, 1024);
 		if (debug)
 		{
-			outFile << "\n" << Indent(depth) << "// Font system name: " << systemFontName;
+			commands.Text() << "\n" << Indent(depth) << "// Font system name: " << glyphRun.fontName;
 		}
 
 		// Determine font variant
-		sAIFont->GetFontStyleName(fontKey, fontStyleName, 1024);
 		if (debug)
 		{
-			outFile << "\n" << Indent(depth) << "// Font style name: " << fontStyleName;
+			commands.Text() << "\n" << Indent(depth) << "// Font style name: " << glyphRun.fontStyleName;
 		}
 
 		// Copy to glyph state
-		glyphState.fontName = std::string(systemFontName);
-		glyphState.fontStyleName = std::string(fontStyleName);
-
-		// Release memory
-		free(systemFontName);
-		systemFontName = nullptr;
-		free(fontStyleName);
-		fontStyleName = nullptr;
+		glyphState.fontName = glyphRun.fontName;
+		glyphState.fontStyleName = glyphRun.fontStyleName;
 	}
 
-	// Is there a vertical scale?
-	glyphState.verticalScale = features.GetVerticalScale(&isAssigned);
-	if (!isAssigned)
-	{
-		// No vertical scaling
-		glyphState.verticalScale = 1.0f;
-	}
-
-	// Is there a horizontal scale?
-	glyphState.horizontalScale = features.GetHorizontalScale(&isAssigned);
-	if (!isAssigned)
-	{
-		// No horizontal scaling
-		glyphState.horizontalScale = 1.0f;
-	}
+	// Scaling (1.0 if not assigned)
+	glyphState.verticalScale = glyphRun.verticalScale;
+	glyphState.horizontalScale = glyphRun.horizontalScale;
 
 	// Get the matrix for this glyph run
-	glyphState.glyphMatrix = glyphRun.GetMatrix();
+	glyphState.glyphMatrix = glyphRun.matrix;
 
-	// Get character origin points array
-	// Since we only use the first origin, no need to check array size
 	// NOTE: Only use the first origin, since canvas doesn't support advanced character spacing (like Illustrator),
 	//       and we choose to be programmable over being pixel-accurate. This behavior could easily be modified, however.
-	ATE::IArrayRealPoint glyphOrigins = glyphRun.GetOrigins();
-
-	// Glyph origin
-	AIRealPoint glyphOrigin;
-
-	// Get first origin offset for this glyph (no need to pull for each character)
-	glyphOrigin = glyphOrigins.Item(0);
+	AIRealPoint glyphOrigin = glyphRun.origin;
 
 	// Apply scaling
-	sAIRealMath->AIRealMatrixConcatScale(&glyphState.glyphMatrix, glyphState.horizontalScale, glyphState.verticalScale);
+	RealMatrixConcatScale(&glyphState.glyphMatrix, glyphState.horizontalScale, glyphState.verticalScale);
 
 	// Concat by [1 0 0 -1 0 0] as text coordinates are going positive the other direction.
 	AIRealMatrix flipY = 
 	{
 		1, 0, 0,  - 1, 0, 0
 	};
-	sAIRealMath->AIRealMatrixConcat(&flipY, &glyphState.glyphMatrix, &glyphState.glyphMatrix);
+	RealMatrixConcat(&flipY, &glyphState.glyphMatrix, &glyphState.glyphMatrix);
 
 	// Translate the origin
-	sAIRealMath->AIRealMatrixConcatTranslate(&glyphState.glyphMatrix, glyphOrigin.h, glyphOrigin.v);
+	RealMatrixConcatTranslate(&glyphState.glyphMatrix, glyphOrigin.h, glyphOrigin.v);
 
 	// Concatenate glyph matrix with text frame matrix
-	sAIRealMath->AIRealMatrixConcat(&glyphState.glyphMatrix, &textFrameMatrix, &glyphState.glyphMatrix);
+	RealMatrixConcat(&glyphState.glyphMatrix, &textFrameMatrix, &glyphState.glyphMatrix);
 
 	// ATE space is application independent, and doesn't know about this Illustrator soft/hard coordinate thingy, so take care of it here
-	sAIHardSoft->AIRealMatrixRealSoft(&glyphState.glyphMatrix);
+	artSource->AIRealMatrixRealSoft(&glyphState.glyphMatrix);
 
 	// Modify with our internal transform
-	sAIRealMath->AIRealMatrixConcat(&glyphState.glyphMatrix, &currentState->internalTransform, &glyphState.glyphMatrix);
+	RealMatrixConcat(&glyphState.glyphMatrix, &currentState->internalTransform, &glyphState.glyphMatrix);
 
 	// Is the text filled?
 	glyphState.fillStyle = "";		// In case we don't have a fill style
 	glyphState.textFilled = false;
-	AIBoolean hasFill = features.GetFill(&isAssigned);
-	if (isAssigned && hasFill)
+	if (glyphRun.hasFill)
 	{
-		// What color?
-		ATE::IApplicationPaint ATEfillColor = features.GetFillColor(&isAssigned);
-		if (isAssigned)
-		{
-			// We have enough information to fill the text
-			glyphState.textFilled = true;
-
-			// Get as AIColor
-			sATEPaint->GetAIColor(ATEfillColor.GetRef(), &glyphState.fillColor);
+		// We have enough information to fill the text
+		glyphState.textFilled = true;
+		glyphState.fillColor = glyphRun.fillColor;
 
-			// Allocate memory for fill style value string
-			GetFillStyle(glyphState.fillColor, 1.0f, glyphState.fillStyle);
-		}
+		// Allocate memory for fill style value string
+		GetFillStyle(glyphState.fillColor, 1.0f, glyphState.fillStyle);
 	}
 
 	// Is the text stroked?
 	glyphState.strokeStyle = "";		// In case we don't have a stroke style
 	glyphState.textStroked = false;
-	AIBoolean hasStroke = features.GetStroke(&isAssigned);
-	if (isAssigned && hasStroke)
+	if (glyphRun.hasStroke)
 	{
-		// What color?
-		ATE::IApplicationPaint ATEstrokeColor = features.GetStrokeColor(&isAssigned);
-		if (isAssigned)
-		{
-			// We have enough information to stroke the text
-			glyphState.textStroked = true;
+		// We have enough information to stroke the text
+		glyphState.textStroked = true;
+		glyphState.strokeStyleValue.color = glyphRun.strokeColor;
 
-			// Get as AIColor
-			sATEPaint->GetAIColor(ATEstrokeColor.GetRef(), &glyphState.strokeStyleValue.color);
+		// Get stroke style
+		GetFillStyle(glyphState.strokeStyleValue.color, 1.0f, glyphState.strokeStyle);
 
-			// Get stroke style
-			GetFillStyle(glyphState.strokeStyleValue.color, 1.0f, glyphState.strokeStyle);
-
-			// Stroke width
-			AIReal strokeWidth = features.GetLineWidth(&isAssigned);
-			if (isAssigned)
-			{
-				// Assign stroke width
-				glyphState.strokeStyleValue.width = strokeWidth;
-			}
-
-			// Line cap
-			ATE::LineCapType lineCapType = features.GetLineCap(&isAssigned);
-			if (isAssigned)
-			{
-				// Assign line cap (NOTE: LineCapType and AILineCap enumerations are identical)
-				glyphState.strokeStyleValue.cap = (AILineCap)lineCapType;
-			}
-
-			// Line join
-			ATE::LineJoinType lineJoinType = features.GetLineJoin(&isAssigned);
-			if (isAssigned)
-			{
-				// Assign line join (NOTE: LineJoinType and AILineJoin enumerations are identical)
-				glyphState.strokeStyleValue.join = (AILineJoin)lineJoinType;
-			}
+		// Stroke width
+		if (glyphRun.hasLineWidth)
+		{
+			// Assign stroke width
+			glyphState.strokeStyleValue.width = glyphRun.lineWidth;
 		}
-	}
-}
-
-void Canvas::ReportGlyphRunInfo(const ATE::IGlyphRun& glyphRun)
-{
-	// Get distance to baseline
-	AIReal distanceToBaseline = glyphRun.GetDistanceToBaseline();
-	if (debug)
-	{
-		outFile << "\n\n// Distance to baseline: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			distanceToBaseline;
-	}
-
-	// Get ascent
-	AIReal ascent = glyphRun.GetAscent();
-	if (debug)
-	{
-		outFile << "\n// Ascent: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			ascent;
-	}
 
-	// Get descent
-	AIReal descent = glyphRun.GetDescent();
-	if (debug)
-	{
-		outFile << "\n// Descent: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			descent;
-	}
-
-	// Get max cap height
-	AIReal maxCapHeight = glyphRun.GetMaxCapHeight();
-	if (debug)
-	{
-		outFile << "\n// Max cap height: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			maxCapHeight;
-	}
-
-	// Get min cap height
-	AIReal minCapHeight = glyphRun.GetMinCapHeight();
-	if (debug)
-	{
-		outFile << "\n// Min cap height: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			minCapHeight;
-	}
-
-	// Get tracking
-	AIReal tracking = glyphRun.GetTracking();
-	if (debug)
-	{
-		outFile << "\n// Tracking: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			tracking;
-	}
-}
-
-void Canvas::ReportCharacterFeatures(const ATE::ICharFeatures& features)
-{
-	// To test for local feature assignments
-	bool isAssigned = false;
-
-	// Get horizontal scale
-	AIReal horizontalScale = features.GetHorizontalScale(&isAssigned);
-	if (!isAssigned)
-	{
-		horizontalScale = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n\n// Horizontal scale: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			horizontalScale;
-	}
-
-	// Get vertical scale
-	AIReal verticalScale = features.GetVerticalScale(&isAssigned);
-	if (!isAssigned)
-	{
-		verticalScale = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Vertical scale: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			verticalScale;
-	}
-
-	// Get leading
-	AIReal leading = features.GetLeading(&isAssigned);
-	if (!isAssigned)
-	{
-		leading = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Leading: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			leading;
-	}
-
-	// Get tracking
-	ASInt32 tracking = features.GetTracking(&isAssigned);
-	if (!isAssigned)
-	{
-		tracking = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Tracking: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			tracking;
-	}
-
-	// Get baseline shift
-	AIReal baselineShift = features.GetBaselineShift(&isAssigned);
-	if (!isAssigned)
-	{
-		baselineShift = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Baseline shift: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			baselineShift;
-	}
-
-	// Get character rotation
-	AIReal characterRotation = features.GetCharacterRotation(&isAssigned);
-	if (!isAssigned)
-	{
-		characterRotation = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Character rotation: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			characterRotation;
-	}
+		// Line cap
+		if (glyphRun.hasLineCap)
+		{
+			glyphState.strokeStyleValue.cap = glyphRun.lineCap;
+		}
 
-	// Get underline offset
-	AIReal underlineOffset = features.GetUnderlineOffset(&isAssigned);
-	if (!isAssigned)
-	{
-		underlineOffset = 0;
-	}
-	if (debug)
-	{
-		outFile << "\n// Underline offset: " <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			underlineOffset;
+		// Line join
+		if (glyphRun.hasLineJoin)
+		{
+			glyphState.strokeStyleValue.join = glyphRun.lineJoin;
+		}
 	}
 }
 
@@ -2451,133 +1911,70 @@ std::string Canvas::GetColor(const AIColor& color, AIReal alpha)
 	AIColor rgbColor;
 	ConvertColorToRGB(color, rgbColor);
 
-	// Stream for color string
-	std::ostringstream colorValue;
+	return GetRGBColor(rgbColor, alpha);
+}
+
+// Returns a color value string for a color that's already been converted to RGB
+std::string Canvas::GetRGBColor(const AIColor& rgbColor, AIReal alpha)
+{
+	// Color string (built in place, rather than with a string stream)
+	std::string colorValue;
+	colorValue.reserve(32);
 
 	// Output color values
+	colorValue += (alpha != 1.0f) ? "\"rgba(" : "\"rgb(";
+	AppendInteger(colorValue, (int)(rgbColor.c.rgb.red * 255.0f));
+	colorValue += ", ";
+	AppendInteger(colorValue, (int)(rgbColor.c.rgb.green * 255.0f));
+	colorValue += ", ";
+	AppendInteger(colorValue, (int)(rgbColor.c.rgb.blue * 255.0f));
 	if (alpha != 1.0f)
 	{
 		// Include alpha
-		colorValue << "\"rgba(" << (int)(rgbColor.c.rgb.red * 255.0f) <<
-						   ", " << (int)(rgbColor.c.rgb.green * 255.0f) <<
-						   ", " << (int)(rgbColor.c.rgb.blue * 255.0f) <<
-						   ", " << setiosflags(ios::fixed) << setprecision(2) << alpha <<
-						   ")\"";
-	}
-	else
-	{
-		colorValue << "\"rgb(" << (int)(rgbColor.c.rgb.red * 255.0f) <<
-						   ", " << (int)(rgbColor.c.rgb.green * 255.0f) <<
-						   ", " << (int)(rgbColor.c.rgb.blue * 255.0f) <<
-						   ")\"";
+		colorValue += ", ";
+		AppendFixed<2>(colorValue, alpha);
 	}
+	colorValue += ")\"";
 	
 	// Return the color string
-	return colorValue.str();
+	return colorValue;
 }
 
 void Canvas::ConvertColorToRGB(const AIColor& sourceColor, AIColor& rbgColor)
 {
-	ai::int32 srcSpace = 0;
-	ai::int32 dstSpace = kAIRGBColorSpace;
-	SampleComponent srcColor[5];
-	SampleComponent dstColor[5];
-	ASBoolean inGamut;
-	AICustomColor customColor;
+	// Colors are converted once per export
+	documentResources->colors.ConvertToRGB(sourceColor, rbgColor);
+}
 
-	switch (sourceColor.kind)
-	{
-		case kGrayColor:
-		{
-			srcSpace = kAIGrayColorSpace;
-			srcColor[0] = (SampleComponent)(1.0f - sourceColor.c.g.gray); // !!!! Why do I have to invert? Seems wrong !!!!
-			break;
-		}
-		case kFourColor:
-		{
-			srcSpace = kAICMYKColorSpace;
-			srcColor[0] = (SampleComponent)sourceColor.c.f.cyan;
-			srcColor[1] = (SampleComponent)sourceColor.c.f.magenta;
-			srcColor[2] = (SampleComponent)sourceColor.c.f.yellow;
-			srcColor[3] = (SampleComponent)sourceColor.c.f.black;
-			break;
-		}
-		case (kCustomColor):
-		{
-			sAICustomColor->GetCustomColor(sourceColor.c.c.color, &customColor);
+void Canvas::TransformRect(AIRealRect& rect)
+{
+	// Transform upper-left and lower-right points together
+	AIReal x[2] = { rect.left, rect.right };
+	AIReal y[2] = { rect.top, rect.bottom };
 
-			// Convert custom color (why'd they make this different!?)
-			switch (customColor.kind)
-			{
-				case kCustomFourColor:
-				{
-					srcSpace = kAICMYKColorSpace;
-					srcColor[0] = (SampleComponent)customColor.c.f.cyan;
-					srcColor[1] = (SampleComponent)customColor.c.f.magenta;
-					srcColor[2] = (SampleComponent)customColor.c.f.yellow;
-					srcColor[3] = (SampleComponent)customColor.c.f.black;
-					break;
-				}
-				case kCustomThreeColor:
-				{
-					// Pretty pointless :)
-					srcSpace = kAIRGBColorSpace;
-					srcColor[0] = (SampleComponent)customColor.c.rgb.red;
-					srcColor[1] = (SampleComponent)customColor.c.rgb.green;
-					srcColor[2] = (SampleComponent)customColor.c.rgb.blue;
-					break;
-				}
-                case kCustomLabColor:
-                {
-                    break;
-                }
-			}
-			break;
-		}
-		case kThreeColor:
+	// If we're processing a symbol, we don't need to transform anything, since symbols are defined in their own coordinate space
+	if (currentState->isProcessingSymbol)
+	{
+		// Simply harden the points
+		for (size_t i = 0; i < 2; i++)
 		{
-			// Pretty pointless :)
-			srcSpace = kAIRGBColorSpace;
-			srcColor[0] = (SampleComponent)sourceColor.c.rgb.red;
-			srcColor[1] = (SampleComponent)sourceColor.c.rgb.green;
-			srcColor[2] = (SampleComponent)sourceColor.c.rgb.blue;
-			break;
+			AIRealPoint point;
+			point.h = x[i];
+			point.v = y[i];
+			artSource->AIRealPointHarden(&point, &point);
+			x[i] = point.h;
+			y[i] = point.v;
 		}
-        case kPattern:
-        case kGradient:
-        case kNoneColor:
-        case kAdvanceColor:
-        {
-            break;
-        }
+	}
+	else
+	{
+		TransformPoints(currentState->internalTransform, x, y, 2);
 	}
 
-	// Perform the color conversion
-	sAIColorConversion->ConvertSampleColor(srcSpace, srcColor, dstSpace, dstColor, AIColorConvertOptions::kForExport, &inGamut);
-
-	rbgColor.kind = kThreeColor;
-	rbgColor.c.rgb.red = dstColor[0];
-	rbgColor.c.rgb.green = dstColor[1];
-	rbgColor.c.rgb.blue = dstColor[2];
-}
-
-void Canvas::TransformRect(AIRealRect& rect)
-{
-	// Transform upper-left point
-	AIRealPoint upperLeftPoint;
-	upperLeftPoint.h = rect.left;
-	upperLeftPoint.v = rect.top;
-	TransformPoint(upperLeftPoint);
-	rect.left = upperLeftPoint.h;
-	rect.top = upperLeftPoint.v;
-
-	// Transform lower-right point
-	AIRealPoint lowerRightPoint;
-	lowerRightPoint.h = rect.right;
-	lowerRightPoint.v = rect.bottom;
-	TransformPoint(lowerRightPoint);
-	rect.right = lowerRightPoint.h;
-	rect.bottom = lowerRightPoint.v;
+	rect.left = x[0];
+	rect.right = x[1];
+	rect.top = y[0];
+	rect.bottom = y[1];
 }
 
 void Canvas::TransformPoint(AIRealPoint& point)
@@ -2592,22 +1989,29 @@ void Canvas::TransformPointWithMatrix(AIRealPoint& point, const AIRealMatrix& ma
 	// If we're processing a symbol, we don't need to transform anything, since symbols are defined in their own coordinate space
 	if (currentState->isProcessingSymbol)
 	{
-		// Simply harden the matrix
-		sAIHardSoft->AIRealPointHarden(&point, &point);
+		// Simply harden the point
+		artSource->AIRealPointHarden(&point, &point);
 	}
 	else
 	{
-		sAIRealMath->AIRealMatrixXformPoint(&matrix, &point, &point);
+		TransformPoints(matrix, &point.h, &point.v, 1);
 	}
 }
 
-void Canvas::AddBreadcrumb(const std::string& artName, unsigned int depth)
+void Canvas::AddBreadcrumb(uint32_t index, unsigned int depth)
 {
 	// Are we under the maximum breadcrumb count?
 	if (breadcrumbs.size() < MAX_BREADCRUMB_DEPTH)
 	{
-		// Copy the string
-		std::string cleanArtName = artName;
+		// Breadcrumbs aren't written to minified output (keep the depth balanced, but skip the work)
+		if (exportOptions.IsMinified())
+		{
+			breadcrumbs.push_back("");
+			return;
+		}
+
+		// Copy the art name (only looked up when breadcrumbs are written)
+		std::string cleanArtName = documentResources->artTable.Name(index);
 
 		// If this is at depth = 1, then make sure we clean any custom function names
 		if (depth == 1)
@@ -2628,17 +2032,19 @@ void Canvas::AddBreadcrumb(const std::string& artName, unsigned int depth)
 		// Output path and name
 		if (depth > 1)
 		{
-			outFile << "\n\n" << Indent(depth) << "// ";
+			std::string path;
 
 			// Loop through breadcrumbs
 			for (unsigned int i = 0; i < breadcrumbs.size(); i++)
 			{
 				if (i > 0)
 				{
-					outFile << "/";
+					path += "/";
 				}
-				outFile << breadcrumbs[i];
+				path += breadcrumbs[i];
 			}
+
+			commands.Breadcrumb(depth, path);
 		}
 	}
 }
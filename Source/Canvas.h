@@ -24,37 +24,20 @@
 #define CANVAS_H
 
 #include "IllustratorSDK.h"
-#include "Ai2CanvasSuites.h"
 #include "State.h"
 #include "Utility.h"
+#include "DrawCommands.h"
 #include <sstream>
 #include <stdint.h>
 #include "DocumentResources.h"
-
-// Accommodate color component type based on SDK version
-#if kPluginInterfaceVersion > kPluginInterfaceVersion16001
-	typedef AIFloatSampleComponent SampleComponent;
-#else
-	typedef AISampleComponent SampleComponent;
-#endif
+#include "RealMath.h"
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
-	// Drop shadow parameters
-	// NOTE: Should this move to State? That's where it is in the canvas spec.
-	struct DropShadow
-	{
-		AIReal			horz;						// Horizontal offset
-		AIReal			vert;						// Vertical offset
-		AIReal			blur;						// Blur amount
-		AIFillStyle		shadowStyle;				// Fill style
-		AIReal			opac;						// Opacity
-	};
-
 	// Handy structure to maintain glyph state
 	// TODO: Evaluate a better (cleaner) way to do this
 	struct GlyphState
@@ -91,6 +74,7 @@ namespace CanvasExport
 		AIPathStyle							pathfinderStyle;		// Style for PathFinder artwork
 		AIBoolean							usePathfinderStyle;		// Track special kPluginArt/Pathfinder style (seems "hacky")
 		std::vector<std::string>			breadcrumbs;			// Path to the artwork
+		DrawCommands						commands;				// Recorded drawing commands (written by RenderCommands)
 
 		Canvas(const std::string& id, DocumentResources* documentResources);
 		~Canvas();
@@ -99,50 +83,56 @@ namespace CanvasExport
 		void				PopState();
 		void				DebugInfo();
 
-		void				AddBreadcrumb(const std::string& artName, unsigned int depth);
+		void				AddBreadcrumb(uint32_t index, unsigned int depth);
 		void				RemoveBreadcrumb();
 
 		void				Render();
 		void				RenderImages();
+		void				RenderCommands();
+		void				RenderCommands(DrawCommands& recorded, OutputStream& stream);
 
 		void				RenderArt(AIArtHandle artHandle, unsigned int depth);
+		void				RenderArtNodes(uint32_t index, unsigned int depth);
 		void				ParseArtStyle(AIArtHandle artHandle, unsigned int depth, ASInt32& postEffectCount, 
 										  AIBlendingMode& blendingMode, AIBoolean& hasDropShadow, DropShadow& dropShadow);
 		void				SetContextDrawingState(unsigned int depth);
 		void				RenderDropShadow(const DropShadow& dropShadow, unsigned int depth);
 		void				RenderUnsupportedArt(AIArtHandle artHandle, const std::string& fileName, unsigned int depth);
-		void				RasterizeArtToPNG(AIArtHandle artHandle, const std::string& path);
 		void				GetPNGDimensions(const std::string& path, unsigned int& width, unsigned int& height);
 		uint32_t			ReverseInt(uint32_t i);
 		AIReal				GetJPGDPI(const std::string& path);
 		uint16_t			ReverseInt(uint16_t i);
 		void				ReportRasterRecordInfo(const AIRasterRecord& rasterRecord);
 		void				ReportColorSpaceInfo(ai::int16 colorSpace);
-		void				RenderGroupArt(AIArtHandle artHandle, unsigned int depth);
-		void				RenderPluginArt(AIArtHandle artHandle, unsigned int depth);
+		void				RenderGroupArt(uint32_t index, unsigned int depth);
+		void				RenderPluginArt(uint32_t index, unsigned int depth);
 		void				RenderSymbolArt(AIArtHandle artHandle, unsigned int depth);
-		void				RenderCompoundPathArt(AIArtHandle artHandle, unsigned int depth);
-		void				RenderPathArt(AIArtHandle artHandle, unsigned int depth);
+		void				RenderCompoundPathArt(uint32_t index, unsigned int depth);
+		void				RenderPathArt(uint32_t index, unsigned int depth);
 		void				RenderPathFigure(AIArtHandle artHandle, unsigned int depth);
-		void				RenderSegment(AIPathSegment& previousSegment, AIPathSegment& segment, unsigned int depth);
+		void				RenderSegment(const SegmentBuffer& segments, size_t previous, size_t current, unsigned int depth);
+		void				RenderPathStyle(uint32_t styleIndex, unsigned int depth);
 		void				RenderPathStyle(const AIPathStyle& style, unsigned int depth);
+		void				RenderPathStyle(const AIPathStyle& style, const std::string& fillStyle, const std::string& strokeStyle, unsigned int depth);
+		void				GetPathStyleStrings(const AIPathStyle& style, std::string& fillStyle, std::string& strokeStyle);
 		void				RenderPlacedArt(AIArtHandle artHandle, unsigned int depth);
 		void				RenderRasterArt(AIArtHandle artHandle, unsigned int depth);
-		void				RenderMidPointColor(const AIColor& color1, AIReal alpha1, const AIColor& color2, AIReal alpha2);
+		void				RenderMidPointColor(const AIColor& rgbColor1, AIReal alpha1, const AIColor& rgbColor2, AIReal alpha2);
 		void				RenderGradient(const AIGradientStyle& gradientStyle, unsigned int depth);
 		void				RenderGradientStops(const AIGradientStyle& gradientStyle, unsigned int depth);
 		void				RenderFillInfo(const AIColor& fillColor, unsigned int depth);
+		void				RenderFillInfo(const AIColor& fillColor, const std::string& fillStyle, unsigned int depth);
 		void				GetFillStyle(const AIColor& color, AIReal alpha, std::string& fillStyle);
 		void				ReportPatternStyleInfo(const AIPatternStyle& patternStyle);
 		void				RenderStrokeInfo(const AIStrokeStyle& strokeStyle, unsigned int depth);
+		void				RenderStrokeInfo(const AIStrokeStyle& strokeStyle, const std::string& strokeStyleValue, unsigned int depth);
 		void				RenderTextFrameArt(AIArtHandle artHandle, unsigned int depth);
 		void				RenderGlyphRuns(AIArtHandle textFrameArt, unsigned int depth);
-		void				RenderGlyphRun(char *contents, const GlyphState& glyphState, unsigned int depth);
+		void				RenderGlyphRun(const std::string& contents, const GlyphState& glyphState, unsigned int depth);
 		AIBoolean			GlyphStatesMatch(const GlyphState& state1, const GlyphState& state2);
-		void				GetGlyphState(const ATE::IGlyphRun& glyphRun, GlyphState& glyphState, const AIRealMatrix& textFrameMatrix, unsigned int depth);
-		void				ReportGlyphRunInfo(const ATE::IGlyphRun& glyphRun);
-		void				ReportCharacterFeatures(const ATE::ICharFeatures& features);
+		void				GetGlyphState(const GlyphRun& glyphRun, GlyphState& glyphState, const AIRealMatrix& textFrameMatrix, unsigned int depth);
 		std::string			GetColor(const AIColor& color, AIReal alpha);
+		std::string			GetRGBColor(const AIColor& rgbColor, AIReal alpha);
 		void				ConvertColorToRGB(const AIColor& sourceColor, AIColor& rbgColor);
 		void				TransformRect(AIRealRect& rect);
 		void				TransformPoint(AIRealPoint& point);
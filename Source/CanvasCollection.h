@@ -30,7 +30,7 @@
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a collection of canvases
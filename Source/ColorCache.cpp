@@ -0,0 +1,310 @@
+// ColorCache.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "ColorCache.h"
+#include <functional>
+
+using namespace CanvasExport;
+
+ColorCache::ColorCache()
+{
+	// Initialize ColorCache
+	this->conversions = 0;
+}
+
+ColorCache::~ColorCache()
+{
+}
+
+bool ColorCache::ColorKey::operator==(const ColorKey& key) const
+{
+	return (kind == key.kind &&
+			components[0] == key.components[0] &&
+			components[1] == key.components[1] &&
+			components[2] == key.components[2] &&
+			components[3] == key.components[3] &&
+			handle == key.handle);
+}
+
+size_t ColorCache::ColorKeyHash::operator()(const ColorKey& key) const
+{
+	size_t hash = std::hash<int>()(key.kind);
+	for (int i = 0; i < 4; i++)
+	{
+		hash = (hash * 31) ^ std::hash<AIReal>()(key.components[i]);
+	}
+	return ((hash * 31) ^ std::hash<const void*>()(key.handle));
+}
+
+// Convert a color to RGB (solid colors are only converted once per export)
+void ColorCache::ConvertToRGB(const AIColor& sourceColor, AIColor& rgbColor)
+{
+	rgbColor.kind = kThreeColor;
+
+	ColorKey key;
+	if (!MakeKey(sourceColor, key))
+	{
+		// Not a solid color
+		Convert(sourceColor, rgbColor.c.rgb);
+		return;
+	}
+
+	std::unordered_map<ColorKey, AIThreeColor, ColorKeyHash>::const_iterator color = colors.find(key);
+	if (color != colors.end())
+	{
+		rgbColor.c.rgb = color->second;
+		return;
+	}
+
+	Convert(sourceColor, rgbColor.c.rgb);
+	colors[key] = rgbColor.c.rgb;
+}
+
+// Convert a run of colors (like gradient stops)
+void ColorCache::ConvertToRGB(const AIColor* sourceColors, size_t count, AIColor* rgbColors)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		ConvertToRGB(sourceColors[i], rgbColors[i]);
+	}
+}
+
+// Key for a solid color (returns false for anything else)
+bool ColorCache::MakeKey(const AIColor& color, ColorKey& key) const
+{
+	key.kind = color.kind;
+	key.components[0] = key.components[1] = key.components[2] = key.components[3] = 0;
+	key.handle = nullptr;
+
+	switch (color.kind)
+	{
+		case kGrayColor:
+		{
+			key.components[0] = color.c.g.gray;
+			return true;
+		}
+		case kFourColor:
+		{
+			key.components[0] = color.c.f.cyan;
+			key.components[1] = color.c.f.magenta;
+			key.components[2] = color.c.f.yellow;
+			key.components[3] = color.c.f.black;
+			return true;
+		}
+		case kThreeColor:
+		{
+			key.components[0] = color.c.rgb.red;
+			key.components[1] = color.c.rgb.green;
+			key.components[2] = color.c.rgb.blue;
+			return true;
+		}
+		case kCustomColor:
+		{
+			// Custom colors are converted from their definition (the tint isn't used)
+			key.handle = color.c.c.color;
+			return true;
+		}
+		case kPattern:
+		case kGradient:
+		case kNoneColor:
+		case kAdvanceColor:
+		{
+			break;
+		}
+	}
+	return false;
+}
+
+void ColorCache::Convert(const AIColor& sourceColor, AIThreeColor& rgbColor)
+{
+	ai::int32 srcSpace = 0;
+	SampleComponent srcColor[5];
+	AICustomColor customColor;
+
+	switch (sourceColor.kind)
+	{
+		case kGrayColor:
+		{
+			srcSpace = kAIGrayColorSpace;
+			srcColor[0] = (SampleComponent)(1.0f - sourceColor.c.g.gray); // !!!! Why do I have to invert? Seems wrong !!!!
+			break;
+		}
+		case kFourColor:
+		{
+			srcSpace = kAICMYKColorSpace;
+			srcColor[0] = (SampleComponent)sourceColor.c.f.cyan;
+			srcColor[1] = (SampleComponent)sourceColor.c.f.magenta;
+			srcColor[2] = (SampleComponent)sourceColor.c.f.yellow;
+			srcColor[3] = (SampleComponent)sourceColor.c.f.black;
+			break;
+		}
+		case (kCustomColor):
+		{
+			artSource->GetCustomColor(sourceColor.c.c.color, &customColor);
+
+			// Convert custom color (why'd they make this different!?)
+			switch (customColor.kind)
+			{
+				case kCustomFourColor:
+				{
+					srcSpace = kAICMYKColorSpace;
+					srcColor[0] = (SampleComponent)customColor.c.f.cyan;
+					srcColor[1] = (SampleComponent)customColor.c.f.magenta;
+					srcColor[2] = (SampleComponent)customColor.c.f.yellow;
+					srcColor[3] = (SampleComponent)customColor.c.f.black;
+					break;
+				}
+				case kCustomThreeColor:
+				{
+					// Pretty pointless :)
+					srcSpace = kAIRGBColorSpace;
+					srcColor[0] = (SampleComponent)customColor.c.rgb.red;
+					srcColor[1] = (SampleComponent)customColor.c.rgb.green;
+					srcColor[2] = (SampleComponent)customColor.c.rgb.blue;
+					break;
+				}
+                case kCustomLabColor:
+                {
+                    break;
+                }
+			}
+			break;
+		}
+		case kThreeColor:
+		{
+			// Pretty pointless :)
+			srcSpace = kAIRGBColorSpace;
+			srcColor[0] = (SampleComponent)sourceColor.c.rgb.red;
+			srcColor[1] = (SampleComponent)sourceColor.c.rgb.green;
+			srcColor[2] = (SampleComponent)sourceColor.c.rgb.blue;
+			break;
+		}
+        case kPattern:
+        case kGradient:
+        case kNoneColor:
+        case kAdvanceColor:
+        {
+            break;
+        }
+	}
+
+	// Interpolate CMYK colors from the lookup table?
+	if (srcSpace == kAICMYKColorSpace && exportOptions.colorTable)
+	{
+		LookupCMYK(srcColor, rgbColor);
+	}
+	else
+	{
+		ConvertSamples(srcSpace, srcColor, rgbColor);
+	}
+}
+
+// Perform the color conversion
+void ColorCache::ConvertSamples(ai::int32 srcSpace, const SampleComponent* srcColor, AIThreeColor& rgbColor)
+{
+	SampleComponent dstColor[5];
+	ASBoolean inGamut;
+	artSource->ConvertSampleColor(srcSpace, srcColor, kAIRGBColorSpace, dstColor, &inGamut);
+	conversions++;
+
+	rgbColor.red = dstColor[0];
+	rgbColor.green = dstColor[1];
+	rgbColor.blue = dstColor[2];
+}
+
+// Sample the CMYK to RGB conversion on a regular grid
+void ColorCache::BuildTable()
+{
+	table.resize(kTableSize * kTableSize * kTableSize * kTableSize);
+
+	SampleComponent cmyk[5];
+	size_t index = 0;
+	for (int c = 0; c < kTableSize; c++)
+	{
+		for (int m = 0; m < kTableSize; m++)
+		{
+			for (int y = 0; y < kTableSize; y++)
+			{
+				for (int k = 0; k < kTableSize; k++)
+				{
+					cmyk[0] = (SampleComponent)c / (kTableSize - 1);
+					cmyk[1] = (SampleComponent)m / (kTableSize - 1);
+					cmyk[2] = (SampleComponent)y / (kTableSize - 1);
+					cmyk[3] = (SampleComponent)k / (kTableSize - 1);
+					ConvertSamples(kAICMYKColorSpace, cmyk, table[index++]);
+				}
+			}
+		}
+	}
+}
+
+// Interpolate (quadrilinearly) between the 16 surrounding table entries
+void ColorCache::LookupCMYK(const SampleComponent* cmyk, AIThreeColor& rgbColor)
+{
+	if (table.empty())
+	{
+		BuildTable();
+	}
+
+	int cell[4];
+	AIReal fraction[4];
+	for (int i = 0; i < 4; i++)
+	{
+		AIReal position = (AIReal)cmyk[i] * (kTableSize - 1);
+		if (position < 0)
+		{
+			position = 0;
+		}
+		else if (position > (kTableSize - 1))
+		{
+			position = (AIReal)(kTableSize - 1);
+		}
+
+		cell[i] = (int)position;
+		if (cell[i] == (kTableSize - 1))
+		{
+			cell[i]--;
+		}
+		fraction[i] = position - cell[i];
+	}
+
+	rgbColor.red = rgbColor.green = rgbColor.blue = 0;
+	for (int corner = 0; corner < 16; corner++)
+	{
+		AIReal weight = 1;
+		size_t index = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			int offset = (corner >> (3 - i)) & 1;
+			weight *= (offset ? fraction[i] : (1 - fraction[i]));
+			index = index * kTableSize + (cell[i] + offset);
+		}
+
+		if (weight > 0)
+		{
+			rgbColor.red += weight * table[index].red;
+			rgbColor.green += weight * table[index].green;
+			rgbColor.blue += weight * table[index].blue;
+		}
+	}
+}
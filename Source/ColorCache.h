@@ -0,0 +1,81 @@
+// ColorCache.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef COLORCACHE_H
+#define COLORCACHE_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <unordered_map>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Converts colors to RGB, remembering each conversion for the rest of the export
+	/// (CMYK colors can optionally be interpolated from a lookup table, rather than converted one at a time)
+	class ColorCache
+	{
+	private:
+
+		/// Color kind and components (or custom color handle)
+		struct ColorKey
+		{
+			int					kind;
+			AIReal				components[4];
+			const void*			handle;
+
+			bool				operator==(const ColorKey& key) const;
+		};
+
+		struct ColorKeyHash
+		{
+			size_t				operator()(const ColorKey& key) const;
+		};
+
+		static const int	kTableSize = 9;				// Samples per CMYK axis (lookup table has kTableSize^4 entries)
+
+		std::unordered_map<ColorKey, AIThreeColor, ColorKeyHash>	colors;
+		std::vector<AIThreeColor>	table;				// CMYK lookup table (built the first time it's needed)
+
+		bool				MakeKey(const AIColor& color, ColorKey& key) const;
+		void				Convert(const AIColor& sourceColor, AIThreeColor& rgbColor);
+		void				ConvertSamples(ai::int32 srcSpace, const SampleComponent* srcColor, AIThreeColor& rgbColor);
+		void				BuildTable();
+		void				LookupCMYK(const SampleComponent* cmyk, AIThreeColor& rgbColor);
+
+	public:
+
+		ColorCache();
+		~ColorCache();
+
+		size_t				conversions;				// Conversions that weren't already cached
+
+		void				ConvertToRGB(const AIColor& sourceColor, AIColor& rgbColor);
+		void				ConvertToRGB(const AIColor* sourceColors, size_t count, AIColor* rgbColors);
+	};
+}
+
+#endif
@@ -39,7 +39,7 @@ Document::Document(const std::string& pathName)
 	ParseFolderPath(pathName);
 
 	// Add a canvas for the primary document
-	this->canvas = canvases.Add("canvas", "ctx", &resources);
+	this->canvas = canvases.Add("canvas", exportOptions.ContextName(), &resources);
 }
 
 Document::~Document()
@@ -52,8 +52,78 @@ Document::~Document()
 	}
 }
 
+// Export the current art source to a file (with the output, trace and profile options that are set)
+// Every export (interactive, batch or regression) goes through here, so they all produce the same output
+bool Document::Export(const std::string& filePath, bool debugOutput, size_t* removedStatements)
+{
+	if (!OpenFile(filePath))
+	{
+		return false;
+	}
+
+	// Set debug mode
+	debug = debugOutput;
+
+	// Minify output?
+	outFile.SetMinify(exportOptions.IsMinified());
+
+	// Compress a copy while rendering?
+	if (exportOptions.gzip)
+	{
+		outFile.Compress(filePath + ".gz");
+	}
+
+	// Time export phases?
+	if (exportOptions.trace)
+	{
+		trace.Begin();
+	}
+
+	// Count and time suite calls?
+	if (exportOptions.profile)
+	{
+		artSource->BeginProfile();
+	}
+
+	// Create a new document
+	Document* document = new Document(filePath);
+
+	// Render the document
+	document->Render();
+	if (removedStatements)
+	{
+		*removedStatements = document->resources.removedStatements;
+	}
+
+	// Close the file
+	CloseFile();
+
+	// Write suite calls next to the exported file (each export replaces the folder's profile)
+	if (exportOptions.profile)
+	{
+		artSource->EndProfile(GetFolderPath(filePath) + "profile.txt");
+	}
+
+	// Write phase timings next to the exported file
+	if (exportOptions.trace)
+	{
+		trace.End();
+		trace.Write(GetFolderPath(filePath) + "trace.json");
+	}
+
+	// Delete document
+	delete document;
+
+	return true;
+}
+
 void Document::Render()
 {
+	TraceScope traceScope("Document::Render");
+
+	// Count what each art type and layer contributes (for the debug summary or the statistics file)
+	resources.statistics.Reset(debug || exportOptions.stats);
+
 	// Document type
 	outFile << "<!DOCTYPE html>";
 
@@ -159,6 +229,12 @@ void Document::Render()
 
 	// End of document
 	outFile << "\n</html>";
+
+	// Write statistics next to the exported file
+	if (exportOptions.stats)
+	{
+		resources.statistics.Write(resources.folderPath + fileName + ".stats.json");
+	}
 }
 
 // Set the bounds for the primary document
@@ -198,18 +274,16 @@ void Document::SetDocumentBounds()
 // Find the base folder path and filename
 void Document::ParseFolderPath(const std::string& pathName)
 {
-	// Construct a FilePath
-	ai::UnicodeString usPathName(pathName);
-	ai::FilePath aiFilePath(usPathName);
-
 	// Extract folder and file names
-	resources.folderPath = aiFilePath.GetDirectory(false).as_Platform();
-	fileName = aiFilePath.GetFileNameNoExt().as_Platform();
+	resources.folderPath = GetFolderPath(pathName);
+	fileName = GetFileNameNoExt(pathName);
 }
 
 // Parse the layers
 void Document::ParseLayers()
 {
+	TraceScope traceScope("Document::ParseLayers");
+
 	// Loop through all layers
 	for (unsigned int i = 0; i < layers.size(); i++)
 	{
@@ -378,6 +452,8 @@ void Document::ParseLayerName(const Layer& layer, std::string& name, std::string
 // Render the document
 void Document::RenderDocument()
 {
+	TraceScope traceScope("Document::RenderDocument");
+
 	// Set document bounds
 	SetDocumentBounds();
 
@@ -403,6 +479,16 @@ void Document::RenderDocument()
 		outFile <<   "\n      " << canvas->contextName << " = " << canvas->id << ".getContext(\"2d\");";
 	}
 
+	// Build paths (or decode geometry) before anything is drawn
+	if (exportOptions.GetEncoding() == ExportOptions::kEncodeTyped)
+	{
+		outFile << "\n\n      initGeometry();";
+	}
+	else if (exportOptions.IsPath2D())
+	{
+		outFile << "\n\n      initPaths();";
+	}
+
 	// Do we need a pattern function?
 	if (canvas->documentResources->patterns.HasPatterns())
 	{
@@ -502,6 +588,16 @@ void Document::RenderDocument()
 
 	// Render the pattern function
 	RenderPatternFunction();
+
+	// Render the paths or geometry (collected while rendering everything above)
+	if (exportOptions.GetEncoding() == ExportOptions::kEncodeTyped)
+	{
+		canvas->documentResources->geometry.Render();
+	}
+	else if (exportOptions.IsPath2D())
+	{
+		canvas->documentResources->paths.Render();
+	}
 }
 
 void Document::RenderAnimations()
@@ -610,22 +706,24 @@ void Document::SetFunctionOptions(const std::vector<std::string>& options, Funct
 //   Track if gradient fills are used by visible artwork per layer
 void Document::ScanDocument()
 {
+	TraceScope traceScope("Document::ScanDocument");
+
 	AILayerHandle layerHandle = nullptr;
 	ai::int32 layerCount = 0;
 
 	// How many layers in this document?
-	sAILayer->CountLayers(&layerCount);
+	artSource->CountLayers(&layerCount);
 
 	// Loop through all layers backwards
 	// We loop backwards, since the HTML5 canvas element uses a "painter model"
 	for (ai::int32 i = (layerCount - 1); i > -1; i--)
 	{
 		// Get a reference to the layer
-		sAILayer->GetNthLayer(i, &layerHandle);
+		artSource->GetNthLayer(i, &layerHandle);
 
 		// Is the layer visible?
 		AIBoolean isLayerVisible = false;
-		sAILayer->GetLayerVisible(layerHandle, &isLayerVisible);
+		artSource->GetLayerVisible(layerHandle, &isLayerVisible);
 		if (debug)
 		{
 			outFile << "\n\n// Layer visible = " << isLayerVisible;
@@ -645,9 +743,11 @@ void Document::ScanDocument()
 
 void Document::ScanLayer(Layer& layer)
 {
+	TraceScope traceScope("Document::ScanLayer", layer.name);
+
 	// Get the first art in this layer
 	AIArtHandle artHandle = nullptr;
-	sAIArt->GetFirstArtOfLayer(layer.layerHandle, &artHandle);
+	artSource->GetFirstArtOfLayer(layer.layerHandle, &artHandle);
 
 	// Remember artwork handle
 	layer.artHandle = artHandle;
@@ -659,35 +759,39 @@ void Document::ScanLayer(Layer& layer)
 // Scans a layer's artwork tree to capture important data
 void Document::ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer& layer)
 {
+	// Capture the artwork in the art table, so rendering doesn't have to ask for it again
+	uint32_t index = canvas->documentResources->artTable.AddChain(artHandle);
+
+	ScanArtNodes(index, depth, layer);
+}
+
+// Scans captured artwork (and its children)
+void Document::ScanArtNodes(uint32_t index, unsigned int depth, Layer& layer)
+{
+	ArtTable& artTable = canvas->documentResources->artTable;
+
 	// Loop through all artwork at this depth
-	do
+	while (index != ArtTable::kNone)
 	{
-		// Is this art visible?
-		AIBoolean isArtVisible = false;
-		ai::int32 attr = 0;
-		sAIArt->GetArtUserAttr(artHandle, kArtHidden, &attr);
-		isArtVisible = !((attr &kArtHidden) == kArtHidden);
+		// Copy the node (capturing symbol artwork can grow the table)
+		ArtNode node = artTable.Node(index);
+		AIArtHandle artHandle = node.handle;
 
 		// Only consider if art is visible
-		if (isArtVisible)
+		if (!(node.flags & ArtTable::kNodeHidden))
 		{
-			// Get the art bounds
-			AIRealRect artBounds;
-			sAIArt->GetArtBounds(artHandle, &artBounds);
-
 			// Update the bounds
-			UpdateBounds(artBounds, layer.bounds);
+			UpdateBounds(node.bounds, layer.bounds);
 
 			// Get type
-			short type = 0;
-			sAIArt->GetArtType(artHandle, &type);
+			short type = node.type;
 
 			// Is this symbol art?
 			if (type == kSymbolArt)
 			{
 				// Get the symbol pattern
 				AIPatternHandle symbolPatternHandle = nullptr;
-				sAISymbol->GetSymbolPatternOfSymbolArt(artHandle, &symbolPatternHandle);
+				artSource->GetSymbolPatternOfSymbolArt(artHandle, &symbolPatternHandle);
 
 				// Add the symbol pattern
 				bool added = canvas->documentResources->patterns.Add(symbolPatternHandle, true);
@@ -696,7 +800,7 @@ void Document::ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer
 				if (added)
 				{
 					AIArtHandle patternArtHandle = nullptr;
-					sAIPattern->GetPatternArt(symbolPatternHandle, &patternArtHandle);
+					artSource->GetPatternArt(symbolPatternHandle, &patternArtHandle);
 
 					// Look inside, but don't screw up bounds for our current layer
 					Layer symbolLayer;
@@ -713,18 +817,18 @@ void Document::ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer
 			{
 				// Get the result art handle
 				AIArtHandle resultArtHandle = nullptr;
-				sAIPluginGroup->GetPluginArtResultArt(artHandle, &resultArtHandle);
+				artSource->GetPluginArtResultArt(artHandle, &resultArtHandle);
 
 				// Get the first art element in the result group
 				AIArtHandle childArtHandle = nullptr;
-				sAIArt->GetArtFirstChild(resultArtHandle, &childArtHandle);
+				artSource->GetArtFirstChild(resultArtHandle, &childArtHandle);
 
 				// Look inside the result group
 				ScanLayerArtwork(childArtHandle, (depth + 1), layer);
 			}
 
 			// Get opacity
-			AIReal opacity = sAIBlendStyle->GetOpacity(artHandle);
+			AIReal opacity = node.opacity;
 			if (opacity != 1.0f)
 			{
 				// Flag that this layer includes alpha/opacity changes
@@ -732,9 +836,7 @@ void Document::ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer
 			}
 
 			// Get the style for this artwork
-			AIPathStyle style;
-			AIBoolean outHasAdvFill = false;
-			sAIPathStyle->GetPathStyle(artHandle, &style, &outHasAdvFill);
+			const AIPathStyle& style = artTable.styles.Style(node.style);
 
 			// Does this artwork use a pattern fill or a gradient?
 			if (style.fillPaint)
@@ -800,27 +902,24 @@ void Document::ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer
 				}
 			}
 
-			// See if this artwork has any children
-			AIArtHandle childArtHandle = nullptr;
-			sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
-
-			// Did we find anything?
-			if (childArtHandle)
+			// Did we find any children?
+			if (node.child != ArtTable::kNone)
 			{
 				// Scan artwork at the next depth
-				ScanLayerArtwork(childArtHandle, (depth + 1), layer);
+				ScanArtNodes(node.child, (depth + 1), layer);
 			}
 		}
 
 		// Find the next sibling
-		sAIArt->GetArtSibling(artHandle, &artHandle);
+		index = node.sibling;
 	}
-	while (artHandle != nullptr);
 }
 
 // Creates the JavaScript animation file (if it doesn't already exist)
 void Document::CreateAnimationFile()
 {
+	TraceScope traceScope("Document::CreateAnimationFile");
+
 	// Full path to JavaScript animation support file
 	std::string fullPath = resources.folderPath + "Ai2CanvasAnimation.js";
 
@@ -851,6 +950,12 @@ void Document::CreateAnimationFile()
 		// Close the file
 		animFile.close();
 	}
+
+	// Precompressed copy (if it doesn't already exist)
+	if (exportOptions.gzip && !FileExists(fullPath + ".gz"))
+	{
+		CompressFile(fullPath, fullPath + ".gz");
+	}
 }
 
 void Document::OutputScriptHeader(ofstream& file)
@@ -1417,7 +1522,7 @@ void Document::RenderSymbolFunctions()
 				Pattern* pattern = canvas->documentResources->patterns.Patterns()[i];
 
 				// Begin symbol function block
-				outFile << "\n\n    function " << pattern->name << "(ctx) {";
+				outFile << "\n\n    function " << pattern->name << "(" << exportOptions.ContextName() << ") {";
 
 				// Need a blank line?
 				if (pattern->hasAlpha || pattern->hasGradients || pattern->hasPatterns)
@@ -1429,7 +1534,7 @@ void Document::RenderSymbolFunctions()
 				if (pattern->hasAlpha)
 				{
 					// Grab the alpha value (so we can use it to compute new globalAlpha values during this draw function)
-					outFile << "\n" << Indent(0) << "var alpha = ctx.globalAlpha;";
+					outFile << "\n" << Indent(0) << "var alpha = " << exportOptions.ContextName() << ".globalAlpha;";
 				}
 
 				// Will we be encountering gradients?
@@ -1447,30 +1552,30 @@ void Document::RenderSymbolFunctions()
 
 				// Get a handle to the pattern art
 				AIArtHandle patternArtHandle = nullptr;
-				sAIPattern->GetPatternArt(pattern->patternHandle, &patternArtHandle);
+				artSource->GetPatternArt(pattern->patternHandle, &patternArtHandle);
 
 				// While we're here, get the size of this canvas
 				AIRealRect bounds;
-				sAIArt->GetArtBounds(patternArtHandle, &bounds);
+				artSource->GetArtBounds(patternArtHandle, &bounds);
 				if (debug)
 				{
 					outFile << "\n\n" << Indent(0) << "// Symbol art bounds = " <<
-						"left:" << setiosflags(ios::fixed) << setprecision(1) << bounds.left <<
-						", top:" << bounds.top <<
-						", right:" << bounds.right <<
-						", bottom:" << bounds.bottom;
+						"left:" << Fixed<1>(bounds.left) <<
+						", top:" << Fixed<1>(bounds.top) <<
+						", right:" << Fixed<1>(bounds.right) <<
+						", bottom:" << Fixed<1>(bounds.bottom);
 				}
 
 				// Create canvas and set size
 				Canvas* symbolCanvas = new Canvas("canvas", &resources);			// No need to add it to the collection, since it doesn't represent a canvas element
-				symbolCanvas->contextName = "ctx";
+				symbolCanvas->contextName = exportOptions.ContextName();
 				symbolCanvas->width = bounds.right - bounds.left;
 				symbolCanvas->height = bounds.top - bounds.bottom;
 				symbolCanvas->currentState->isProcessingSymbol = true;
 
 				// Get the first art element in the symbol
 				AIArtHandle childArtHandle = nullptr;
-				sAIArt->GetArtFirstChild(patternArtHandle, &childArtHandle);
+				artSource->GetArtFirstChild(patternArtHandle, &childArtHandle);
 
 				// Render this sub-group
 				symbolCanvas->RenderArt(childArtHandle, 1);
@@ -1478,6 +1583,9 @@ void Document::RenderSymbolFunctions()
 				// Restore remaining state
 				symbolCanvas->SetContextDrawingState(1);
 
+				// Write the recorded drawing commands
+				symbolCanvas->RenderCommands();
+
 				// Free the canvas
 				delete symbolCanvas;
 
@@ -1503,16 +1611,16 @@ void Document::RenderPatternFunction()
 			if (!canvas->documentResources->patterns.Patterns()[i]->isSymbol)
 			{
 				// Allocate space for pattern name
-				ai::UnicodeString patternName;
+				std::string patternName;
 
 				// Pointer to pattern (for convenience)
 				Pattern* pattern = canvas->documentResources->patterns.Patterns()[i];
 
 				// Get pattern name
-				sAIPattern->GetPatternName(pattern->patternHandle, patternName);
+				artSource->GetPatternName(pattern->patternHandle, patternName);
 				if (debug)
 				{
-					outFile << "\n//   Pattern name = " << patternName.as_Platform() << " (" << pattern->patternHandle << ")";
+					outFile << "\n//   Pattern name = " << patternName << " (" << pattern->patternHandle << ")";
 				}
 
 				// Create canvas ID
@@ -1521,7 +1629,7 @@ void Document::RenderPatternFunction()
 
 				// Create context name
 				std::ostringstream contextName;
-				contextName << "ctx" << pattern->canvasIndex;
+				contextName << exportOptions.ContextName() << pattern->canvasIndex;
 
 				// Create canvas for this pattern
 				Canvas* patternCanvas = canvases.Add(canvasID.str(), contextName.str(), &resources);
@@ -1534,18 +1642,18 @@ void Document::RenderPatternFunction()
 
 				// Get a handle to the pattern art
 				AIArtHandle patternArtHandle = nullptr;
-				sAIPattern->GetPatternArt(pattern->patternHandle, &patternArtHandle);
+				artSource->GetPatternArt(pattern->patternHandle, &patternArtHandle);
 
 				// While we're here, get the size of this canvas
 				AIRealRect bounds;
-				sAIArt->GetArtBounds(patternArtHandle, &bounds);
+				artSource->GetArtBounds(patternArtHandle, &bounds);
 				if (debug)
 				{
 					outFile << "\n\n" << Indent(0) << "// Symbol art bounds = " <<
-						"left:" << setiosflags(ios::fixed) << setprecision(1) << bounds.left <<
-						", top:" << bounds.top <<
-						", right:" << bounds.right <<
-						", bottom:" << bounds.bottom;
+						"left:" << Fixed<1>(bounds.left) <<
+						", top:" << Fixed<1>(bounds.top) <<
+						", right:" << Fixed<1>(bounds.right) <<
+						", bottom:" << Fixed<1>(bounds.bottom);
 				}
 
 				// Set canvas size
@@ -1557,11 +1665,11 @@ void Document::RenderPatternFunction()
 				{
 					// Set internal transform
 					// TODO: While this works, it seems awfully convoluted
-					sAIRealMath->AIRealMatrixSetIdentity(&patternCanvas->currentState->internalTransform);
-					sAIRealMath->AIRealMatrixConcatScale(&patternCanvas->currentState->internalTransform, 1,  - 1);
-					sAIRealMath->AIRealMatrixConcatTranslate(&patternCanvas->currentState->internalTransform,  - 1 * bounds.left, bounds.top);
-					sAIRealMath->AIRealMatrixConcatScale(&patternCanvas->currentState->internalTransform, 1,  - 1);
-					sAIRealMath->AIRealMatrixConcatTranslate(&patternCanvas->currentState->internalTransform,  0, patternCanvas->height);
+					RealMatrixSetIdentity(&patternCanvas->currentState->internalTransform);
+					RealMatrixConcatScale(&patternCanvas->currentState->internalTransform, 1,  - 1);
+					RealMatrixConcatTranslate(&patternCanvas->currentState->internalTransform,  - 1 * bounds.left, bounds.top);
+					RealMatrixConcatScale(&patternCanvas->currentState->internalTransform, 1,  - 1);
+					RealMatrixConcatTranslate(&patternCanvas->currentState->internalTransform,  0, patternCanvas->height);
 				}
 
 				// This canvas shound be hidden, since it's only used for the pattern artwork
@@ -1569,13 +1677,16 @@ void Document::RenderPatternFunction()
 
 				// Get the first art element in the pattern
 				AIArtHandle childArtHandle = nullptr;
-				sAIArt->GetArtFirstChild(patternArtHandle, &childArtHandle);
+				artSource->GetArtFirstChild(patternArtHandle, &childArtHandle);
 
 				// Render this sub-group
 				patternCanvas->RenderArt(childArtHandle, 1);
 
 				// Restore remaining state
 				patternCanvas->SetContextDrawingState(1);
+
+				// Write the recorded drawing commands
+				patternCanvas->RenderCommands();
 			}
 		}
 
@@ -1596,6 +1707,8 @@ void Document::DebugInfo()
 	resources.images.DebugInfo();
 
 	functions.DebugInfo();
+
+	resources.statistics.DebugInfo();
 }
 
 void Document::DebugClockJS()
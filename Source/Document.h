@@ -24,19 +24,16 @@
 #define DOCUMENT_H
 
 #include "IllustratorSDK.h"
-#include "Ai2CanvasSuites.h"
 #include "Canvas.h"
 #include "CanvasCollection.h"
 #include "Layer.h"
 #include "DocumentResources.h"
 #include "FunctionCollection.h"
 
-AIBoolean			ProgressProc(long current, long total);
-
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a document
@@ -53,6 +50,7 @@ namespace CanvasExport
 		void				ScanDocument();
 		void				ScanLayer(Layer& layer);
 		void				ScanLayerArtwork(AIArtHandle artHandle, unsigned int depth, Layer& layer);
+		void				ScanArtNodes(uint32_t index, unsigned int depth, Layer& layer);
 		void				ParseLayers();
 		void				ParseLayerName(const Layer& layer, std::string& name, std::string& options);
 		bool				HasAnimationOption(const std::vector<std::string>& options);
@@ -83,6 +81,8 @@ namespace CanvasExport
 		bool				hasAnimation;					// Does this document have any animation? Could be rotation on a draw function or animation paths.
 
 		void				Render();
+
+		static bool			Export(const std::string& filePath, bool debugOutput, size_t* removedStatements);
 	
 	};
 
@@ -29,6 +29,7 @@ DocumentResources::DocumentResources()
 {
 	// Initialize DocumentResources
 	this->folderPath = "";
+	this->removedStatements = 0;
 }
 
 DocumentResources::~DocumentResources()
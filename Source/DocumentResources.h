@@ -27,11 +27,17 @@
 #include "Utility.h"
 #include "ImageCollection.h"
 #include "PatternCollection.h"
+#include "PathCollection.h"
+#include "GeometryCollection.h"
+#include "Statistics.h"
+#include "SegmentBuffer.h"
+#include "ArtTable.h"
+#include "ColorCache.h"
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents the resources for a document
@@ -46,7 +52,14 @@ namespace CanvasExport
 
 		ImageCollection		images;
 		PatternCollection	patterns;
+		PathCollection		paths;						// Paths drawn by reference (when exporting Path2D objects)
+		GeometryCollection	geometry;					// Encoded drawing commands (when encoding geometry)
+		Statistics			statistics;					// Per art type and per layer counters (when debugging or writing statistics)
+		ArtTable			artTable;					// Art captured while scanning (and read while rendering)
+		ColorCache			colors;						// Colors converted to RGB
+		SegmentBuffer		segments;					// Segments of the path being rendered
 		std::string			folderPath;					// Path to output folder
+		size_t				removedStatements;			// Statements removed by the drawing command optimizer
 
 	};
 }
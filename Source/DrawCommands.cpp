@@ -0,0 +1,1276 @@
+// DrawCommands.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "DrawCommands.h"
+#include "GeometryCollection.h"
+
+using namespace CanvasExport;
+
+// Marks a save without a matching restore
+static const size_t kNoRestore = (size_t)-1;
+
+// Marks a path that's built with the context (rather than drawn by reference)
+static const size_t kNoPath = (size_t)-1;
+
+// Fewest path segments worth replaying from encoded geometry (shorter runs are written as statements)
+static const size_t kMinEncodedSegments = 4;
+
+// Minimum distance between paths that are joined (keeps anti-aliased edges from touching)
+static const AIReal kMergeSeparation = 1.0;
+
+DrawCommands::DrawCommands()
+{
+	// Initialize DrawCommands
+	this->hasText = false;
+}
+
+DrawCommands::~DrawCommands()
+{
+}
+
+// Turn any pending verbatim text into a command (keeps everything in recorded order)
+void DrawCommands::FlushText()
+{
+	if (hasText)
+	{
+		hasText = false;
+
+		DrawCommand command = { kCommandText, 0, (uint32_t)values.size(), (uint32_t)strings.size() };
+		commands.push_back(command);
+		strings.push_back(text.str());
+
+		// Reset for the next run of text
+		text.str("");
+	}
+}
+
+// Operands (if any) are added after the command
+void DrawCommands::Add(uint8_t opcode, unsigned int depth)
+{
+	FlushText();
+
+	DrawCommand command = { opcode, (uint16_t)depth, (uint32_t)values.size(), (uint32_t)strings.size() };
+	commands.push_back(command);
+}
+
+void DrawCommands::Add(uint8_t opcode, unsigned int depth, AIReal value)
+{
+	Add(opcode, depth);
+	values.push_back(value);
+}
+
+void DrawCommands::Add(uint8_t opcode, unsigned int depth, const std::string& string)
+{
+	Add(opcode, depth);
+	strings.push_back(string);
+}
+
+void DrawCommands::Breadcrumb(unsigned int depth, const std::string& path)
+{
+	Add(kCommandBreadcrumb, depth, path);
+}
+
+void DrawCommands::MoveTo(unsigned int depth, AIReal x, AIReal y)
+{
+	Add(kCommandMoveTo, depth);
+	values.push_back(x);
+	values.push_back(y);
+}
+
+void DrawCommands::LineTo(unsigned int depth, AIReal x, AIReal y)
+{
+	Add(kCommandLineTo, depth);
+	values.push_back(x);
+	values.push_back(y);
+}
+
+void DrawCommands::BezierCurveTo(unsigned int depth, AIReal cp1x, AIReal cp1y, AIReal cp2x, AIReal cp2y, AIReal x, AIReal y)
+{
+	Add(kCommandBezierCurveTo, depth);
+	values.push_back(cp1x);
+	values.push_back(cp1y);
+	values.push_back(cp2x);
+	values.push_back(cp2y);
+	values.push_back(x);
+	values.push_back(y);
+}
+
+void DrawCommands::FillStyle(unsigned int depth, const std::string& style)
+{
+	Add(kCommandFillStyle, depth, style);
+}
+
+void DrawCommands::StrokeStyle(unsigned int depth, const std::string& style)
+{
+	Add(kCommandStrokeStyle, depth, style);
+}
+
+void DrawCommands::GlobalAlpha(unsigned int depth, AIReal alpha)
+{
+	Add(kCommandGlobalAlpha, depth, alpha);
+}
+
+void DrawCommands::LineWidth(unsigned int depth, AIReal width)
+{
+	Add(kCommandLineWidth, depth, width);
+}
+
+void DrawCommands::LineCap(unsigned int depth, AILineCap cap)
+{
+	Add(kCommandLineCap, depth, (AIReal)cap);
+}
+
+void DrawCommands::LineJoin(unsigned int depth, AILineJoin join)
+{
+	Add(kCommandLineJoin, depth, (AIReal)join);
+}
+
+void DrawCommands::MiterLimit(unsigned int depth, AIReal limit)
+{
+	Add(kCommandMiterLimit, depth, limit);
+}
+
+void DrawCommands::ShadowColor(unsigned int depth, const std::string& color)
+{
+	Add(kCommandShadowColor, depth, color);
+}
+
+void DrawCommands::ShadowOffsetX(unsigned int depth, AIReal offset)
+{
+	Add(kCommandShadowOffsetX, depth, offset);
+}
+
+void DrawCommands::ShadowOffsetY(unsigned int depth, AIReal offset)
+{
+	Add(kCommandShadowOffsetY, depth, offset);
+}
+
+void DrawCommands::ShadowBlur(unsigned int depth, AIReal blur)
+{
+	Add(kCommandShadowBlur, depth, blur);
+}
+
+void DrawCommands::Transform(unsigned int depth, const AIRealMatrix& matrix)
+{
+	Add(kCommandTransform, depth);
+	values.push_back(matrix.a);
+	values.push_back(matrix.b);
+	values.push_back(matrix.c);
+	values.push_back(matrix.d);
+	values.push_back(matrix.tx);
+	values.push_back(matrix.ty);
+}
+
+void DrawCommands::Call(unsigned int depth, const std::string& functionName)
+{
+	Add(kCommandCall, depth, functionName);
+}
+
+void DrawCommands::DrawImage(unsigned int depth, const std::string& id, AIReal x, AIReal y)
+{
+	Add(kCommandDrawImage, depth, id);
+	values.push_back(x);
+	values.push_back(y);
+}
+
+bool DrawCommands::IsEmpty() const
+{
+	return (commands.empty() && !hasText);
+}
+
+// Remove all commands (keeps allocated memory for the next set)
+void DrawCommands::Clear()
+{
+	commands.clear();
+	values.clear();
+	strings.clear();
+
+	hasText = false;
+	text.str("");
+}
+
+// Exchange recorded commands with another set (pending text is flushed first, so nothing is left behind)
+void DrawCommands::Swap(DrawCommands& other)
+{
+	FlushText();
+	other.FlushText();
+
+	commands.swap(other.commands);
+	values.swap(other.values);
+	strings.swap(other.strings);
+}
+
+// Find where to split the commands into chunks of at least chunkSegments path segments (ends holds the end of each chunk)
+// Chunks only end where another piece of art begins, so each one can be written on its own (as long as paths aren't collected)
+void DrawCommands::Split(size_t chunkSegments, std::vector<size_t>& ends)
+{
+	// Include any trailing text
+	FlushText();
+
+	ends.clear();
+
+	size_t segmentCount = 0;
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		uint8_t opcode = commands[i].opcode;
+
+		if (segmentCount >= chunkSegments &&
+			(opcode == kCommandSave || opcode == kCommandBeginPath || opcode == kCommandBreadcrumb))
+		{
+			ends.push_back(i);
+			segmentCount = 0;
+		}
+
+		if (IsPathSegment(opcode))
+		{
+			segmentCount++;
+		}
+	}
+
+	ends.push_back(commands.size());
+}
+
+// Does this command assign a context property?
+bool DrawCommands::IsSetter(uint8_t opcode) const
+{
+	return (opcode >= kCommandFillStyle && opcode <= kCommandShadowBlur);
+}
+
+// Does this command add to the current path?
+bool DrawCommands::IsPathSegment(uint8_t opcode) const
+{
+	return (opcode >= kCommandMoveTo && opcode <= kCommandClosePath);
+}
+
+// Does this command change state that's saved and restored with the context?
+// (verbatim text and function calls could do anything, so they count)
+bool DrawCommands::ChangesState(uint8_t opcode) const
+{
+	return (IsSetter(opcode) ||
+			opcode == kCommandTransform ||
+			opcode == kCommandClip ||
+			opcode == kCommandText ||
+			opcode == kCommandCall);
+}
+
+// Do two setters assign the same value?
+bool DrawCommands::SameOperands(const DrawCommand& command1, const DrawCommand& command2) const
+{
+	if (command1.opcode != command2.opcode)
+	{
+		return false;
+	}
+
+	switch (command1.opcode)
+	{
+		case kCommandFillStyle:
+		case kCommandStrokeStyle:
+		case kCommandShadowColor:
+		{
+			return (strings[command1.string] == strings[command2.string]);
+		}
+		default:
+		{
+			return (values[command1.value] == values[command2.value]);
+		}
+	}
+}
+
+// Find the matching restore for each save (kNoRestore if there isn't one)
+void DrawCommands::FindRestores(std::vector<size_t>& restores) const
+{
+	restores.assign(commands.size(), kNoRestore);
+
+	std::vector<size_t> saves;
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		if (commands[i].opcode == kCommandSave)
+		{
+			saves.push_back(i);
+		}
+		else if (commands[i].opcode == kCommandRestore && !saves.empty())
+		{
+			restores[saves.back()] = i;
+			saves.pop_back();
+		}
+	}
+}
+
+// Drop flagged commands (their operands are left in place)
+void DrawCommands::RemoveCommands(const std::vector<bool>& removed)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		if (!removed[i])
+		{
+			commands[count++] = commands[i];
+		}
+	}
+	commands.resize(count);
+}
+
+// Sibling save/restore blocks that start by assigning the same value (e.g. drop shadows with the same shadow)
+// can share a single assignment made before the first block
+// This is only done if the value is re-assigned (or the enclosing block is restored) before anything else could use it
+void DrawCommands::HoistSetters()
+{
+	std::vector<size_t> restores;
+	FindRestores(restores);
+
+	std::vector<bool> removed(commands.size(), false);
+	std::vector<bool> isSibling(commands.size(), false);
+	std::vector<DrawCommand> optimized;
+	optimized.reserve(commands.size());
+
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		if (removed[i])
+		{
+			continue;
+		}
+
+		if (commands[i].opcode == kCommandSave && restores[i] != kNoRestore && !isSibling[i])
+		{
+			// Gather sibling blocks (only breadcrumbs can come between them)
+			std::vector<size_t> saves;
+			size_t end = i;
+			while (end < commands.size() && commands[end].opcode == kCommandSave && restores[end] != kNoRestore)
+			{
+				saves.push_back(end);
+
+				end = restores[end] + 1;
+				while (end < commands.size() && commands[end].opcode == kCommandBreadcrumb)
+				{
+					end++;
+				}
+			}
+
+			if (saves.size() > 1)
+			{
+				// Look at each setter at the start of the first block
+				for (size_t k = i + 1; k < restores[i] && (IsSetter(commands[k].opcode) || commands[k].opcode == kCommandBreadcrumb); k++)
+				{
+					if (!IsSetter(commands[k].opcode))
+					{
+						continue;
+					}
+
+					// Find the same assignment at the start of every block
+					std::vector<size_t> setters;
+					for (size_t j = 0; j < saves.size(); j++)
+					{
+						size_t found = kNoRestore;
+						size_t matches = 0;
+						for (size_t m = saves[j] + 1; m < restores[saves[j]] && (IsSetter(commands[m].opcode) || commands[m].opcode == kCommandBreadcrumb); m++)
+						{
+							if (commands[m].opcode == commands[k].opcode)
+							{
+								matches++;
+								if (SameOperands(commands[m], commands[k]))
+								{
+									found = m;
+								}
+							}
+						}
+
+						// Must be assigned exactly once, to the same value
+						if (matches != 1 || found == kNoRestore)
+						{
+							break;
+						}
+						setters.push_back(found);
+					}
+
+					if (setters.size() != saves.size())
+					{
+						continue;
+					}
+
+					// Is the new value safe to leave behind after the last block?
+					bool isSafe = false;
+					for (size_t m = restores[saves.back()] + 1; m < commands.size(); m++)
+					{
+						uint8_t opcode = commands[m].opcode;
+						if (opcode == kCommandRestore || opcode == commands[k].opcode)
+						{
+							// Enclosing block restored, or value replaced
+							isSafe = true;
+							break;
+						}
+						else if (!(IsSetter(opcode) || IsPathSegment(opcode) || opcode == kCommandBeginPath || opcode == kCommandBreadcrumb))
+						{
+							// Could be used
+							break;
+						}
+					}
+
+					if (isSafe)
+					{
+						// Assign once, before the first block
+						DrawCommand hoisted = commands[k];
+						hoisted.depth = (commands[i].depth > 0) ? (uint16_t)(commands[i].depth - 1) : 0;
+						optimized.push_back(hoisted);
+
+						for (size_t j = 0; j < setters.size(); j++)
+						{
+							removed[setters[j]] = true;
+						}
+					}
+				}
+
+				// Siblings have been handled
+				for (size_t j = 1; j < saves.size(); j++)
+				{
+					isSibling[saves[j]] = true;
+				}
+			}
+		}
+
+		optimized.push_back(commands[i]);
+	}
+
+	commands.swap(optimized);
+}
+
+// Remove save/restore pairs that don't enclose any state changes
+void DrawCommands::RemoveEmptySaves()
+{
+	std::vector<bool> removed(commands.size(), false);
+	std::vector<size_t> saves;
+	std::vector<bool> changed;
+
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		uint8_t opcode = commands[i].opcode;
+		if (opcode == kCommandSave)
+		{
+			saves.push_back(i);
+			changed.push_back(false);
+		}
+		else if (opcode == kCommandRestore)
+		{
+			if (!saves.empty())
+			{
+				if (!changed.back())
+				{
+					removed[saves.back()] = true;
+					removed[i] = true;
+				}
+
+				// A nested block that's kept restores its own changes
+				saves.pop_back();
+				changed.pop_back();
+			}
+		}
+		else if (ChangesState(opcode) && !changed.empty())
+		{
+			changed.back() = true;
+		}
+	}
+
+	RemoveCommands(removed);
+}
+
+// Expand bounds to include a point (top and left are the minimum coordinates)
+static void AddPoint(AIRealRect& bounds, bool& hasBounds, AIReal x, AIReal y)
+{
+	if (!hasBounds)
+	{
+		bounds.left = bounds.right = x;
+		bounds.top = bounds.bottom = y;
+		hasBounds = true;
+	}
+	else
+	{
+		if (x < bounds.left) bounds.left = x;
+		if (x > bounds.right) bounds.right = x;
+		if (y < bounds.top) bounds.top = y;
+		if (y > bounds.bottom) bounds.bottom = y;
+	}
+}
+
+// Join consecutive paths that are filled the same way into one path (removing a fill and a beginPath each time)
+// Paths are only joined if their bounds are apart, so winding, transparency, and anti-aliasing are unaffected
+// (and never while a shadow is set, since each shadow could fall across an earlier path)
+void DrawCommands::MergePaths()
+{
+	std::vector<bool> removed(commands.size(), false);
+
+	// Find where a shadow might be set
+	std::vector<bool> isShadowed(commands.size(), false);
+	std::vector<bool> shadows;
+	bool hasShadow = false;
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		uint8_t opcode = commands[i].opcode;
+		if (opcode == kCommandSave)
+		{
+			shadows.push_back(hasShadow);
+		}
+		else if (opcode == kCommandRestore && !shadows.empty())
+		{
+			hasShadow = shadows.back();
+			shadows.pop_back();
+		}
+		else if (opcode >= kCommandShadowColor && opcode <= kCommandShadowBlur)
+		{
+			hasShadow = true;
+		}
+		isShadowed[i] = hasShadow;
+	}
+
+	size_t i = 0;
+	while (i < commands.size())
+	{
+		if (commands[i].opcode != kCommandBeginPath)
+		{
+			i++;
+			continue;
+		}
+
+		// Path segments, then any style changes, then the fill
+		AIRealRect bounds = { 0.0, 0.0, 0.0, 0.0 };
+		bool hasBounds = false;
+		size_t fill = i + 1;
+		for (; fill < commands.size() && (IsPathSegment(commands[fill].opcode) || commands[fill].opcode == kCommandBreadcrumb); fill++)
+		{
+			const AIReal* value = values.data() + commands[fill].value;
+			switch (commands[fill].opcode)
+			{
+				case kCommandMoveTo:
+				case kCommandLineTo:
+				{
+					AddPoint(bounds, hasBounds, value[0], value[1]);
+					break;
+				}
+				case kCommandBezierCurveTo:
+				{
+					// Curves stay inside their control points
+					AddPoint(bounds, hasBounds, value[0], value[1]);
+					AddPoint(bounds, hasBounds, value[2], value[3]);
+					AddPoint(bounds, hasBounds, value[4], value[5]);
+					break;
+				}
+			}
+		}
+		while (fill < commands.size() && (IsSetter(commands[fill].opcode) || commands[fill].opcode == kCommandBreadcrumb))
+		{
+			fill++;
+		}
+		if (fill >= commands.size() || !hasBounds || isShadowed[fill] ||
+			(commands[fill].opcode != kCommandFill && commands[fill].opcode != kCommandFillEvenOdd))
+		{
+			i = fill;
+			continue;
+		}
+
+		// Join following paths
+		for (;;)
+		{
+			size_t next = fill + 1;
+			while (next < commands.size() && commands[next].opcode == kCommandBreadcrumb)
+			{
+				next++;
+			}
+			if (next >= commands.size() || commands[next].opcode != kCommandBeginPath)
+			{
+				break;
+			}
+
+			// Only path segments, then the same kind of fill (any style change would come before it)
+			AIRealRect nextBounds = { 0.0, 0.0, 0.0, 0.0 };
+			bool hasNextBounds = false;
+			size_t nextFill = next + 1;
+			for (; nextFill < commands.size() && (IsPathSegment(commands[nextFill].opcode) || commands[nextFill].opcode == kCommandBreadcrumb); nextFill++)
+			{
+				const AIReal* value = values.data() + commands[nextFill].value;
+				switch (commands[nextFill].opcode)
+				{
+					case kCommandMoveTo:
+					case kCommandLineTo:
+					{
+						AddPoint(nextBounds, hasNextBounds, value[0], value[1]);
+						break;
+					}
+					case kCommandBezierCurveTo:
+					{
+						AddPoint(nextBounds, hasNextBounds, value[0], value[1]);
+						AddPoint(nextBounds, hasNextBounds, value[2], value[3]);
+						AddPoint(nextBounds, hasNextBounds, value[4], value[5]);
+						break;
+					}
+				}
+			}
+			if (nextFill >= commands.size() || !hasNextBounds || commands[nextFill].opcode != commands[fill].opcode)
+			{
+				break;
+			}
+
+			// The joined path mustn't be used again (i.e. stroked or clipped)
+			size_t after = nextFill + 1;
+			while (after < commands.size() && commands[after].opcode == kCommandBreadcrumb)
+			{
+				after++;
+			}
+			if (after < commands.size())
+			{
+				uint8_t opcode = commands[after].opcode;
+				if (opcode == kCommandStroke || opcode == kCommandClip || opcode == kCommandFill ||
+					opcode == kCommandFillEvenOdd || opcode == kCommandText || IsPathSegment(opcode))
+				{
+					break;
+				}
+			}
+
+			// Are the paths apart?
+			if (!(nextBounds.left > bounds.right + kMergeSeparation || bounds.left > nextBounds.right + kMergeSeparation ||
+				  nextBounds.top > bounds.bottom + kMergeSeparation || bounds.top > nextBounds.bottom + kMergeSeparation))
+			{
+				break;
+			}
+
+			// Join
+			removed[fill] = true;
+			removed[next] = true;
+			AddPoint(bounds, hasBounds, nextBounds.left, nextBounds.top);
+			AddPoint(bounds, hasBounds, nextBounds.right, nextBounds.bottom);
+			fill = nextFill;
+		}
+
+		i = fill + 1;
+	}
+
+	RemoveCommands(removed);
+}
+
+// Remove redundant commands and return the number of statements removed
+size_t DrawCommands::Optimize()
+{
+	// Include any trailing text
+	FlushText();
+
+	size_t count = commands.size();
+
+	// Hoisting can leave blocks empty, and removing empty blocks can bring paths together
+	HoistSetters();
+	RemoveEmptySaves();
+	MergePaths();
+
+	return (count - commands.size());
+}
+
+// Find the end of the segments that follow a beginPath (breadcrumbs from compound path members are included)
+size_t DrawCommands::PathEnd(size_t beginPath) const
+{
+	size_t end = beginPath + 1;
+	while (end < commands.size() && (IsPathSegment(commands[end].opcode) || commands[end].opcode == kCommandBreadcrumb))
+	{
+		end++;
+	}
+	return end;
+}
+
+// Can a path be built once and drawn by reference?
+// Only if it's complete (nothing adds to it later) and it's drawn before the next path begins
+// Segments are transformed as they're added, but a Path2D is transformed when it's drawn, so the transform can't change in between
+// (e.g. pattern fills are drawn after a transform, and a restore or verbatim text might change it too)
+bool DrawCommands::CanBuildPath(size_t beginPath, size_t end) const
+{
+	if (end == beginPath + 1)
+	{
+		return false;
+	}
+
+	for (size_t i = end; i < commands.size() && commands[i].opcode != kCommandBeginPath; i++)
+	{
+		uint8_t opcode = commands[i].opcode;
+		if (IsPathSegment(opcode))
+		{
+			return false;
+		}
+		else if (opcode == kCommandTransform || opcode == kCommandRestore || opcode == kCommandText || opcode == kCommandCall)
+		{
+			return false;
+		}
+		else if (opcode == kCommandFill || opcode == kCommandFillEvenOdd || opcode == kCommandStroke || opcode == kCommandClip)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Build SVG path data for the segments that follow a beginPath
+std::string DrawCommands::PathData(size_t beginPath, size_t end) const
+{
+	std::string data;
+
+	for (size_t i = beginPath + 1; i < end; i++)
+	{
+		const AIReal* value = values.data() + commands[i].value;
+
+		switch (commands[i].opcode)
+		{
+			case kCommandMoveTo:
+			{
+				data += "M";
+				AppendFixed<1>(data, value[0]);
+				data += " ";
+				AppendFixed<1>(data, value[1]);
+				break;
+			}
+			case kCommandLineTo:
+			{
+				data += "L";
+				AppendFixed<1>(data, value[0]);
+				data += " ";
+				AppendFixed<1>(data, value[1]);
+				break;
+			}
+			case kCommandBezierCurveTo:
+			{
+				data += "C";
+				for (int j = 0; j < 6; j++)
+				{
+					if (j > 0)
+					{
+						data += " ";
+					}
+					AppendFixed<1>(data, value[j]);
+				}
+				break;
+			}
+			case kCommandClosePath:
+			{
+				data += "Z";
+				break;
+			}
+		}
+	}
+
+	return data;
+}
+
+// Append a signed value as a zigzag varint (small magnitudes of either sign take a single byte)
+static void AppendVarint(std::string& data, int32_t value)
+{
+	uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	while (zigzag >= 0x80)
+	{
+		data += (char)((zigzag & 0x7F) | 0x80);
+		zigzag >>= 7;
+	}
+	data += (char)zigzag;
+}
+
+// Append a coordinate, snapped to the grid, as the difference from the previous coordinate
+// (returns false if the coordinate or the difference doesn't fit in 32 bits)
+static bool AppendDelta(std::string& data, AIReal value, AIReal grid, int32_t& previous)
+{
+	double steps = (double)value / (double)grid;
+	if (!(fabs(steps) <= (double)INT32_MAX))
+	{
+		return false;
+	}
+
+	int64_t quantized = llround(steps);
+	int64_t delta = quantized - (int64_t)previous;
+	if (delta < INT32_MIN || delta > INT32_MAX)
+	{
+		return false;
+	}
+
+	AppendVarint(data, (int32_t)delta);
+	previous = (int32_t)quantized;
+	return true;
+}
+
+// Build binary path data for the segments that follow a beginPath
+// Each segment is a PathCollection::Segment byte and its points as grid steps from the previous point
+// (the path ends with kSegmentEnd; returns false if a point is too far out to quantize)
+bool DrawCommands::QuantizedPathData(size_t beginPath, size_t end, AIReal grid, std::string& data) const
+{
+	data.clear();
+	int32_t x = 0;
+	int32_t y = 0;
+
+	for (size_t i = beginPath + 1; i < end; i++)
+	{
+		const AIReal* value = values.data() + commands[i].value;
+
+		switch (commands[i].opcode)
+		{
+			case kCommandMoveTo:
+			{
+				data += (char)PathCollection::kSegmentMoveTo;
+				if (!AppendDelta(data, value[0], grid, x) || !AppendDelta(data, value[1], grid, y))
+				{
+					return false;
+				}
+				break;
+			}
+			case kCommandLineTo:
+			{
+				data += (char)PathCollection::kSegmentLineTo;
+				if (!AppendDelta(data, value[0], grid, x) || !AppendDelta(data, value[1], grid, y))
+				{
+					return false;
+				}
+				break;
+			}
+			case kCommandBezierCurveTo:
+			{
+				data += (char)PathCollection::kSegmentBezierCurveTo;
+				for (int j = 0; j < 6; j += 2)
+				{
+					if (!AppendDelta(data, value[j], grid, x) || !AppendDelta(data, value[j + 1], grid, y))
+					{
+						return false;
+					}
+				}
+				break;
+			}
+			case kCommandClosePath:
+			{
+				data += (char)PathCollection::kSegmentClosePath;
+				break;
+			}
+		}
+	}
+	data += (char)PathCollection::kSegmentEnd;
+
+	return true;
+}
+
+// Write the recorded commands as JavaScript
+// If paths is provided, complete paths are added to it and drawn by reference (e.g. ctx.fill(paths[0]))
+void DrawCommands::Render(OutputStream& stream, const std::string& contextName, PathCollection* paths)
+{
+	// Include any trailing text
+	FlushText();
+
+	// Path that's drawn by reference
+	size_t currentPath = kNoPath;
+
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		const DrawCommand& command = commands[i];
+
+		// Build the path once, and only keep its comments
+		if (paths && command.opcode == kCommandBeginPath)
+		{
+			size_t end = PathEnd(i);
+			if (CanBuildPath(i, end))
+			{
+				// Paths too far out to quantize are built with the context instead
+				std::string data;
+				bool isBuilt = true;
+				if (exportOptions.GetEncoding() == ExportOptions::kEncodeQuantized)
+				{
+					isBuilt = QuantizedPathData(i, end, exportOptions.grid, data);
+				}
+				else
+				{
+					data = PathData(i, end);
+				}
+
+				if (isBuilt)
+				{
+					for (size_t j = i + 1; j < end; j++)
+					{
+						if (commands[j].opcode == kCommandBreadcrumb)
+						{
+							stream << "\n\n" << Indent(commands[j].depth) << "// " << strings[commands[j].string];
+						}
+					}
+
+					currentPath = paths->Add(data);
+					i = end - 1;
+					continue;
+				}
+			}
+
+			// Built with the context
+			currentPath = kNoPath;
+		}
+
+		// Draw the path by reference
+		if (currentPath != kNoPath)
+		{
+			switch (command.opcode)
+			{
+				case kCommandClip:
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".clip(" << exportOptions.PathsName() << "[" << currentPath << "]);";
+					continue;
+				}
+				case kCommandFill:
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".fill(" << exportOptions.PathsName() << "[" << currentPath << "]);";
+					continue;
+				}
+				case kCommandFillEvenOdd:
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".fill(" << exportOptions.PathsName() << "[" << currentPath << "], \"evenodd\");";
+					continue;
+				}
+				case kCommandStroke:
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".stroke(" << exportOptions.PathsName() << "[" << currentPath << "]);";
+					continue;
+				}
+			}
+		}
+
+		RenderCommand(stream, command, contextName);
+	}
+}
+
+// Write a range of the recorded commands as JavaScript (paths are always built with the context)
+// Nothing is changed, so ranges found by Split can be written at the same time (from different threads)
+void DrawCommands::RenderRange(OutputStream& stream, const std::string& contextName, size_t begin, size_t end) const
+{
+	for (size_t i = begin; i < end && i < commands.size(); i++)
+	{
+		RenderCommand(stream, commands[i], contextName);
+	}
+}
+
+// Write a single command as JavaScript
+void DrawCommands::RenderCommand(OutputStream& stream, const DrawCommand& command, const std::string& contextName) const
+{
+	const AIReal* value = values.data() + command.value;
+
+	switch (command.opcode)
+	{
+		case kCommandText:
+		{
+			stream << strings[command.string];
+			break;
+		}
+		case kCommandBreadcrumb:
+		{
+			stream << "\n\n" << Indent(command.depth) << "// " << strings[command.string];
+			break;
+		}
+		case kCommandSave:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".save();";
+			break;
+		}
+		case kCommandRestore:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".restore();";
+			break;
+		}
+		case kCommandBeginPath:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".beginPath();";
+			break;
+		}
+		case kCommandMoveTo:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".moveTo(" <<
+				Fixed<1>(value[0]) << ", " << Fixed<1>(value[1]) << ");";
+			break;
+		}
+		case kCommandLineTo:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".lineTo(" <<
+				Fixed<1>(value[0]) << ", " << Fixed<1>(value[1]) << ");";
+			break;
+		}
+		case kCommandBezierCurveTo:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".bezierCurveTo(" <<
+				Fixed<1>(value[0]) << ", " << Fixed<1>(value[1]) << ", " <<
+				Fixed<1>(value[2]) << ", " << Fixed<1>(value[3]) << ", " <<
+				Fixed<1>(value[4]) << ", " << Fixed<1>(value[5]) << ");";
+			break;
+		}
+		case kCommandClosePath:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".closePath();";
+			break;
+		}
+		case kCommandClip:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".clip();";
+			break;
+		}
+		case kCommandFill:
+		{
+			// Non-zero is the default, so no need to specify
+			stream << "\n" << Indent(command.depth) << contextName << ".fill();";
+			break;
+		}
+		case kCommandFillEvenOdd:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".fill(\"evenodd\");";
+			break;
+		}
+		case kCommandStroke:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".stroke();";
+			break;
+		}
+		case kCommandFillStyle:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".fillStyle = " << strings[command.string] << ";";
+			break;
+		}
+		case kCommandStrokeStyle:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".strokeStyle = " << strings[command.string] << ";";
+			break;
+		}
+		case kCommandGlobalAlpha:
+		{
+			// Relative to the "base" alpha value
+			stream << "\n" << Indent(command.depth) << contextName << ".globalAlpha = alpha * " << Fixed<2>(value[0]) << ";";
+			break;
+		}
+		case kCommandLineWidth:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".lineWidth = " << Fixed<1>(value[0]) << ";";
+			break;
+		}
+		case kCommandLineCap:
+		{
+			switch ((AILineCap)value[0])
+			{
+				case (kAIButtCap):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineCap = \"butt\";";
+					break;
+				}
+				case (kAIRoundCap):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineCap = \"round\";";
+					break;
+				}
+				case (kAIProjectingCap):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineCap = \"square\";";
+					break;
+				}
+			}
+			break;
+		}
+		case kCommandLineJoin:
+		{
+			switch ((AILineJoin)value[0])
+			{
+				case (kAIMiterJoin):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineJoin = \"miter\";";
+					break;
+				}
+				case (kAIRoundJoin):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineJoin = \"round\";";
+					break;
+				}
+				case (kAIBevelJoin):
+				{
+					stream << "\n" << Indent(command.depth) << contextName << ".lineJoin = \"bevel\";";
+					break;
+				}
+			}
+			break;
+		}
+		case kCommandMiterLimit:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".miterLimit = " << Fixed<1>(value[0]) << ";";
+			break;
+		}
+		case kCommandShadowColor:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".shadowColor = " << strings[command.string] << ";";
+			break;
+		}
+		case kCommandShadowOffsetX:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".shadowOffsetX = " << Fixed<1>(value[0]) << ";";
+			break;
+		}
+		case kCommandShadowOffsetY:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".shadowOffsetY = " << Fixed<1>(value[0]) << ";";
+			break;
+		}
+		case kCommandShadowBlur:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".shadowBlur = " << Fixed<1>(value[0]) << ";";
+			break;
+		}
+		case kCommandTransform:
+		{
+			// a, b, c, d, tx, ty (formatted as RenderTransform does)
+			stream << "\n" << Indent(command.depth) << contextName << ".transform(" <<
+				Fixed<3>(value[0]) << ", " << Fixed<3>(value[1]) << ", " <<
+				Fixed<3>(value[2]) << ", " << Fixed<3>(value[3]) << ", " <<
+				Fixed<1>(value[4]) << ", " << Fixed<1>(value[5]) << ");";
+			break;
+		}
+		case kCommandCall:
+		{
+			stream << "\n" << Indent(command.depth) << strings[command.string] << "(" << contextName << ");";
+			break;
+		}
+		case kCommandDrawImage:
+		{
+			stream << "\n" << Indent(command.depth) << contextName << ".drawImage(document.getElementById(\"" << strings[command.string] << "\"), " <<
+				Fixed<1>(value[0]) << ", " << Fixed<1>(value[1]) << ");";
+			break;
+		}
+	}
+}
+
+// Can this command be replayed from encoded geometry?
+// (anything that depends on local variables, other functions or verbatim text can't)
+bool DrawCommands::IsEncodable(uint8_t opcode) const
+{
+	return (opcode != kCommandText &&
+			opcode != kCommandGlobalAlpha &&
+			opcode != kCommandCall &&
+			opcode != kCommandDrawImage);
+}
+
+// Write the recorded commands as JavaScript, with runs of path geometry encoded as binary data
+// Each run is added to geometry and replayed with a single call (e.g. replay(ctx, 0, 120, 0, ["rgb(0, 0, 0)"]))
+void DrawCommands::RenderEncoded(OutputStream& stream, const std::string& contextName, GeometryCollection& geometry)
+{
+	// Include any trailing text
+	FlushText();
+
+	size_t i = 0;
+	while (i < commands.size())
+	{
+		// Find the next run
+		size_t end = i;
+		size_t segmentCount = 0;
+		while (end < commands.size() && IsEncodable(commands[end].opcode))
+		{
+			if (IsPathSegment(commands[end].opcode))
+			{
+				segmentCount++;
+			}
+			end++;
+		}
+
+		// Too short to be worth encoding?
+		if (segmentCount < kMinEncodedSegments)
+		{
+			// Write up to (and including) whatever ended the run
+			size_t next = (end < commands.size()) ? end + 1 : end;
+			for (; i < next; i++)
+			{
+				RenderCommand(stream, commands[i], contextName);
+			}
+			continue;
+		}
+
+		// Encode the run (breadcrumbs are dropped)
+		size_t start = geometry.OpcodeCount();
+		size_t index = geometry.OperandCount();
+		std::vector<std::string> styles;
+		for (size_t j = i; j < end; j++)
+		{
+			const DrawCommand& command = commands[j];
+			const AIReal* value = values.data() + command.value;
+
+			switch (command.opcode)
+			{
+				case kCommandBreadcrumb:
+				{
+					continue;
+				}
+				case kCommandMoveTo:
+				case kCommandLineTo:
+				{
+					geometry.AddOperands(value, 2);
+					break;
+				}
+				case kCommandBezierCurveTo:
+				case kCommandTransform:
+				{
+					geometry.AddOperands(value, 6);
+					break;
+				}
+				case kCommandFillStyle:
+				case kCommandStrokeStyle:
+				case kCommandShadowColor:
+				{
+					// Styles are passed as JavaScript values and referenced by index
+					size_t style = 0;
+					while (style < styles.size() && styles[style] != strings[command.string])
+					{
+						style++;
+					}
+					if (style == styles.size())
+					{
+						styles.push_back(strings[command.string]);
+					}
+
+					AIReal styleIndex = (AIReal)style;
+					geometry.AddOperands(&styleIndex, 1);
+					break;
+				}
+				case kCommandLineWidth:
+				case kCommandLineCap:
+				case kCommandLineJoin:
+				case kCommandMiterLimit:
+				case kCommandShadowOffsetX:
+				case kCommandShadowOffsetY:
+				case kCommandShadowBlur:
+				{
+					geometry.AddOperands(value, 1);
+					break;
+				}
+			}
+			geometry.AddOpcode(command.opcode);
+		}
+
+		stream << "\n" << Indent(commands[i].depth) << "replay(" << contextName << ", " <<
+			start << ", " << geometry.OpcodeCount() << ", " << index;
+		if (!styles.empty())
+		{
+			stream << ", [";
+			for (size_t j = 0; j < styles.size(); j++)
+			{
+				if (j > 0)
+				{
+					stream << ", ";
+				}
+				stream << styles[j];
+			}
+			stream << "]";
+		}
+		stream << ");";
+
+		i = end;
+	}
+}
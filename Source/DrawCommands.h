@@ -0,0 +1,161 @@
+// DrawCommands.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef DRAWCOMMANDS_H
+#define DRAWCOMMANDS_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "PathCollection.h"
+#include <sstream>
+#include <stdint.h>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	class GeometryCollection;
+
+	/// A single recorded drawing command
+	struct DrawCommand
+	{
+		uint8_t				opcode;						// DrawCommands::Opcode
+		uint16_t			depth;						// Indentation depth
+		uint32_t			value;						// Index of the first numeric operand
+		uint32_t			string;						// Index of the string operand
+	};
+
+	/// Records the drawing commands for a canvas, so they can be optimized before they're written as JavaScript
+	class DrawCommands
+	{
+	private:
+
+		std::ostringstream	text;						// Pending verbatim text
+		bool				hasText;					// Has anything been written to the pending text?
+
+		void				FlushText();
+		void				Add(uint8_t opcode, unsigned int depth);
+		void				Add(uint8_t opcode, unsigned int depth, AIReal value);
+		void				Add(uint8_t opcode, unsigned int depth, const std::string& string);
+
+		bool				IsSetter(uint8_t opcode) const;
+		bool				IsPathSegment(uint8_t opcode) const;
+		bool				ChangesState(uint8_t opcode) const;
+		bool				SameOperands(const DrawCommand& command1, const DrawCommand& command2) const;
+		void				FindRestores(std::vector<size_t>& restores) const;
+		void				RemoveCommands(const std::vector<bool>& removed);
+		void				HoistSetters();
+		void				RemoveEmptySaves();
+		void				MergePaths();
+		size_t				PathEnd(size_t beginPath) const;
+		bool				CanBuildPath(size_t beginPath, size_t end) const;
+		std::string			PathData(size_t beginPath, size_t end) const;
+		bool				QuantizedPathData(size_t beginPath, size_t end, AIReal grid, std::string& data) const;
+		bool				IsEncodable(uint8_t opcode) const;
+		void				RenderCommand(OutputStream& stream, const DrawCommand& command, const std::string& contextName) const;
+
+	public:
+
+		enum Opcode
+		{
+			kCommandText,					// Verbatim text (string)
+			kCommandBreadcrumb,				// Breadcrumb comment (string)
+			kCommandSave,
+			kCommandRestore,
+			kCommandBeginPath,
+			kCommandMoveTo,					// x, y
+			kCommandLineTo,					// x, y
+			kCommandBezierCurveTo,			// cp1x, cp1y, cp2x, cp2y, x, y
+			kCommandClosePath,
+			kCommandClip,
+			kCommandFill,
+			kCommandFillEvenOdd,
+			kCommandStroke,
+			kCommandFillStyle,				// Style (string)
+			kCommandStrokeStyle,			// Style (string)
+			kCommandGlobalAlpha,			// Alpha (multiplied by the "base" alpha)
+			kCommandLineWidth,				// Width
+			kCommandLineCap,				// AILineCap
+			kCommandLineJoin,				// AILineJoin
+			kCommandMiterLimit,				// Limit
+			kCommandShadowColor,			// Color (string)
+			kCommandShadowOffsetX,			// Offset
+			kCommandShadowOffsetY,			// Offset
+			kCommandShadowBlur,				// Blur
+			kCommandTransform,				// a, b, c, d, tx, ty
+			kCommandCall,					// Function name (string), called with the context
+			kCommandDrawImage				// Image ID (string), x, y
+		};
+
+		DrawCommands();
+		~DrawCommands();
+
+		std::vector<DrawCommand>	commands;			// Recorded commands
+		std::vector<AIReal>			values;				// Packed numeric operands
+		std::vector<std::string>	strings;			// String operands
+
+		/// Anything without its own command (comments, gradients, text) is kept as verbatim text
+		inline std::ostringstream&	Text()				{ hasText = true; return text; }
+
+		inline void			Save(unsigned int depth)					{ Add(kCommandSave, depth); }
+		inline void			Restore(unsigned int depth)					{ Add(kCommandRestore, depth); }
+		inline void			BeginPath(unsigned int depth)				{ Add(kCommandBeginPath, depth); }
+		inline void			ClosePath(unsigned int depth)				{ Add(kCommandClosePath, depth); }
+		inline void			Clip(unsigned int depth)					{ Add(kCommandClip, depth); }
+		inline void			Fill(unsigned int depth)					{ Add(kCommandFill, depth); }
+		inline void			FillEvenOdd(unsigned int depth)				{ Add(kCommandFillEvenOdd, depth); }
+		inline void			Stroke(unsigned int depth)					{ Add(kCommandStroke, depth); }
+
+		void				Breadcrumb(unsigned int depth, const std::string& path);
+		void				MoveTo(unsigned int depth, AIReal x, AIReal y);
+		void				LineTo(unsigned int depth, AIReal x, AIReal y);
+		void				BezierCurveTo(unsigned int depth, AIReal cp1x, AIReal cp1y, AIReal cp2x, AIReal cp2y, AIReal x, AIReal y);
+		void				FillStyle(unsigned int depth, const std::string& style);
+		void				StrokeStyle(unsigned int depth, const std::string& style);
+		void				GlobalAlpha(unsigned int depth, AIReal alpha);
+		void				LineWidth(unsigned int depth, AIReal width);
+		void				LineCap(unsigned int depth, AILineCap cap);
+		void				LineJoin(unsigned int depth, AILineJoin join);
+		void				MiterLimit(unsigned int depth, AIReal limit);
+		void				ShadowColor(unsigned int depth, const std::string& color);
+		void				ShadowOffsetX(unsigned int depth, AIReal offset);
+		void				ShadowOffsetY(unsigned int depth, AIReal offset);
+		void				ShadowBlur(unsigned int depth, AIReal blur);
+		void				Transform(unsigned int depth, const AIRealMatrix& matrix);
+		void				Call(unsigned int depth, const std::string& functionName);
+		void				DrawImage(unsigned int depth, const std::string& id, AIReal x, AIReal y);
+
+		bool				IsEmpty() const;
+		void				Clear();
+		size_t				Optimize();
+		void				Swap(DrawCommands& other);
+		void				Split(size_t chunkSegments, std::vector<size_t>& ends);
+		void				Render(OutputStream& stream, const std::string& contextName, PathCollection* paths);
+		void				RenderEncoded(OutputStream& stream, const std::string& contextName, GeometryCollection& geometry);
+		void				RenderRange(OutputStream& stream, const std::string& contextName, size_t begin, size_t end) const;
+	};
+}
+
+#endif
@@ -25,6 +25,9 @@
 
 using namespace CanvasExport;
 
+// Recorded functions are formatted into their own (smaller) chunks
+static const size_t kFunctionChunkSize = 64 * 1024;
+
 DrawFunction::DrawFunction()
 {
 	// Initialize Function
@@ -41,6 +44,10 @@ DrawFunction::DrawFunction()
 	this->followOrientation = 0.0f;
 	this->rasterizeFileName = "";
 	this->crop = false;
+	this->output = nullptr;
+	this->removedStatements = 0;
+	this->isFormatted = false;
+	this->pendingChunks = 0;
 
 	// Initialize rotate animation clock
 	this->rotateClock.name = "rotateClock";
@@ -57,6 +64,16 @@ DrawFunction::DrawFunction()
 
 DrawFunction::~DrawFunction()
 {
+	// Anything recorded but never written
+	for (unsigned int i = 0; i < layerCommands.size(); i++)
+	{
+		delete layerCommands[i];
+	}
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		delete chunks[i].output;
+	}
+	delete output;
 }
 
 bool const DrawFunction::HasValidTriggers()
@@ -88,8 +105,7 @@ void DrawFunction::RenderClockInit()
 	if (follow)
 	{
 		// Output follow orientation
-		outFile <<   "\n      " << name << ".followOrientation = " << setiosflags(ios::fixed) << setprecision(2) <<
-			followOrientation << " * Math.PI / 180.0;";
+		outFile <<   "\n      " << name << ".followOrientation = " << Fixed<2>(followOrientation) << " * Math.PI / 180.0;";
 	}
 }
 
@@ -237,41 +253,221 @@ void DrawFunction::RenderDrawFunctionCall(const AIRealRect& documentBounds)
 	}
 }
 
-// Render a drawing function
+// Render a drawing function (straight to the output file, one layer at a time)
 void DrawFunction::RenderDrawFunction(const AIRealRect& documentBounds)
+{
+	TraceScope traceScope("DrawFunction::RenderDrawFunction", name);
+
+	// Begin function block
+	BeginFunctionBlock(outFile, documentBounds);
+
+	// Are we supposed to rasterize this function?
+	if (!rasterizeFileName.empty())
+	{
+		// Rasterize the first layer
+		// TODO: Note that this only rasterizes the first associated layer. What if this has multiple layers?
+
+		// Output layer name
+		outFile << "\n\n" << Indent(1) << "// " << name;
+
+		canvas->documentResources->statistics.BeginLayer(name, layers[0]->name);
+		canvas->RenderUnsupportedArt(layers[0]->artHandle, rasterizeFileName, 1);
+		canvas->RenderCommands();
+		canvas->documentResources->statistics.EndLayer();
+	}
+	else
+	{
+		// Render each layer in the function block (they're already in the correct order)
+		for (unsigned int i = 0; i < layers.size(); i++)
+		{
+			TraceScope layerScope("Layer", layers[i]->name);
+			canvas->documentResources->statistics.BeginLayer(name, layers[i]->name);
+
+			// Render the art
+			canvas->RenderArt(layers[i]->artHandle, 1);
+	
+			// Restore remaining state
+			canvas->SetContextDrawingState(1);
+
+			// Write the recorded drawing commands
+			canvas->RenderCommands();
+			canvas->documentResources->statistics.EndLayer();
+		}
+	}
+
+	// End function block
+	outFile << "\n    }";
+}
+
+// Record the drawing commands for each layer, without formatting them
+// (all art is read here, so the SDK is only used from the calling thread)
+void DrawFunction::RecordDrawFunction(const AIRealRect& documentBounds)
+{
+	TraceScope traceScope("DrawFunction::RecordDrawFunction", name);
+
+	// Begin function block (layers are formatted after it later)
+	output = new OutputStream(kFunctionChunkSize);
+	BeginFunctionBlock(*output, documentBounds);
+
+	// Are we supposed to rasterize this function?
+	if (!rasterizeFileName.empty())
+	{
+		// Rasterize the first layer
+		*output << "\n\n" << Indent(1) << "// " << name;
+
+		canvas->RenderUnsupportedArt(layers[0]->artHandle, rasterizeFileName, 1);
+		RecordLayer();
+	}
+	else
+	{
+		// Record each layer in the function block (they're already in the correct order)
+		for (unsigned int i = 0; i < layers.size(); i++)
+		{
+			TraceScope layerScope("Layer", layers[i]->name);
+
+			// Render the art
+			canvas->RenderArt(layers[i]->artHandle, 1);
+
+			// Restore remaining state
+			canvas->SetContextDrawingState(1);
+
+			RecordLayer();
+		}
+	}
+}
+
+// Take the canvas' recorded drawing commands (leaving it empty for the next layer)
+void DrawFunction::RecordLayer()
+{
+	DrawCommands* recorded = new DrawCommands();
+	recorded->Swap(canvas->commands);
+	layerCommands.push_back(recorded);
+}
+
+// Remove redundant commands from every recorded layer (safe to call from any thread)
+void DrawFunction::OptimizeDrawFunction()
+{
+	if (exportOptions.IsOptimized())
+	{
+		for (unsigned int i = 0; i < layerCommands.size(); i++)
+		{
+			removedStatements += layerCommands[i]->Optimize();
+		}
+	}
+}
+
+// Format all of the recorded layers after the start of the function block
+// (safe to call from any thread, unless paths or geometry are being collected, since those are numbered in the order they're written)
+void DrawFunction::FormatDrawFunction()
+{
+	TraceScope traceScope("DrawFunction::FormatDrawFunction", name);
+
+	for (unsigned int i = 0; i < layerCommands.size(); i++)
+	{
+		canvas->RenderCommands(*layerCommands[i], *output);
+	}
+}
+
+// Split the recorded layers into chunks of about chunkSegments path segments (returns the number of chunks)
+// Each chunk can then be formatted on its own (only when paths and geometry aren't being collected), so one huge layer can use many threads
+size_t DrawFunction::SplitDrawFunction(size_t chunkSegments)
+{
+	std::vector<size_t> ends;
+
+	for (size_t i = 0; i < layerCommands.size(); i++)
+	{
+		layerCommands[i]->Split(chunkSegments, ends);
+
+		size_t begin = 0;
+		for (size_t j = 0; j < ends.size(); j++)
+		{
+			Chunk chunk;
+			chunk.layer = i;
+			chunk.begin = begin;
+			chunk.end = ends[j];
+			chunk.output = new OutputStream(kFunctionChunkSize);
+			chunks.push_back(chunk);
+
+			begin = ends[j];
+		}
+	}
+
+	return chunks.size();
+}
+
+// Format one chunk (safe to call from any thread, at the same time as other chunks)
+void DrawFunction::FormatChunk(size_t index)
+{
+	TraceScope traceScope("DrawFunction::FormatChunk", name);
+
+	const Chunk& chunk = chunks[index];
+	layerCommands[chunk.layer]->RenderRange(*chunk.output, canvas->contextName, chunk.begin, chunk.end);
+}
+
+// Write the formatted function to the output file (chunks are stitched back together in order) and end the function block
+void DrawFunction::WriteDrawFunction()
+{
+	TraceScope traceScope("DrawFunction::WriteDrawFunction", name);
+
+	output->AppendTo(outFile);
+	delete output;
+	output = nullptr;
+
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		chunks[i].output->AppendTo(outFile);
+		delete chunks[i].output;
+	}
+	chunks.clear();
+
+	for (size_t i = 0; i < layerCommands.size(); i++)
+	{
+		delete layerCommands[i];
+	}
+	layerCommands.clear();
+
+	// End function block
+	outFile << "\n    }";
+
+	canvas->documentResources->removedStatements += removedStatements;
+	removedStatements = 0;
+}
+
+// Write the start of the function block and set up the function's transformation
+void DrawFunction::BeginFunctionBlock(OutputStream& stream, const AIRealRect& documentBounds)
 {
 	// Begin function block
-	outFile << "\n\n    function " << name << "(ctx) {";
+	stream << "\n\n    function " << name << "(" << exportOptions.ContextName() << ") {";
 
 	// Need a blank line?
 	if (hasAlpha || hasGradients || hasPatterns)
 	{
-		outFile << "\n";
+		stream << "\n";
 	}
 
 	// Does this draw function have alpha changes?
 	if (hasAlpha)
 	{
 		// Grab the alpha value (so we can use it to compute new globalAlpha values during this draw function)
-		outFile << "\n" << Indent(0) << "var alpha = ctx.globalAlpha;";
+		stream << "\n" << Indent(0) << "var alpha = " << exportOptions.ContextName() << ".globalAlpha;";
 	}
 
 	// Will we be encountering gradients?
 	if (hasGradients)
 	{
-		outFile << "\n" << Indent(0) << "var gradient;";
+		stream << "\n" << Indent(0) << "var gradient;";
 	}
 
 	// Will we be encountering patterns?
 	if (hasPatterns)
 	{
-		outFile << "\n" << Indent(0) << "var pattern;";
+		stream << "\n" << Indent(0) << "var pattern;";
 	}
 
 	/// Re-set matrix based on document
-	sAIRealMath->AIRealMatrixSetIdentity(&canvas->currentState->internalTransform);
-	sAIRealMath->AIRealMatrixConcatScale(&canvas->currentState->internalTransform, 1, -1);
-	sAIRealMath->AIRealMatrixConcatTranslate(&canvas->currentState->internalTransform, - 1 * documentBounds.left, documentBounds.top);
+	RealMatrixSetIdentity(&canvas->currentState->internalTransform);
+	RealMatrixConcatScale(&canvas->currentState->internalTransform, 1, -1);
+	RealMatrixConcatTranslate(&canvas->currentState->internalTransform, - 1 * documentBounds.left, documentBounds.top);
 
 	// Do we need to move the origin?
 	if (translateOrigin)
@@ -285,35 +481,8 @@ void DrawFunction::RenderDrawFunction(const AIRealRect& documentBounds)
 		AIReal translateV = (bounds.top - bounds.bottom) * translateOriginV;
 
 		// Modify transformation matrix for this function (and set of layers)
-		sAIRealMath->AIRealMatrixConcatTranslate(&canvas->currentState->internalTransform, (-1 * offsetH) - translateH, offsetV - translateV);
-	}
-
-	// Are we supposed to rasterize this function?
-	if (!rasterizeFileName.empty())
-	{
-		// Rasterize the first layer
-		// TODO: Note that this only rasterizes the first associated layer. What if this has multiple layers?
-
-		// Output layer name
-		outFile << "\n\n" << Indent(1) << "// " << name;
-
-		canvas->RenderUnsupportedArt(layers[0]->artHandle, rasterizeFileName, 1);
+		RealMatrixConcatTranslate(&canvas->currentState->internalTransform, (-1 * offsetH) - translateH, offsetV - translateV);
 	}
-	else
-	{
-		// Render each layer in the function block (they're already in the correct order)
-		for (unsigned int i = 0; i < layers.size(); i++)
-		{
-			// Render the art
-			canvas->RenderArt(layers[i]->artHandle, 1);
-	
-			// Restore remaining state
-			canvas->SetContextDrawingState(1);
-		}
-	}
-
-	// End function block
-	outFile << "\n    }";
 }
 
 // Output repositioning translation for a draw function
@@ -333,7 +502,7 @@ void DrawFunction::Reposition(const AIRealRect& documentBounds)
 
 	// Render the repositioning translation for this function
 	// NOTE: This needs to happen, even if it's just "identity," since other functions may have already changed the transformation
-	outFile <<   "\n      " << canvas->contextName << ".translate(" << setiosflags(ios::fixed) << setprecision(1) << x << ", " << y << ");";
+	outFile <<   "\n      " << canvas->contextName << ".translate(" << Fixed<1>(x) << ", " << Fixed<1>(y) << ");";
 }
 
 void DrawFunction::SetParameter(const std::string& parameter, const std::string& value)
@@ -411,8 +580,7 @@ void DrawFunction::SetParameter(const std::string& parameter, const std::string&
 
 				if (debug)
 				{
-					outFile << "\n//     translateH = " << setiosflags(ios::fixed) << setprecision(1) <<
-						this->translateOriginH << ", translateV = " << this->translateOriginV;
+					outFile << "\n//     translateH = " << Fixed<1>(this->translateOriginH) << ", translateV = " << Fixed<1>(this->translateOriginV);
 				}
 			}
 		}
@@ -561,8 +729,7 @@ void DrawFunction::SetParameter(const std::string& parameter, const std::string&
 
 			if (debug)
 			{
-				outFile << "\n//     Follow orientation = " << setiosflags(ios::fixed) << setprecision(2) <<
-					this->followOrientation << " degrees";
+				outFile << "\n//     Follow orientation = " << Fixed<2>(this->followOrientation) << " degrees";
 			}
 		}
 	}
@@ -30,11 +30,12 @@
 #include "Layer.h"
 #include "Utility.h"
 #include "AnimationClock.h"
+#include <atomic>
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a JavaScript drawing function
@@ -42,6 +43,19 @@ namespace CanvasExport
 	{
 	private:
 
+		struct Chunk
+		{
+			size_t				layer;				// Index into layerCommands
+			size_t				begin;				// Range of commands
+			size_t				end;
+			OutputStream*		output;				// Formatted commands
+		};
+
+		std::vector<Chunk>	chunks;					// Pieces of the recorded layers that are formatted separately (in order)
+
+		void				BeginFunctionBlock(OutputStream& stream, const AIRealRect& documentBounds);
+		void				RecordLayer();
+
 	public:
 
 		enum RotateDirection { kRotateNone, kRotateClockwise, kRotateCounterclockwise };
@@ -65,6 +79,12 @@ namespace CanvasExport
 		AnimationClock		scaleClock;				// Scale animation clock
 		AnimationClock		alphaClock;				// Alpha animation clock
 
+		OutputStream*		output;					// Formatted function, waiting to be written in order (when draw functions are recorded first)
+		std::vector<DrawCommands*>	layerCommands;	// Drawing commands recorded for each layer (waiting to be formatted)
+		size_t				removedStatements;		// Statements removed by the drawing command optimizer (while formatting)
+		std::atomic<bool>	isFormatted;			// Has a formatting thread finished with this function?
+		std::atomic<size_t>	pendingChunks;			// Chunks still being formatted
+
 		virtual void		RenderClockInit();		// Initialize animation clocks
 		virtual void		RenderTriggerInit();	// Initialize animation clock triggers
 		virtual void		RenderClockStart();		// Start animation clocks
@@ -74,6 +94,12 @@ namespace CanvasExport
 
 		void				RenderDrawFunctionCall(const AIRealRect& documentBounds);
 		void				RenderDrawFunction(const AIRealRect& documentBounds);
+		void				RecordDrawFunction(const AIRealRect& documentBounds);
+		void				OptimizeDrawFunction();
+		void				FormatDrawFunction();
+		size_t				SplitDrawFunction(size_t chunkSegments);
+		void				FormatChunk(size_t index);
+		void				WriteDrawFunction();
 		void				Reposition(const AIRealRect& documentBounds);
 		bool const			HasAnimation();			// Does this draw function have any animation?
 
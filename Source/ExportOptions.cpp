@@ -0,0 +1,321 @@
+// ExportOptions.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "ExportOptions.h"
+#include "Utility.h"
+#include <cmath>
+
+using namespace CanvasExport;
+
+// Finest quantization step (finer grids gain nothing visible and push coordinates past 32-bit steps)
+static const AIReal kMinimumGrid = 0.001;
+
+ExportOptions::ExportOptions()
+{
+	// Initialize ExportOptions
+	Reset();
+}
+
+ExportOptions::~ExportOptions()
+{
+}
+
+// Restore default options
+void ExportOptions::Reset()
+{
+	this->minify = false;
+	this->optimize = true;
+	this->path2d = false;
+	this->encoding = kEncodeNone;
+	this->grid = 0.1;
+	this->gzip = false;
+	this->trace = false;
+	this->stats = false;
+	this->profile = false;
+	this->colorTable = false;
+	this->threads = 0;
+}
+
+// Parse options in the same form as layer names (i.e. "minify: yes; ...")
+void ExportOptions::Parse(const std::string& optionValue)
+{
+	// Tokenize the options
+	std::vector<std::string> options = Tokenize(optionValue, ";");
+
+	// Loop through options
+	for (unsigned int i = 0; i < options.size(); i++)
+	{
+		// Split the parameter and value
+		std::vector<std::string> split = Tokenize(options[i], ":");
+
+		// Clean the parameter name
+		std::string parameter = split.size() > 0 ? split[0] : "";
+		CleanParameter(parameter);
+		ToLower(parameter);
+
+		// Clean the parameter value
+		std::string value = split.size() > 1 ? split[1] : "";
+		CleanParameter(value);
+		ToLower(value);
+
+		SetParameter(parameter, value);
+	}
+}
+
+void ExportOptions::SetParameter(const std::string& parameter, const std::string& value)
+{
+	// Restore defaults
+	if (parameter == "reset")
+	{
+		Reset();
+	}
+
+	// Minify
+	if (parameter == "minify" ||
+		parameter == "min")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->minify = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->minify = false;
+		}
+	}
+
+	// Optimize
+	if (parameter == "optimize" ||
+		parameter == "opt")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->optimize = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->optimize = false;
+		}
+	}
+
+	// Path2D
+	if (parameter == "path2d" ||
+		parameter == "paths")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->path2d = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->path2d = false;
+		}
+	}
+
+	// Encoding
+	if (parameter == "encode" ||
+		parameter == "encoding")
+	{
+		if (value == "typed")
+		{
+			this->encoding = kEncodeTyped;
+		}
+		else if (value == "quantized" ||
+				 value == "quantize")
+		{
+			this->encoding = kEncodeQuantized;
+		}
+		else if (value == "none" ||
+				 value == "no" ||
+				 value == "n")
+		{
+			this->encoding = kEncodeNone;
+		}
+	}
+
+	// Precompressed copies
+	if (parameter == "gzip" ||
+		parameter == "gz")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->gzip = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->gzip = false;
+		}
+	}
+
+	// Phase timings
+	if (parameter == "trace")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->trace = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->trace = false;
+		}
+	}
+
+	// Statistics
+	if (parameter == "stats" ||
+		parameter == "statistics")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->stats = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->stats = false;
+		}
+	}
+
+	// Suite call profile
+	if (parameter == "profile" ||
+		parameter == "prof")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->profile = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->profile = false;
+		}
+	}
+
+	// CMYK lookup table
+	if (parameter == "colortable" ||
+		parameter == "lut")
+	{
+		if (value == "yes" ||
+			value == "y")
+		{
+			this->colorTable = true;
+		}
+		else if (value == "no" ||
+				 value == "n")
+		{
+			this->colorTable = false;
+		}
+	}
+
+	// Formatting threads
+	if (parameter == "threads")
+	{
+		char* end = NULL;
+		long count = strtol(value.c_str(), &end, 10);
+		if (end != value.c_str() && count >= 0)
+		{
+			this->threads = (unsigned int)count;
+		}
+	}
+
+	// Quantization grid
+	if (parameter == "grid")
+	{
+		AIReal step = (AIReal)strtod(value.c_str(), NULL);
+		if (step > 0.0 && std::isfinite(step))
+		{
+			this->grid = (step < kMinimumGrid) ? kMinimumGrid : step;
+		}
+	}
+}
+
+// Report the current options (returned to scripts)
+std::string ExportOptions::Description() const
+{
+	std::string description;
+
+	description += "minify: ";
+	description += (minify ? "yes" : "no");
+
+	description += "; optimize: ";
+	description += (optimize ? "yes" : "no");
+
+	description += "; path2d: ";
+	description += (path2d ? "yes" : "no");
+
+	description += "; encode: ";
+	switch (encoding)
+	{
+		case kEncodeNone:
+		{
+			description += "none";
+			break;
+		}
+		case kEncodeTyped:
+		{
+			description += "typed";
+			break;
+		}
+		case kEncodeQuantized:
+		{
+			description += "quantized";
+			break;
+		}
+	}
+
+	std::ostringstream gridValue;
+	gridValue << grid;
+	description += "; grid: ";
+	description += gridValue.str();
+
+	description += "; gzip: ";
+	description += (gzip ? "yes" : "no");
+
+	description += "; trace: ";
+	description += (trace ? "yes" : "no");
+
+	description += "; stats: ";
+	description += (stats ? "yes" : "no");
+
+	description += "; profile: ";
+	description += (profile ? "yes" : "no");
+
+	description += "; colortable: ";
+	description += (colorTable ? "yes" : "no");
+
+	description += "; threads: ";
+	description += std::to_string(threads);
+
+	return description;
+}
@@ -0,0 +1,91 @@
+// ExportOptions.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef EXPORTOPTIONS_H
+#define EXPORTOPTIONS_H
+
+#include "IllustratorSDK.h"
+#include <string>
+
+namespace CanvasExport
+{
+	// Globals
+	extern bool debug;
+
+	/// Document-wide export options (set with the "Options" script command and kept for the session)
+	class ExportOptions
+	{
+	private:
+
+	public:
+
+		enum Encoding
+		{
+			kEncodeNone,					// Drawing commands are written as statements
+			kEncodeTyped,					// Path geometry is written as opcode bytes and Float32Array operands (base64)
+			kEncodeQuantized				// Paths are written as quantized, delta-encoded varints (base64) and built as Path2D objects
+		};
+
+		ExportOptions();
+		~ExportOptions();
+
+		bool				minify;						// Strip whitespace and comments, shorten names and numbers
+		bool				optimize;					// Remove redundant drawing commands
+		bool				path2d;						// Build each path once (as a Path2D) and draw it by reference
+		Encoding			encoding;					// How path geometry is written
+		AIReal				grid;						// Quantization step for kEncodeQuantized (in pixels)
+		bool				gzip;						// Also write precompressed (.gz) copies of exported files
+		bool				trace;						// Write export phase timings to trace.json (next to the exported file)
+		bool				stats;						// Write per art type and per layer statistics to a .stats.json file
+		bool				colorTable;					// Interpolate CMYK to RGB conversions from a lookup table (rather than converting each color)
+		bool				profile;					// Write SDK suite call counts and times to profile.txt (next to the exported file)
+		unsigned int		threads;					// Threads that format draw functions (0 for one per core, 1 to format on the main thread)
+
+		void				Reset();
+		void				Parse(const std::string& optionValue);
+		void				SetParameter(const std::string& parameter, const std::string& value);
+		std::string			Description() const;
+
+		/// Minified output is never used while debugging
+		inline bool			IsMinified() const	{ return (minify && !debug); }
+
+		/// Debug output shows the drawing commands as they were recorded
+		inline bool			IsOptimized() const	{ return (optimize && !debug); }
+
+		/// Debug output keeps paths inline, next to their comments
+		inline bool			IsPath2D() const	{ return ((path2d || encoding == kEncodeQuantized) && !debug); }
+
+		/// Name of the drawing context variable (an underscore can't appear in a cleaned layer or function name)
+		inline const char*	ContextName() const	{ return (IsMinified() ? "_c" : "ctx"); }
+
+		/// Debug output keeps drawing commands readable
+		inline Encoding		GetEncoding() const	{ return (debug ? kEncodeNone : encoding); }
+
+		/// Name of the array of Path2D objects
+		inline const char*	PathsName() const	{ return (IsMinified() ? "_p" : "paths"); }
+	};
+
+	// Globals
+	extern ExportOptions exportOptions;
+}
+
+#endif
@@ -25,12 +25,21 @@
 
 using namespace CanvasExport;
 
-FunctionCollection::FunctionCollection()
+// Path segments per formatting chunk (large layers are split, so they can be formatted by several threads)
+static const size_t kChunkSegments = 10000;
+
+// Draw functions that can be recorded ahead of the writer (bounds memory use)
+static const size_t kPipelineDepth = 16;
+
+FunctionCollection::FunctionCollection() : writeQueue(kPipelineDepth)
 {
 	// Initialize FunctionCollection
 	this->animationIndex = 0;
 	this->hasAnimationFunctions = false;
 	this->hasDrawFunctions = false;
+	this->isFetched = false;
+	this->sleepers = 0;
+	this->formatInParallel = false;
 }
 
 FunctionCollection::~FunctionCollection()
@@ -174,18 +183,190 @@ void FunctionCollection::RenderDrawFunctionCalls(const AIRealRect& documentBound
 	}
 }
 
+// Draw functions are rendered by a three-stage pipeline, so reading art, formatting and writing overlap:
+//   1. Fetch: this thread (the only one that uses the SDK) records each function's art
+//   2. Format: background threads optimize and format each recorded function into its own buffers
+//      (large layers are split into chunks, which idle threads steal, so even a single huge layer is formatted in parallel)
+//   3. Write: a writer thread appends the formatted functions to the output in order (full chunks go straight to disk)
+// Recorded functions reach the writer through a bounded, lock-free queue, so fetching never runs too far ahead
+// (a stage only takes the lock to sleep: when the queue is full, or the writer's next function isn't ready)
 void FunctionCollection::RenderDrawFunctions(const AIRealRect& documentBounds)
 {
-	// Loop through all draw functions
+	// Gather draw functions
+	recorded.clear();
 	for (unsigned int i = 0; i < functions.size(); i++)
 	{
 		// Draw function?
 		if (functions[i]->type == Function::kDrawFunction)
 		{
-			// Render the function
-			((DrawFunction*)functions[i])->RenderDrawFunction(documentBounds);
+			recorded.push_back((DrawFunction*)functions[i]);
+		}
+	}
+	if (recorded.empty())
+	{
+		return;
+	}
+
+	// Statistics time and measure each layer as it's written, so those exports are rendered one function at a time
+	if (recorded[0]->canvas->documentResources->statistics.IsEnabled())
+	{
+		for (size_t i = 0; i < recorded.size(); i++)
+		{
+			recorded[i]->RenderDrawFunction(documentBounds);
+		}
+		recorded.clear();
+		return;
+	}
+
+	// Paths and geometry are numbered in the order they're written, so when they're collected, only optimization happens in parallel
+	formatInParallel = (!exportOptions.IsPath2D() && exportOptions.GetEncoding() != ExportOptions::kEncodeTyped);
+
+	size_t threadCount = exportOptions.threads;
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if (!formatInParallel && threadCount > recorded.size())
+	{
+		threadCount = recorded.size();
+	}
+
+	// Not worth any threads?
+	if (threadCount <= 1)
+	{
+		for (size_t i = 0; i < recorded.size(); i++)
+		{
+			recorded[i]->RecordDrawFunction(documentBounds);
+			recorded[i]->OptimizeDrawFunction();
+			recorded[i]->FormatDrawFunction();
+			recorded[i]->WriteDrawFunction();
 		}
+		recorded.clear();
+		return;
 	}
+
+	// Start the format and write stages
+	TaskScheduler scheduler(threadCount);
+	isFetched = false;
+	std::thread writer(&FunctionCollection::WriteDrawFunctions, this);
+
+	// Fetch
+	for (size_t i = 0; i < recorded.size(); i++)
+	{
+		DrawFunction* drawFunction = recorded[i];
+		drawFunction->isFormatted = false;
+		drawFunction->RecordDrawFunction(documentBounds);
+
+		// Wait for room (the writer is still busy with earlier functions)
+		Wait([this] { return !writeQueue.IsFull(); });
+		writeQueue.Push(drawFunction);
+		Signal();
+
+		scheduler.Add([this, drawFunction, &scheduler] { FormatDrawFunction(drawFunction, scheduler); });
+	}
+
+	isFetched = true;
+	Signal();
+
+	writer.join();
+	scheduler.Finish();
+	recorded.clear();
+}
+
+// Write stage: write recorded functions in order, as each one is formatted
+void FunctionCollection::WriteDrawFunctions()
+{
+	for (;;)
+	{
+		// Wait for the next function to be formatted (or for the end)
+		// (isFetched is read first, so once it's set, the queue is known to hold every remaining function)
+		DrawFunction* drawFunction = nullptr;
+		Wait([&]
+		{
+			bool isEnd = isFetched.load();
+			return (writeQueue.Front(drawFunction) ? drawFunction->isFormatted.load() : isEnd);
+		});
+
+		// Everything has been fetched and written?
+		if (!writeQueue.Pop(drawFunction))
+		{
+			return;
+		}
+		Signal();
+
+		if (!formatInParallel)
+		{
+			drawFunction->FormatDrawFunction();
+		}
+		drawFunction->WriteDrawFunction();
+	}
+}
+
+// Sleep until isReady returns true (it's checked without the lock first, so a stage only sleeps when it has to)
+void FunctionCollection::Wait(const std::function<bool()>& isReady)
+{
+	if (isReady())
+	{
+		return;
+	}
+
+	// Count this stage as a sleeper before checking again, so a change made after the check is always signaled
+	std::unique_lock<std::mutex> lock(mutex);
+	sleepers++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	changed.wait(lock, isReady);
+	sleepers--;
+}
+
+// Wake any stage that's waiting (only takes the lock if a stage is, or is about to be, asleep)
+// Either the fence here comes first, and a sleeper that checks afterwards sees the change,
+// or the sleeper's fence comes first, and it's counted here (the lock makes sure it's asleep before it's notified)
+void FunctionCollection::Signal()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleepers.load(std::memory_order_relaxed) > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		changed.notify_all();
+	}
+}
+
+// Optimize a recorded draw function, then (if possible) add a task for each of its chunks
+void FunctionCollection::FormatDrawFunction(DrawFunction* drawFunction, TaskScheduler& scheduler)
+{
+	drawFunction->OptimizeDrawFunction();
+
+	size_t chunkCount = formatInParallel ? drawFunction->SplitDrawFunction(kChunkSegments) : 0;
+	if (chunkCount == 0)
+	{
+		SetFormatted(drawFunction);
+		return;
+	}
+
+	drawFunction->pendingChunks = chunkCount;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		scheduler.Add([this, drawFunction, i] { FormatChunk(drawFunction, i); });
+	}
+}
+
+// Format a chunk (the last chunk to finish marks its function as formatted)
+void FunctionCollection::FormatChunk(DrawFunction* drawFunction, size_t index)
+{
+	drawFunction->FormatChunk(index);
+
+	if (--drawFunction->pendingChunks == 0)
+	{
+		SetFormatted(drawFunction);
+	}
+}
+
+void FunctionCollection::SetFormatted(DrawFunction* drawFunction)
+{
+	drawFunction->isFormatted = true;
+	Signal();
 }
 
 void FunctionCollection::RenderAnimationFunctionInits(const AIRealRect& documentBounds)
@@ -684,7 +865,7 @@ void FunctionCollection::DebugInfo()
 
 				outFile <<   "\n  <li>name: " << animationFunction->name << ", index: " << animationFunction->index <<
 							 ", segments: " << animationFunction->beziers.size() <<
-							 ", linear segment length: " << setiosflags(ios::fixed) << setprecision(1) << animationFunction->segmentLength << "</li>";
+							 ", linear segment length: " << Fixed<1>(animationFunction->segmentLength) << "</li>";
 			}
 		}
 
@@ -28,11 +28,17 @@
 #include "AnimationFunction.h"
 #include "DrawFunction.h"
 #include "Utility.h"
+#include "TaskScheduler.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a collection of functions
@@ -44,6 +50,21 @@ namespace CanvasExport
 		bool						hasAnimationFunctions;	// Does the collection include at least one animation function?
 		bool						hasDrawFunctions;		// Does the collection include at least one draw function?
 
+		std::vector<DrawFunction*>	recorded;				// Draw functions being rendered (in order)
+		SpscQueue<DrawFunction*>	writeQueue;				// Recorded draw functions, in the order they're written (from the fetch thread to the writer)
+		std::atomic<bool>			isFetched;				// Has every draw function been recorded?
+		bool						formatInParallel;		// Can formatting threads also write (not just optimize)?
+		std::mutex					mutex;					// Only used to sleep and wake pipeline stages
+		std::condition_variable		changed;
+		std::atomic<unsigned int>	sleepers;				// Stages that are (about to be) waiting for a change
+
+		void						FormatDrawFunction(DrawFunction* drawFunction, TaskScheduler& scheduler);
+		void						FormatChunk(DrawFunction* drawFunction, size_t index);
+		void						SetFormatted(DrawFunction* drawFunction);
+		void						WriteDrawFunctions();
+		void						Wait(const std::function<bool()>& isReady);
+		void						Signal();
+
 	public:
 
 		FunctionCollection();
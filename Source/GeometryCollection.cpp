@@ -0,0 +1,109 @@
+// GeometryCollection.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "GeometryCollection.h"
+#include <cstring>
+
+using namespace CanvasExport;
+
+GeometryCollection::GeometryCollection()
+{
+}
+
+GeometryCollection::~GeometryCollection()
+{
+}
+
+void GeometryCollection::AddOpcode(unsigned char opcode)
+{
+	opcodes.push_back(opcode);
+}
+
+void GeometryCollection::AddOperands(const AIReal* values, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		operands.push_back((float)values[i]);
+	}
+}
+
+// Render the encoded data and the functions that decode and replay it (decoding is called from init)
+void GeometryCollection::Render()
+{
+	// Operands are written as little-endian 32-bit floats (the byte order of Float32Array on all supported platforms)
+	std::vector<unsigned char> operandBytes(operands.size() * sizeof(float));
+	if (!operands.empty())
+	{
+		memcpy(operandBytes.data(), operands.data(), operandBytes.size());
+	}
+
+	outFile << "\n\n    // Encoded drawing commands (decoded once, then replayed by draw functions)";
+	outFile <<   "\n    var opcodes;";
+	outFile <<   "\n    var operands;";
+
+	outFile << "\n\n    function initGeometry() {";
+	outFile <<   "\n      opcodes = decodeBase64(\"" << EncodeBase64(opcodes.data(), opcodes.size()) << "\");";
+	outFile <<   "\n      operands = new Float32Array(decodeBase64(\"" << EncodeBase64(operandBytes.data(), operandBytes.size()) << "\").buffer);";
+	outFile <<   "\n    }";
+
+	RenderDecodeBase64();
+
+	RenderReplayFunction();
+}
+
+// Replays opcodes [start, end), reading operands from index
+void GeometryCollection::RenderReplayFunction()
+{
+	outFile << "\n\n    function replay(ctx, start, end, index, styles) {";
+	outFile <<   "\n      var v = operands;";
+	outFile <<   "\n      var caps = [\"butt\", \"round\", \"square\"];";
+	outFile <<   "\n      var joins = [\"miter\", \"round\", \"bevel\"];";
+	outFile <<   "\n      for (var i = start; i < end; i++) {";
+	outFile <<   "\n        switch (opcodes[i]) {";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandSave << ": ctx.save(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandRestore << ": ctx.restore(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandBeginPath << ": ctx.beginPath(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandMoveTo << ": ctx.moveTo(v[index], v[index + 1]); index += 2; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandLineTo << ": ctx.lineTo(v[index], v[index + 1]); index += 2; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandBezierCurveTo << ": ctx.bezierCurveTo(v[index], v[index + 1], v[index + 2], v[index + 3], v[index + 4], v[index + 5]); index += 6; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandClosePath << ": ctx.closePath(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandClip << ": ctx.clip(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandFill << ": ctx.fill(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandFillEvenOdd << ": ctx.fill(\"evenodd\"); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandStroke << ": ctx.stroke(); break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandFillStyle << ": ctx.fillStyle = styles[v[index++]]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandStrokeStyle << ": ctx.strokeStyle = styles[v[index++]]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandLineWidth << ": ctx.lineWidth = v[index++]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandLineCap << ": ctx.lineCap = caps[v[index++]]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandLineJoin << ": ctx.lineJoin = joins[v[index++]]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandMiterLimit << ": ctx.miterLimit = v[index++]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandShadowColor << ": ctx.shadowColor = styles[v[index++]]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandShadowOffsetX << ": ctx.shadowOffsetX = v[index++]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandShadowOffsetY << ": ctx.shadowOffsetY = v[index++]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandShadowBlur << ": ctx.shadowBlur = v[index++]; break;";
+	outFile <<   "\n          case " << (int)DrawCommands::kCommandTransform << ": ctx.transform(v[index], v[index + 1], v[index + 2], v[index + 3], v[index + 4], v[index + 5]); index += 6; break;";
+	outFile <<   "\n        }";
+	outFile <<   "\n      }";
+	outFile <<   "\n    }";
+}
@@ -0,0 +1,62 @@
+// GeometryCollection.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef GEOMETRYCOLLECTION_H
+#define GEOMETRYCOLLECTION_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "DrawCommands.h"
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Represents drawing commands that are encoded as binary data (decoded once, then replayed by draw functions)
+	class GeometryCollection
+	{
+	private:
+
+		std::vector<unsigned char>	opcodes;			// One byte per command (DrawCommands::Opcode)
+		std::vector<float>			operands;			// Numeric operands, in command order
+
+		void					RenderReplayFunction();
+
+	public:
+
+		GeometryCollection();
+		~GeometryCollection();
+
+		inline size_t			OpcodeCount() const		{ return opcodes.size(); }
+		inline size_t			OperandCount() const	{ return operands.size(); }
+
+		void					AddOpcode(unsigned char opcode);
+		void					AddOperands(const AIReal* values, size_t count);
+		void					Render();
+
+	};
+}
+
+#endif
@@ -0,0 +1,235 @@
+// Gzip.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "Gzip.h"
+#include <zlib.h>
+
+using namespace CanvasExport;
+
+// Compressed output is written in 256 KB pieces
+static const size_t kOutputSize = 256 * 1024;
+
+// Add 16 to the window size for a gzip (RFC 1952) header and trailer, rather than zlib's
+static const int kGzipWindowBits = 15 + 16;
+static const int kMemoryLevel = 8;
+
+GzipWriter::GzipWriter()
+{
+	// Initialize GzipWriter
+	this->stream = NULL;
+	this->file = NULL;
+	this->compressedBlocks = 0;
+	this->isClosing = false;
+	this->failed = false;
+}
+
+GzipWriter::~GzipWriter()
+{
+	Close();
+}
+
+// Create the compressed file and start the compression thread
+bool GzipWriter::Open(const std::string& filePath)
+{
+	Close();
+
+	file = fopen(filePath.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	stream = new z_stream();
+	if (deflateInit2(stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits, kMemoryLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		delete stream;
+		stream = NULL;
+		fclose(file);
+		file = NULL;
+		return false;
+	}
+
+	output.resize(kOutputSize);
+	compressedBlocks = 0;
+	isClosing = false;
+	failed = false;
+	thread = std::thread(&GzipWriter::Run, this);
+
+	return true;
+}
+
+bool GzipWriter::IsOpen() const
+{
+	return (file != NULL);
+}
+
+// Queue data for compression
+void GzipWriter::Add(const char* data, size_t size)
+{
+	if (file && size > 0)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Block block = { data, size };
+		pending.push_back(block);
+		ready.notify_one();
+	}
+}
+
+// Number of blocks that have been compressed (their data can be reused)
+size_t GzipWriter::CompressedBlocks()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return compressedBlocks;
+}
+
+// Wait until at least count blocks have been compressed
+void GzipWriter::WaitForBlocks(size_t count)
+{
+	if (file)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		compressed.wait(lock, [&] { return (compressedBlocks >= count); });
+	}
+}
+
+// Wait for everything to be compressed, then close the file
+bool GzipWriter::Close()
+{
+	if (!file)
+	{
+		return true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isClosing = true;
+		ready.notify_one();
+	}
+	thread.join();
+
+	deflateEnd(stream);
+	delete stream;
+	stream = NULL;
+
+	bool result = (fclose(file) == 0) && !failed;
+	file = NULL;
+
+	return result;
+}
+
+// Compression thread
+void GzipWriter::Run()
+{
+	for (;;)
+	{
+		Block block;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this] { return (!pending.empty() || isClosing); });
+			if (pending.empty())
+			{
+				break;
+			}
+			block = pending.front();
+			pending.pop_front();
+		}
+
+		Deflate(block.data, block.size, false);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			compressedBlocks++;
+		}
+		compressed.notify_all();
+	}
+
+	// Write the end of the stream (and the gzip trailer)
+	Deflate(NULL, 0, true);
+}
+
+// Compress data and write whatever output it produces (zlib keeps its own copy of the input it still needs)
+void GzipWriter::Deflate(const char* data, size_t size, bool isLast)
+{
+	// (zlib takes 32-bit sizes)
+	do
+	{
+		uInt count = (size > 0x40000000) ? 0x40000000 : (uInt)size;
+		stream->next_in = (Bytef*)data;
+		stream->avail_in = count;
+		data += count;
+		size -= count;
+
+		int flush = (isLast && size == 0) ? Z_FINISH : Z_NO_FLUSH;
+		int result = Z_OK;
+		do
+		{
+			stream->next_out = output.data();
+			stream->avail_out = (uInt)output.size();
+			result = deflate(stream, flush);
+			if (result == Z_STREAM_ERROR)
+			{
+				failed = true;
+				return;
+			}
+
+			size_t produced = output.size() - stream->avail_out;
+			if (produced > 0 && fwrite(output.data(), 1, produced, file) != produced)
+			{
+				failed = true;
+			}
+		}
+		while (stream->avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+	}
+	while (size > 0);
+}
+
+// Write a gzip-compressed copy of a file
+bool CanvasExport::CompressFile(const std::string& sourcePath, const std::string& destinationPath)
+{
+	FILE* source = fopen(sourcePath.c_str(), "rb");
+	if (!source)
+	{
+		return false;
+	}
+
+	gzFile destination = gzopen(destinationPath.c_str(), "wb");
+	if (!destination)
+	{
+		fclose(source);
+		return false;
+	}
+
+	bool result = true;
+	std::vector<char> buffer(kOutputSize);
+	size_t count = 0;
+	while (result && (count = fread(buffer.data(), 1, buffer.size(), source)) > 0)
+	{
+		result = (gzwrite(destination, buffer.data(), (unsigned int)count) == (int)count);
+	}
+	result = !ferror(source) && result;
+	fclose(source);
+
+	result = (gzclose(destination) == Z_OK) && result;
+
+	return result;
+}
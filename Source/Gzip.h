@@ -0,0 +1,83 @@
+// Gzip.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef GZIP_H
+#define GZIP_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// zlib's stream state (zlib.h is only included by Gzip.cpp)
+struct z_stream_s;
+
+namespace CanvasExport
+{
+	/// Writes a gzip-compressed copy of a stream on a background thread (compression is done by zlib)
+	/// Data passed to Add must stay unchanged until it's been compressed (see CompressedBlocks) or Close returns
+	class GzipWriter
+	{
+	private:
+
+		struct Block
+		{
+			const char*		data;
+			size_t			size;
+		};
+
+		z_stream_s*			stream;						// Deflate state (while a file is open)
+		std::vector<unsigned char>	output;				// Compressed output, written as it fills
+		FILE*				file;
+		std::thread			thread;
+		std::mutex			mutex;
+		std::condition_variable	ready;
+		std::condition_variable	compressed;
+		std::deque<Block>	pending;					// Blocks waiting to be compressed
+		size_t				compressedBlocks;			// Blocks compressed since the file was opened (in the order they were added)
+		bool				isClosing;					// No more blocks will be added
+		bool				failed;						// Was there a write or compression error?
+
+		void				Run();
+		void				Deflate(const char* data, size_t size, bool isLast);
+
+	public:
+
+		GzipWriter();
+		~GzipWriter();
+
+		bool				Open(const std::string& filePath);
+		bool				IsOpen() const;
+		void				Add(const char* data, size_t size);
+		size_t				CompressedBlocks();
+		void				WaitForBlocks(size_t count);
+		bool				Close();
+	};
+
+	bool CompressFile(const std::string& sourcePath, const std::string& destinationPath);
+}
+
+#endif
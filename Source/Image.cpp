@@ -47,9 +47,8 @@ void Image::Render()
 std::string Image::Uri()
 {
 	// Create file URI
-	ai::UnicodeString usPath(path);
-	ai::FilePath aiFilePath(usPath);
-	std::string uri = aiFilePath.GetAsURL(false).as_Platform();
+	std::string uri;
+	artSource->GetFileURL(path, uri);
 
 	// Firefox doesn't like local "file:" references
 	if (!pathIsAbsolute && uri.length() >= 5 && uri.substr(0, 5) == "file:")
@@ -68,25 +67,22 @@ std::string Image::Uri()
 	return uri;
 }
 
-void Image::RenderDrawImage(const std::string& contextName, const AIReal x, const AIReal y)
+void Image::RenderDrawImage(DrawCommands& commands, const AIReal x, const AIReal y)
 {
 	// Draw image
-	outFile << "\n" << Indent(0) << contextName << ".drawImage(document.getElementById(\"" << id << "\"), " <<
-		setiosflags(ios::fixed) << setprecision(1) <<
-		x << ", " << y << ");";
+	commands.DrawImage(0, id, x, y);
 }
 
-void Image::DebugBounds(const std::string& contextName, const AIRealRect& bounds)
+void Image::DebugBounds(DrawCommands& commands, const std::string& contextName, const AIRealRect& bounds)
 {
 	if (debug)
 	{
 		// Stroke bounds	
-		outFile << "\n" << Indent(0) << contextName << ".save();";
-		outFile << "\n" << Indent(0) << contextName << ".lineWidth = 1.0;";
-		outFile << "\n" << Indent(0) << contextName << ".strokeStyle = \"rgb(255, 0, 0)\";";
-		outFile << "\n" << Indent(0) << contextName << ".strokeRect(" <<
-			setiosflags(ios::fixed) << setprecision(1) <<
-			bounds.left << ", " << bounds.top << ", " << (bounds.right - bounds.left) << ", " << (bounds.bottom - bounds.top) << ");";
-		outFile << "\n" << Indent(0) << contextName << ".restore();";
+		commands.Text() << "\n" << Indent(0) << contextName << ".save();";
+		commands.Text() << "\n" << Indent(0) << contextName << ".lineWidth = 1.0;";
+		commands.Text() << "\n" << Indent(0) << contextName << ".strokeStyle = \"rgb(255, 0, 0)\";";
+		commands.Text() << "\n" << Indent(0) << contextName << ".strokeRect(" <<
+			Fixed<1>(bounds.left) << ", " << Fixed<1>(bounds.top) << ", " << Fixed<1>(bounds.right - bounds.left) << ", " << Fixed<1>(bounds.bottom - bounds.top) << ");";
+		commands.Text() << "\n" << Indent(0) << contextName << ".restore();";
 	}
 }
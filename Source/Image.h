@@ -25,11 +25,12 @@
 
 #include "IllustratorSDK.h"
 #include "Utility.h"
+#include "DrawCommands.h"
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a bitmap image
@@ -49,8 +50,8 @@ namespace CanvasExport
 		bool					pathIsAbsolute;		// Is this an absolute image path?
 
 		void					Render();
-		void					RenderDrawImage(const std::string& contextName, const AIReal x, const AIReal y);
-		void					DebugBounds(const std::string& contextName, const AIRealRect& bounds);
+		void					RenderDrawImage(DrawCommands& commands, const AIReal x, const AIReal y);
+		void					DebugBounds(DrawCommands& commands, const std::string& contextName, const AIRealRect& bounds);
 		std::string				Uri();
 
 	};
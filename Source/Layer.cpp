@@ -21,7 +21,6 @@
 // THE SOFTWARE.
 
 #include "IllustratorSDK.h"
-#include "Ai2CanvasSuites.h"
 #include "Layer.h"
 
 using namespace CanvasExport;
@@ -55,11 +54,11 @@ Layer::~Layer()
 Layer* CanvasExport::AddLayer(std::vector<Layer*>& layers, const AILayerHandle& layerHandle)
 {
 	// Get layer name
-	ai::UnicodeString layerName;
-	sAILayer->GetLayerTitle(layerHandle, layerName);
+	std::string layerName;
+	artSource->GetLayerTitle(layerHandle, layerName);
 	if (debug)
 	{
-		outFile << "\n//   Layer name = " << layerName.as_Platform();
+		outFile << "\n//   Layer name = " << layerName;
 	}
 
 	// Create a new layer
@@ -67,7 +66,7 @@ Layer* CanvasExport::AddLayer(std::vector<Layer*>& layers, const AILayerHandle&
 	
 	// Set values
 	layer->layerHandle = layerHandle;
-	layer->name = layerName.as_Platform();
+	layer->name = layerName;
 
 	// Add to document
 	layers.push_back(layer);
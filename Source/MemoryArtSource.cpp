@@ -0,0 +1,537 @@
+// MemoryArtSource.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "MemoryArtSource.h"
+#include <cstring>
+
+using namespace CanvasExport;
+
+MemoryArtSource::MemoryArtSource()
+{
+}
+
+MemoryArtSource::~MemoryArtSource()
+{
+}
+
+// Remove everything (invalidates all handles)
+void MemoryArtSource::Clear()
+{
+	art.clear();
+	layers.clear();
+	gradients.clear();
+	patterns.clear();
+}
+
+// Layers are numbered in the order they're added (so the first is the top layer)
+AILayerHandle MemoryArtSource::AddLayer(const std::string& title, bool visible)
+{
+	MemoryLayer layer;
+	layer.title = title;
+	layer.visible = visible;
+	layer.firstArt = nullptr;
+	layer.lastArt = nullptr;
+	layers.push_back(layer);
+
+	return reinterpret_cast<AILayerHandle>(&layers.back());
+}
+
+// Art is added after (i.e. above) any existing art in the layer or group
+AIArtHandle MemoryArtSource::AddArt(AILayerHandle layer, short type)
+{
+	MemoryLayer* memoryLayer = reinterpret_cast<MemoryLayer*>(layer);
+	return ToHandle(NewArt(type, memoryLayer->firstArt, memoryLayer->lastArt));
+}
+
+AIArtHandle MemoryArtSource::AddArt(AIArtHandle parent, short type)
+{
+	MemoryArt* parentArt = ToArt(parent);
+	MemoryArt* memoryArt = NewArt(type, parentArt->firstChild, parentArt->lastChild);
+
+	// Paths inside a compound path are drawn as part of it
+	if (parentArt->type == kCompoundPathArt)
+	{
+		memoryArt->userAttr |= kArtPartOfCompound;
+	}
+
+	return ToHandle(memoryArt);
+}
+
+MemoryArtSource::MemoryArt* MemoryArtSource::NewArt(short type, MemoryArt*& first, MemoryArt*& last)
+{
+	MemoryArt memoryArt;
+	memoryArt.type = type;
+	memoryArt.userAttr = 0;
+	memoryArt.opacity = 1.0;
+	memoryArt.blendingMode = kAINormalBlendingMode;
+	memoryArt.closed = false;
+	memset(&memoryArt.style, 0, sizeof(memoryArt.style));
+	memoryArt.symbolPattern = nullptr;
+	RealMatrixSetIdentity(&memoryArt.matrix);
+	memset(&memoryArt.rasterInfo, 0, sizeof(memoryArt.rasterInfo));
+	memoryArt.hasBounds = false;
+	memset(&memoryArt.bounds, 0, sizeof(memoryArt.bounds));
+	memoryArt.firstChild = nullptr;
+	memoryArt.lastChild = nullptr;
+	memoryArt.sibling = nullptr;
+	art.push_back(memoryArt);
+
+	MemoryArt* added = &art.back();
+	if (last)
+	{
+		last->sibling = added;
+	}
+	else
+	{
+		first = added;
+	}
+	last = added;
+
+	return added;
+}
+
+void MemoryArtSource::SetPath(AIArtHandle path, const std::vector<AIPathSegment>& segments, bool closed)
+{
+	ToArt(path)->segments = segments;
+	ToArt(path)->closed = closed;
+}
+
+void MemoryArtSource::SetPathStyle(AIArtHandle art, const AIPathStyle& style)
+{
+	ToArt(art)->style = style;
+}
+
+void MemoryArtSource::SetArtName(AIArtHandle art, const std::string& name)
+{
+	ToArt(art)->name = name;
+}
+
+void MemoryArtSource::SetArtUserAttr(AIArtHandle art, ai::int32 attr)
+{
+	ToArt(art)->userAttr = attr;
+}
+
+void MemoryArtSource::SetOpacity(AIArtHandle art, AIReal opacity)
+{
+	ToArt(art)->opacity = opacity;
+}
+
+void MemoryArtSource::SetBlendingMode(AIArtHandle art, AIBlendingMode blendingMode)
+{
+	ToArt(art)->blendingMode = blendingMode;
+}
+
+// Gradients are referenced by path styles (stops are in ramp order)
+AIGradientHandle MemoryArtSource::AddGradient(short type, const std::vector<AIGradientStop>& stops)
+{
+	MemoryGradient gradient;
+	gradient.type = type;
+	gradient.stops = stops;
+	gradients.push_back(gradient);
+
+	return reinterpret_cast<AIGradientHandle>(&gradients.back());
+}
+
+// Patterns are referenced by path styles (add art to the group returned by GetPatternArt)
+AIPatternHandle MemoryArtSource::AddPattern(const std::string& name)
+{
+	MemoryPattern pattern;
+	pattern.name = name;
+	pattern.art = nullptr;
+	patterns.push_back(pattern);
+
+	MemoryPattern* added = &patterns.back();
+	MemoryArt* last = nullptr;
+	NewArt(kGroupArt, added->art, last);
+
+	return reinterpret_cast<AIPatternHandle>(added);
+}
+
+// Symbol bounds are the pattern art bounds, transformed (so add the pattern art first)
+void MemoryArtSource::SetSymbol(AIArtHandle symbol, AIPatternHandle pattern, const AIRealMatrix& transform)
+{
+	MemoryArt* memoryArt = ToArt(symbol);
+	memoryArt->symbolPattern = pattern;
+	memoryArt->matrix = transform;
+
+	AIRealRect patternBounds = { 0.0, 0.0, 0.0, 0.0 };
+	bool hasPatternBounds = false;
+	AddBounds(reinterpret_cast<MemoryPattern*>(pattern)->art, patternBounds, hasPatternBounds);
+
+	AIRealRect bounds = { 0.0, 0.0, 0.0, 0.0 };
+	bool hasBounds = false;
+	if (hasPatternBounds)
+	{
+		AddBounds(patternBounds, transform, bounds, hasBounds);
+	}
+	SetArtBounds(symbol, bounds);
+}
+
+// The raster bounds are in pixels (top-left origin), and the matrix places them in the document
+void MemoryArtSource::SetPlaced(AIArtHandle placed, const std::string& filePath, const AIRealMatrix& matrix, const AIRasterRecord& info)
+{
+	MemoryArt* memoryArt = ToArt(placed);
+	memoryArt->filePath = filePath;
+	memoryArt->matrix = matrix;
+	memoryArt->rasterInfo = info;
+
+	AIRealRect rasterBounds = { (AIReal)info.bounds.left, (AIReal)info.bounds.top, (AIReal)info.bounds.right, (AIReal)info.bounds.bottom };
+	AIRealRect bounds = { 0.0, 0.0, 0.0, 0.0 };
+	bool hasBounds = false;
+	AddBounds(rasterBounds, matrix, bounds, hasBounds);
+	SetArtBounds(placed, bounds);
+}
+
+// Text has no segments, so set its bounds with SetArtBounds
+void MemoryArtSource::SetTextFrame(AIArtHandle text, const TextFrame& textFrame)
+{
+	ToArt(text)->textFrame = textFrame;
+}
+
+void MemoryArtSource::SetArtBounds(AIArtHandle art, const AIRealRect& bounds)
+{
+	ToArt(art)->hasBounds = true;
+	ToArt(art)->bounds = bounds;
+}
+
+AIErr MemoryArtSource::CountLayers(ai::int32* count)
+{
+	*count = (ai::int32)layers.size();
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetNthLayer(ai::int32 n, AILayerHandle* layer)
+{
+	if (n < 0 || n >= (ai::int32)layers.size())
+	{
+		*layer = nullptr;
+		return kBadParameterErr;
+	}
+
+	*layer = reinterpret_cast<AILayerHandle>(&layers[n]);
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetLayerVisible(AILayerHandle layer, AIBoolean* visible)
+{
+	*visible = reinterpret_cast<MemoryLayer*>(layer)->visible;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetLayerTitle(AILayerHandle layer, std::string& title)
+{
+	title = reinterpret_cast<MemoryLayer*>(layer)->title;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art)
+{
+	*art = ToHandle(reinterpret_cast<MemoryLayer*>(layer)->firstArt);
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetArtFirstChild(AIArtHandle art, AIArtHandle* child)
+{
+	*child = art ? ToHandle(ToArt(art)->firstChild) : nullptr;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr MemoryArtSource::GetArtSibling(AIArtHandle art, AIArtHandle* sibling)
+{
+	*sibling = art ? ToHandle(ToArt(art)->sibling) : nullptr;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr MemoryArtSource::GetArtType(AIArtHandle art, short* type)
+{
+	*type = art ? ToArt(art)->type : (short)kUnknownArt;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr MemoryArtSource::GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr)
+{
+	*attr = art ? (ToArt(art)->userAttr & whichAttr) : 0;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr MemoryArtSource::GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName)
+{
+	name = ToArt(art)->name;
+	if (isDefaultName)
+	{
+		*isDefaultName = name.empty();
+	}
+	return kNoErr;
+}
+
+// Path bounds include control points (Illustrator uses the curves themselves), and set bounds are used as-is
+AIErr MemoryArtSource::GetArtBounds(AIArtHandle art, AIRealRect* bounds)
+{
+	AIRealRect result = { 0.0, 0.0, 0.0, 0.0 };
+	bool hasBounds = false;
+	AddBounds(ToArt(art), result, hasBounds);
+
+	*bounds = result;
+	return kNoErr;
+}
+
+// Expand bounds to include art (top is the maximum vertical coordinate, as in Illustrator)
+void MemoryArtSource::AddBounds(const MemoryArt* memoryArt, AIRealRect& bounds, bool& hasBounds) const
+{
+	if (memoryArt->hasBounds)
+	{
+		AIRealMatrix identity;
+		RealMatrixSetIdentity(&identity);
+		AddBounds(memoryArt->bounds, identity, bounds, hasBounds);
+	}
+
+	for (size_t i = 0; i < memoryArt->segments.size(); i++)
+	{
+		AddBoundsPoint(memoryArt->segments[i].p, bounds, hasBounds);
+		AddBoundsPoint(memoryArt->segments[i].in, bounds, hasBounds);
+		AddBoundsPoint(memoryArt->segments[i].out, bounds, hasBounds);
+	}
+
+	for (const MemoryArt* child = memoryArt->firstChild; child; child = child->sibling)
+	{
+		AddBounds(child, bounds, hasBounds);
+	}
+}
+
+// Expand bounds to include the four corners of a transformed rectangle
+void MemoryArtSource::AddBounds(const AIRealRect& rect, const AIRealMatrix& matrix, AIRealRect& bounds, bool& hasBounds) const
+{
+	const AIRealPoint corners[4] = { { rect.left, rect.top }, { rect.right, rect.top }, { rect.right, rect.bottom }, { rect.left, rect.bottom } };
+	for (int i = 0; i < 4; i++)
+	{
+		AIRealPoint point;
+		RealPointTransform(&corners[i], &matrix, &point);
+		AddBoundsPoint(point, bounds, hasBounds);
+	}
+}
+
+void MemoryArtSource::AddBoundsPoint(const AIRealPoint& point, AIRealRect& bounds, bool& hasBounds)
+{
+	if (!hasBounds)
+	{
+		bounds.left = bounds.right = point.h;
+		bounds.top = bounds.bottom = point.v;
+		hasBounds = true;
+	}
+	else
+	{
+		if (point.h < bounds.left) bounds.left = point.h;
+		if (point.h > bounds.right) bounds.right = point.h;
+		if (point.v > bounds.top) bounds.top = point.v;
+		if (point.v < bounds.bottom) bounds.bottom = point.v;
+	}
+}
+
+AIReal MemoryArtSource::GetOpacity(AIArtHandle art)
+{
+	return ToArt(art)->opacity;
+}
+
+AIBlendingMode MemoryArtSource::GetBlendingMode(AIArtHandle art)
+{
+	return ToArt(art)->blendingMode;
+}
+
+// No art style, so no Live Effects
+AIErr MemoryArtSource::GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects)
+{
+	liveEffects.clear();
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetMask(AIArtHandle art, AIMaskRef* mask)
+{
+	*mask = nullptr;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping)
+{
+	*clipping = false;
+	return kNoErr;
+}
+
+bool MemoryArtSource::CanRasterize()
+{
+	return false;
+}
+
+AIErr MemoryArtSource::RasterizeArtToPNG(AIArtHandle art, const std::string& filePath)
+{
+	return kBadParameterErr;
+}
+
+AIErr MemoryArtSource::GetPathSegmentCount(AIArtHandle path, short* count)
+{
+	*count = (short)ToArt(path)->segments.size();
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments)
+{
+	const std::vector<AIPathSegment>& pathSegments = ToArt(path)->segments;
+	if (segmentNumber < 0 || count < 0 || (size_t)(segmentNumber + count) > pathSegments.size())
+	{
+		return kBadParameterErr;
+	}
+
+	for (short i = 0; i < count; i++)
+	{
+		segments[i] = pathSegments[segmentNumber + i];
+	}
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPathClosed(AIArtHandle path, AIBoolean* closed)
+{
+	*closed = ToArt(path)->closed;
+	return kNoErr;
+}
+
+// Guides are never added
+AIErr MemoryArtSource::GetPathGuide(AIArtHandle path, AIBoolean* isGuide)
+{
+	*isGuide = false;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill)
+{
+	*style = ToArt(art)->style;
+	if (hasAdvancedFill)
+	{
+		*hasAdvancedFill = false;
+	}
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetGradientType(AIGradientHandle gradient, short* type)
+{
+	*type = reinterpret_cast<MemoryGradient*>(gradient)->type;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetGradientStopCount(AIGradientHandle gradient, short* count)
+{
+	*count = (short)reinterpret_cast<MemoryGradient*>(gradient)->stops.size();
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop)
+{
+	const std::vector<AIGradientStop>& stops = reinterpret_cast<MemoryGradient*>(gradient)->stops;
+	if (n < 0 || (size_t)n >= stops.size())
+	{
+		return kBadParameterErr;
+	}
+
+	*stop = stops[n];
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPatternArt(AIPatternHandle pattern, AIArtHandle* art)
+{
+	*art = ToHandle(reinterpret_cast<MemoryPattern*>(pattern)->art);
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPatternName(AIPatternHandle pattern, std::string& name)
+{
+	name = reinterpret_cast<MemoryPattern*>(pattern)->name;
+	return kNoErr;
+}
+
+// Styles never use custom colors
+AIErr MemoryArtSource::GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor)
+{
+	return kBadParameterErr;
+}
+
+AIErr MemoryArtSource::GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern)
+{
+	*pattern = ToArt(art)->symbolPattern;
+	return (*pattern ? kNoErr : kBadParameterErr);
+}
+
+AIErr MemoryArtSource::GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform)
+{
+	*transform = ToArt(art)->matrix;
+	return kNoErr;
+}
+
+// Plug-in art is never added
+AIErr MemoryArtSource::GetPluginArtName(AIArtHandle art, std::string& name)
+{
+	name.clear();
+	return kBadParameterErr;
+}
+
+AIErr MemoryArtSource::GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt)
+{
+	*resultArt = nullptr;
+	return kBadParameterErr;
+}
+
+// Placed art is always linked raster art
+AIErr MemoryArtSource::GetPlacedType(AIArtHandle art, short* type)
+{
+	*type = kRasterType;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPlacedFilePath(AIArtHandle art, std::string& filePath)
+{
+	filePath = ToArt(art)->filePath;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix)
+{
+	*matrix = ToArt(art)->matrix;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster)
+{
+	*info = ToArt(art)->rasterInfo;
+	*isRaster = true;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetRasterFilePath(AIArtHandle art, std::string& filePath)
+{
+	filePath = ToArt(art)->filePath;
+	return kNoErr;
+}
+
+AIErr MemoryArtSource::GetTextFrame(AIArtHandle art, TextFrame& textFrame)
+{
+	textFrame = ToArt(art)->textFrame;
+	return kNoErr;
+}
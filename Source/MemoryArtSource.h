@@ -0,0 +1,173 @@
+// MemoryArtSource.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef MEMORYARTSOURCE_H
+#define MEMORYARTSOURCE_H
+
+#include "IllustratorSDK.h"
+#include "ArtSource.h"
+#include "RealMath.h"
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace CanvasExport
+{
+	/// Holds a synthetic document in memory, so exports can be driven (and measured) without Illustrator
+	/// Handles point at the source's own records, so they must never be passed to the SDK
+	/// (art has no Live Effects, masks or plug-in art, and can't be rasterized; styles use process colors, gradients and patterns)
+	/// Symbols reference patterns, and placed art references a file (its bounds are the raster bounds, transformed)
+	class MemoryArtSource : public ArtSource
+	{
+	private:
+
+		struct MemoryArt
+		{
+			short						type;				// Art type (kGroupArt, kPathArt, ...)
+			ai::int32					userAttr;			// Attribute flags (kArtHidden, kArtPartOfCompound, ...)
+			std::string					name;				// Empty for a default name
+			AIReal						opacity;
+			AIBlendingMode				blendingMode;
+			std::vector<AIPathSegment>	segments;
+			AIBoolean					closed;
+			AIPathStyle					style;
+			AIPatternHandle				symbolPattern;		// Symbol art
+			AIRealMatrix				matrix;				// Symbol transform or placed art matrix
+			std::string					filePath;			// Placed art
+			AIRasterRecord				rasterInfo;			// Placed art
+			TextFrame					textFrame;			// Text frame art
+			bool						hasBounds;			// Are bounds set (for art without segments or children)?
+			AIRealRect					bounds;
+			MemoryArt*					firstChild;
+			MemoryArt*					lastChild;
+			MemoryArt*					sibling;
+		};
+
+		struct MemoryLayer
+		{
+			std::string					title;
+			AIBoolean					visible;
+			MemoryArt*					firstArt;
+			MemoryArt*					lastArt;
+		};
+
+		struct MemoryGradient
+		{
+			short						type;				// kLinearGradient or kRadialGradient
+			std::vector<AIGradientStop>	stops;
+		};
+
+		struct MemoryPattern
+		{
+			std::string					name;
+			MemoryArt*					art;				// Group that holds the pattern art
+		};
+
+		std::deque<MemoryArt>		art;					// All art (a deque, so records never move)
+		std::deque<MemoryLayer>		layers;					// Layers, from the top
+		std::deque<MemoryGradient>	gradients;
+		std::deque<MemoryPattern>	patterns;
+
+		MemoryArt*			NewArt(short type, MemoryArt*& first, MemoryArt*& last);
+		void				AddBounds(const MemoryArt* memoryArt, AIRealRect& bounds, bool& hasBounds) const;
+		void				AddBounds(const AIRealRect& rect, const AIRealMatrix& matrix, AIRealRect& bounds, bool& hasBounds) const;
+		static void			AddBoundsPoint(const AIRealPoint& point, AIRealRect& bounds, bool& hasBounds);
+
+		static inline MemoryArt*	ToArt(AIArtHandle handle)		{ return reinterpret_cast<MemoryArt*>(handle); }
+		static inline AIArtHandle	ToHandle(MemoryArt* memoryArt)	{ return reinterpret_cast<AIArtHandle>(memoryArt); }
+
+	public:
+
+		MemoryArtSource();
+		~MemoryArtSource();
+
+		// Building a document
+		void				Clear();
+		AILayerHandle		AddLayer(const std::string& title, bool visible);
+		AIArtHandle			AddArt(AILayerHandle layer, short type);
+		AIArtHandle			AddArt(AIArtHandle parent, short type);
+		void				SetPath(AIArtHandle path, const std::vector<AIPathSegment>& segments, bool closed);
+		void				SetPathStyle(AIArtHandle art, const AIPathStyle& style);
+		void				SetArtName(AIArtHandle art, const std::string& name);
+		void				SetArtUserAttr(AIArtHandle art, ai::int32 attr);
+		void				SetOpacity(AIArtHandle art, AIReal opacity);
+		void				SetBlendingMode(AIArtHandle art, AIBlendingMode blendingMode);
+		AIGradientHandle	AddGradient(short type, const std::vector<AIGradientStop>& stops);
+		AIPatternHandle		AddPattern(const std::string& name);
+		void				SetSymbol(AIArtHandle symbol, AIPatternHandle pattern, const AIRealMatrix& transform);
+		void				SetPlaced(AIArtHandle placed, const std::string& filePath, const AIRealMatrix& matrix, const AIRasterRecord& info);
+		void				SetTextFrame(AIArtHandle text, const TextFrame& textFrame);
+		void				SetArtBounds(AIArtHandle art, const AIRealRect& bounds);
+
+		// ArtSource
+		AIErr				CountLayers(ai::int32* count);
+		AIErr				GetNthLayer(ai::int32 n, AILayerHandle* layer);
+		AIErr				GetLayerVisible(AILayerHandle layer, AIBoolean* visible);
+		AIErr				GetLayerTitle(AILayerHandle layer, std::string& title);
+		AIErr				GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art);
+
+		AIErr				GetArtFirstChild(AIArtHandle art, AIArtHandle* child);
+		AIErr				GetArtSibling(AIArtHandle art, AIArtHandle* sibling);
+		AIErr				GetArtType(AIArtHandle art, short* type);
+		AIErr				GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr);
+		AIErr				GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName);
+		AIErr				GetArtBounds(AIArtHandle art, AIRealRect* bounds);
+
+		AIReal				GetOpacity(AIArtHandle art);
+		AIBlendingMode		GetBlendingMode(AIArtHandle art);
+		AIErr				GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects);
+		AIErr				GetMask(AIArtHandle art, AIMaskRef* mask);
+		AIErr				GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping);
+		bool				CanRasterize();
+		AIErr				RasterizeArtToPNG(AIArtHandle art, const std::string& filePath);
+
+		AIErr				GetPathSegmentCount(AIArtHandle path, short* count);
+		AIErr				GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments);
+		AIErr				GetPathClosed(AIArtHandle path, AIBoolean* closed);
+		AIErr				GetPathGuide(AIArtHandle path, AIBoolean* isGuide);
+		AIErr				GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill);
+
+		AIErr				GetGradientType(AIGradientHandle gradient, short* type);
+		AIErr				GetGradientStopCount(AIGradientHandle gradient, short* count);
+		AIErr				GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop);
+		AIErr				GetPatternArt(AIPatternHandle pattern, AIArtHandle* art);
+		AIErr				GetPatternName(AIPatternHandle pattern, std::string& name);
+		AIErr				GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor);
+
+		AIErr				GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern);
+		AIErr				GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform);
+
+		AIErr				GetPluginArtName(AIArtHandle art, std::string& name);
+		AIErr				GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt);
+
+		AIErr				GetPlacedType(AIArtHandle art, short* type);
+		AIErr				GetPlacedFilePath(AIArtHandle art, std::string& filePath);
+		AIErr				GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix);
+		AIErr				GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster);
+		AIErr				GetRasterFilePath(AIArtHandle art, std::string& filePath);
+
+		AIErr				GetTextFrame(AIArtHandle art, TextFrame& textFrame);
+	};
+}
+
+#endif
@@ -0,0 +1,185 @@
+// NumberFormat.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include "OutputStream.h"
+#include "ExportOptions.h"
+
+namespace CanvasExport
+{
+	// Longest formatted number (anything larger falls back to snprintf and is truncated)
+	const size_t kMaxNumberLength = 64;
+
+	// Compile-time power of ten
+	template <int Exponent>
+	struct PowerOfTen
+	{
+		static const int64_t value = 10 * PowerOfTen<Exponent - 1>::value;
+	};
+
+	template <>
+	struct PowerOfTen<0>
+	{
+		static const int64_t value = 1;
+	};
+
+	/// Formats a value with Precision decimal places into buffer (not null-terminated) and returns the length
+	/// Values that round to zero never carry a sign ("-0.0" is written as "0.0")
+	/// If compact is true, trailing fractional zeros (and a trailing decimal point) and a leading zero are removed
+	/// (i.e. "10.0" is written as "10" and "-0.50" as "-.5")
+	template <int Precision>
+	size_t FormatFixed(char* buffer, double value, bool compact)
+	{
+		static_assert(Precision >= 0 && Precision <= 6, "Unsupported precision");
+
+		const int64_t scale = PowerOfTen<Precision>::value;
+		double scaled = value * (double)scale;
+
+		// NaN, infinite or too large for integer formatting?
+		if (!(scaled > -9.0e18 && scaled < 9.0e18))
+		{
+			int length = snprintf(buffer, kMaxNumberLength, "%.*f", Precision, value);
+			return (length < 0) ? 0 : ((size_t)length < kMaxNumberLength ? (size_t)length : kMaxNumberLength - 1);
+		}
+
+		// Round to nearest, with exact ties going to even (matches printf)
+		int64_t rounded = 0;
+		double lower = floor(scaled);
+		if ((scaled - lower) == 0.5)
+		{
+			// Scaling may have rounded, so check the exact product
+			double error = fma(value, (double)scale, -scaled);
+			if (error > 0.0 || (error == 0.0 && fmod(lower, 2.0) != 0.0))
+			{
+				lower += 1.0;
+			}
+			rounded = (int64_t)lower;
+		}
+		else
+		{
+			rounded = llround(scaled);
+		}
+		char* p = buffer;
+		char* end = buffer + kMaxNumberLength;
+
+		uint64_t magnitude = (uint64_t)rounded;
+		if (rounded < 0)
+		{
+			*p++ = '-';
+			magnitude = (uint64_t)(-rounded);
+		}
+
+		// Whole part
+		uint64_t whole = magnitude / (uint64_t)scale;
+		if (!compact || whole != 0 || magnitude == 0)
+		{
+			p = std::to_chars(p, end, whole).ptr;
+		}
+
+		// Fractional part
+		if (Precision > 0)
+		{
+			uint64_t fraction = magnitude % (uint64_t)scale;
+			int digits = Precision;
+
+			if (compact)
+			{
+				while (digits > 0 && (fraction % 10) == 0)
+				{
+					fraction /= 10;
+					digits--;
+				}
+			}
+
+			if (digits > 0)
+			{
+				*p++ = '.';
+
+				// Write digits right-to-left (keeps leading zeros)
+				for (int i = digits - 1; i >= 0; i--)
+				{
+					p[i] = (char)('0' + (fraction % 10));
+					fraction /= 10;
+				}
+				p += digits;
+			}
+		}
+
+		return (size_t)(p - buffer);
+	}
+
+	/// A value to be written with a fixed number of decimal places
+	template <int Precision>
+	struct FixedNumber
+	{
+		double		value;
+	};
+
+	/// Usage: outFile << Fixed<1>(point.h);
+	template <int Precision>
+	inline FixedNumber<Precision> Fixed(double value)
+	{
+		FixedNumber<Precision> number = { value };
+		return number;
+	}
+
+	template <int Precision>
+	inline OutputStream& operator<<(OutputStream& stream, const FixedNumber<Precision>& number)
+	{
+		char buffer[kMaxNumberLength];
+		stream.Write(buffer, FormatFixed<Precision>(buffer, number.value, exportOptions.IsMinified()));
+		return stream;
+	}
+
+	template <int Precision>
+	inline std::ostream& operator<<(std::ostream& stream, const FixedNumber<Precision>& number)
+	{
+		char buffer[kMaxNumberLength];
+		stream.write(buffer, (std::streamsize)FormatFixed<Precision>(buffer, number.value, exportOptions.IsMinified()));
+		return stream;
+	}
+
+	/// Appends a value with Precision decimal places to a string
+	template <int Precision>
+	inline void AppendFixed(std::string& s, double value)
+	{
+		char buffer[kMaxNumberLength];
+		s.append(buffer, FormatFixed<Precision>(buffer, value, exportOptions.IsMinified()));
+	}
+
+	/// Appends an integer to a string
+	inline void AppendInteger(std::string& s, int value)
+	{
+		char buffer[16];
+		s.append(buffer, (size_t)(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+	}
+}
+
+#endif
@@ -0,0 +1,460 @@
+// OutputStream.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "OutputStream.h"
+
+using namespace CanvasExport;
+
+// 1 MB chunks, with up to 4 MB kept around for the next export
+static const size_t kChunkSize = 1024 * 1024;
+static const size_t kRetainedChunks = 4;
+
+// Chunks that can wait for the compressor before output waits for it to catch up
+static const size_t kMaxCompressingChunks = 4;
+
+OutputBuffer::OutputBuffer(size_t chunkSize)
+{
+	// Initialize OutputBuffer
+	this->chunkSize = chunkSize;
+	this->currentChunk = 0;
+	this->recycledBytes = 0;
+	this->minify = false;
+	this->minifyState = kMinifyText;
+	this->lastChar = '\0';
+	this->compressor = NULL;
+	this->compressorChunks = 0;
+	this->file = NULL;
+	this->isWriteFailed = false;
+
+	// Allocate first chunk
+	chunks.push_back(new char[chunkSize]);
+	setp(chunks[0], chunks[0] + chunkSize);
+}
+
+OutputBuffer::~OutputBuffer()
+{
+	// Free chunks (nothing is being compressed by now)
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		delete[] chunks[i];
+	}
+	for (size_t i = 0; i < spareChunks.size(); i++)
+	{
+		delete[] spareChunks[i];
+	}
+	for (size_t i = 0; i < compressingChunks.size(); i++)
+	{
+		delete[] compressingChunks[i];
+	}
+}
+
+void OutputBuffer::NextChunk()
+{
+	// The current chunk is full, so it can be compressed while we fill the next one
+	if (compressor)
+	{
+		compressor->Add(chunks[currentChunk], chunkSize);
+		compressorChunks++;
+	}
+
+	if (file)
+	{
+		// Write it now, so disk writes overlap with the rest of the export
+		isWriteFailed = (fwrite(chunks[currentChunk], 1, chunkSize, file) != chunkSize) || isWriteFailed;
+
+		// Nothing else reads it, so it can be reused (once it's been compressed)
+		if (compressor)
+		{
+			compressingChunks.push_back(chunks[currentChunk]);
+		}
+		else
+		{
+			spareChunks.push_back(chunks[currentChunk]);
+		}
+		recycledBytes += chunkSize;
+		chunks[currentChunk] = NewChunk();
+	}
+	else
+	{
+		// Move to the next chunk (allocating only if we've never needed this many)
+		currentChunk++;
+		if (currentChunk == chunks.size())
+		{
+			chunks.push_back(NewChunk());
+		}
+	}
+	setp(chunks[currentChunk], chunks[currentChunk] + chunkSize);
+}
+
+// Reuse a spare chunk, or allocate one
+// If too many chunks are waiting to be compressed, this waits for the compressor to catch up (bounding memory use)
+char* OutputBuffer::NewChunk()
+{
+	RecycleChunks(spareChunks.empty() && compressingChunks.size() >= kMaxCompressingChunks);
+
+	if (spareChunks.empty())
+	{
+		return new char[chunkSize];
+	}
+
+	char* chunk = spareChunks.back();
+	spareChunks.pop_back();
+	return chunk;
+}
+
+// Move chunks that have been compressed to the spares (optionally waiting for the oldest one)
+void OutputBuffer::RecycleChunks(bool wait)
+{
+	if (!compressor || compressingChunks.empty())
+	{
+		return;
+	}
+
+	// Chunks are compressed in the order they're added, and only the last few are still being compressed
+	size_t oldest = compressorChunks - compressingChunks.size();
+	if (wait)
+	{
+		compressor->WaitForBlocks(oldest + 1);
+	}
+
+	size_t compressedChunks = compressor->CompressedBlocks();
+	while (!compressingChunks.empty() && oldest < compressedChunks)
+	{
+		spareChunks.push_back(compressingChunks.front());
+		compressingChunks.pop_front();
+		oldest++;
+	}
+}
+
+OutputBuffer::int_type OutputBuffer::overflow(int_type c)
+{
+	if (!traits_type::eq_int_type(c, traits_type::eof()))
+	{
+		// Current chunk is full (Append moves to the next one)
+		char ch = traits_type::to_char_type(c);
+		Append(&ch, 1);
+	}
+	return traits_type::not_eof(c);
+}
+
+std::streamsize OutputBuffer::xsputn(const char* s, std::streamsize n)
+{
+	Append(s, (size_t)n);
+	return n;
+}
+
+// Is this character part of a JavaScript identifier, number, or HTML attribute value?
+static inline bool IsWordChar(char c)
+{
+	return ((c >= '0' && c <= '9') ||
+			(c >= 'A' && c <= 'Z') ||
+			(c >= 'a' && c <= 'z') ||
+			(c == '_') ||
+			(c == '$') ||
+			(c == '.') ||
+			(c == '"'));
+}
+
+// Drops line breaks, indentation, and lines that start with "//"
+// A single space is kept wherever joining two lines would run words together
+void OutputBuffer::AppendMinified(const char* s, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		char c = s[i];
+
+		switch (minifyState)
+		{
+			case kMinifyLineSlash:
+			{
+				if (c == '/')
+				{
+					// Full-line comment
+					minifyState = kMinifyComment;
+					break;
+				}
+
+				// Just a slash at the start of a line
+				Put('/');
+				minifyState = kMinifyText;
+
+				// Handle this character as text
+			}
+			// Fall through
+			case kMinifyText:
+			{
+				if (c == '\n')
+				{
+					minifyState = kMinifyLineStart;
+				}
+				else
+				{
+					Put(c);
+				}
+				break;
+			}
+			case kMinifyLineStart:
+			{
+				if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+				{
+					// Skip indentation and blank lines
+				}
+				else if (c == '/')
+				{
+					// Might be a comment
+					minifyState = kMinifyLineSlash;
+				}
+				else
+				{
+					if (IsWordChar(lastChar) && IsWordChar(c))
+					{
+						Put(' ');
+					}
+					Put(c);
+					minifyState = kMinifyText;
+				}
+				break;
+			}
+			case kMinifyComment:
+			{
+				if (c == '\n')
+				{
+					minifyState = kMinifyLineStart;
+				}
+				break;
+			}
+		}
+	}
+}
+
+// Empty the buffer (keeps allocated chunks)
+// Any compressor must have been closed, so none of the chunks are still being compressed
+void OutputBuffer::Clear()
+{
+	while (!compressingChunks.empty())
+	{
+		spareChunks.push_back(compressingChunks.front());
+		compressingChunks.pop_front();
+	}
+
+	currentChunk = 0;
+	recycledBytes = 0;
+	setp(chunks[0], chunks[0] + chunkSize);
+
+	minifyState = kMinifyText;
+	lastChar = '\0';
+}
+
+void OutputBuffer::SetMinify(bool minify)
+{
+	this->minify = minify;
+}
+
+// Compress chunks as they fill (set before anything is written)
+void OutputBuffer::SetCompressor(GzipWriter* compressor)
+{
+	this->compressor = compressor;
+	this->compressorChunks = 0;
+}
+
+// Compress the partly filled chunk and stop compressing
+void OutputBuffer::FlushCompressor()
+{
+	if (compressor)
+	{
+		compressor->Add(chunks[currentChunk], (size_t)(pptr() - pbase()));
+		compressor = NULL;
+	}
+}
+
+// Release chunks beyond those we want to keep (buffer must be empty)
+void OutputBuffer::Trim(size_t retainedChunks)
+{
+	if (retainedChunks < 1)
+	{
+		retainedChunks = 1;
+	}
+
+	while (chunks.size() > retainedChunks)
+	{
+		delete[] chunks.back();
+		chunks.pop_back();
+	}
+	while (!spareChunks.empty() && chunks.size() + spareChunks.size() > retainedChunks)
+	{
+		delete[] spareChunks.back();
+		spareChunks.pop_back();
+	}
+}
+
+size_t OutputBuffer::Size() const
+{
+	// Every chunk before the current one is full
+	return recycledBytes + (currentChunk * chunkSize) + (size_t)(pptr() - pbase());
+}
+
+// Write each chunk to a file as it fills (set before anything is written)
+void OutputBuffer::SetFile(FILE* file)
+{
+	this->file = file;
+	this->isWriteFailed = false;
+
+	// Chunks are reused as they're written, so only the current one holds output
+	while (file && chunks.size() > currentChunk + 1)
+	{
+		spareChunks.push_back(chunks.back());
+		chunks.pop_back();
+	}
+}
+
+// Write whatever hasn't been written yet and stop writing to the file (returns false if any write failed)
+bool OutputBuffer::FlushFile()
+{
+	bool result = !isWriteFailed;
+
+	if (file)
+	{
+		for (size_t i = 0; i < currentChunk && result; i++)
+		{
+			result = (fwrite(chunks[i], 1, chunkSize, file) == chunkSize);
+		}
+
+		size_t remaining = (size_t)(pptr() - pbase());
+		if (result && remaining > 0)
+		{
+			result = (fwrite(chunks[currentChunk], 1, remaining, file) == remaining);
+		}
+
+		file = NULL;
+	}
+
+	return result;
+}
+
+// Append buffer contents to another buffer (which minifies or compresses them, just as if they had been written to it directly)
+// (only for buffers that aren't written to a file, since those reuse their chunks)
+void OutputBuffer::AppendTo(OutputBuffer& destination) const
+{
+	for (size_t i = 0; i < currentChunk; i++)
+	{
+		destination.Append(chunks[i], chunkSize);
+	}
+
+	destination.Append(chunks[currentChunk], (size_t)(pptr() - pbase()));
+}
+
+OutputStream::OutputStream() : std::ostream(NULL), buffer(kChunkSize)
+{
+	// Initialize OutputStream
+	this->file = NULL;
+	rdbuf(&buffer);
+}
+
+// Streams that only hold part of an export (and are never opened) can use smaller chunks
+OutputStream::OutputStream(size_t chunkSize) : std::ostream(NULL), buffer(chunkSize)
+{
+	// Initialize OutputStream
+	this->file = NULL;
+	rdbuf(&buffer);
+}
+
+OutputStream::~OutputStream()
+{
+	Close();
+}
+
+bool OutputStream::Open(const std::string& filePath)
+{
+	// Close any previous file
+	Close();
+
+	// Open the destination now, so failures are reported before rendering
+	file = fopen(filePath.c_str(), "w");
+	if (file)
+	{
+		// We write in large blocks, so skip the C runtime's buffering
+		setvbuf(file, NULL, _IONBF, 0);
+	}
+
+	buffer.Clear();
+	buffer.SetFile(file);
+	clear();
+
+	return (file != NULL);
+}
+
+// Also write a gzip-compressed copy to filePath (call after Open, before writing anything)
+// Compression happens on a background thread while the rest of the output is rendered
+bool OutputStream::Compress(const std::string& filePath)
+{
+	bool result = compressor.Open(filePath);
+	buffer.SetCompressor(result ? &compressor : NULL);
+
+	return result;
+}
+
+bool OutputStream::IsOpen() const
+{
+	return (file != NULL);
+}
+
+// Write the rest to disk and close the file
+bool OutputStream::Close()
+{
+	bool result = true;
+
+	if (file)
+	{
+		result = buffer.FlushFile();
+		result = (fclose(file) == 0) && result;
+		file = NULL;
+	}
+
+	// Wait for the compressed copy (before the chunks can be reused)
+	if (compressor.IsOpen())
+	{
+		buffer.FlushCompressor();
+		result = compressor.Close() && result;
+	}
+
+	buffer.Clear();
+	buffer.Trim(kRetainedChunks);
+
+	return result;
+}
+
+size_t OutputStream::Size() const
+{
+	return buffer.Size();
+}
+
+// Minify everything written from here on
+void OutputStream::SetMinify(bool minify)
+{
+	buffer.SetMinify(minify);
+}
+
+// Append everything written so far to another stream
+void OutputStream::AppendTo(OutputStream& stream) const
+{
+	buffer.AppendTo(stream.buffer);
+}
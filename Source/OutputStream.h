@@ -0,0 +1,185 @@
+// OutputStream.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef OUTPUTSTREAM_H
+#define OUTPUTSTREAM_H
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Gzip.h"
+
+namespace CanvasExport
+{
+	/// Stream buffer that accumulates output in large, reusable chunks
+	class OutputBuffer : public std::streambuf
+	{
+	private:
+
+		enum MinifyState { kMinifyText, kMinifyLineStart, kMinifyLineSlash, kMinifyComment };
+
+		std::vector<char*>	chunks;						// Chunks that hold output (retained between exports)
+		std::vector<char*>	spareChunks;				// Chunks that are free to reuse (retained between exports)
+		std::deque<char*>	compressingChunks;			// Chunks written to file that are still being compressed (oldest first)
+		size_t				chunkSize;					// Size of each chunk
+		size_t				currentChunk;				// Index of chunk being filled
+		size_t				recycledBytes;				// Output in chunks that were written to file (and compressed), then reused
+		bool				minify;						// Strip line breaks, indentation, and full-line comments?
+		MinifyState			minifyState;				// Where we are in the current line (when minifying)
+		char				lastChar;					// Last character written (when minifying)
+		GzipWriter*			compressor;					// Compresses each chunk as it fills (if set)
+		size_t				compressorChunks;			// Chunks added to the compressor
+		FILE*				file;						// Writes each chunk as it fills (if set)
+		bool				isWriteFailed;				// Did writing a chunk fail?
+
+		void				NextChunk();
+		char*				NewChunk();
+		void				RecycleChunks(bool wait);
+		void				AppendMinified(const char* s, size_t n);
+
+		inline void			Put(char c)
+		{
+			if (pptr() == epptr())
+			{
+				NextChunk();
+			}
+			*pptr() = c;
+			pbump(1);
+			lastChar = c;
+		}
+
+	protected:
+
+		virtual int_type	overflow(int_type c);
+		virtual std::streamsize	xsputn(const char* s, std::streamsize n);
+
+	public:
+
+		OutputBuffer(size_t chunkSize);
+		~OutputBuffer();
+
+		/// Appends raw bytes (bypasses the stream sentry and locale)
+		inline void Append(const char* s, size_t n)
+		{
+			if (minify)
+			{
+				AppendMinified(s, n);
+				return;
+			}
+
+			while (n > 0)
+			{
+				size_t space = (size_t)(epptr() - pptr());
+				if (space == 0)
+				{
+					NextChunk();
+					space = chunkSize;
+				}
+
+				size_t count = (n < space) ? n : space;
+				memcpy(pptr(), s, count);
+				pbump((int)count);
+				s += count;
+				n -= count;
+			}
+		}
+
+		void				Clear();
+		void				Trim(size_t retainedChunks);
+		void				SetMinify(bool minify);
+		void				SetCompressor(GzipWriter* compressor);
+		void				FlushCompressor();
+		void				SetFile(FILE* file);
+		bool				FlushFile();
+		size_t				Size() const;
+		void				AppendTo(OutputBuffer& destination) const;
+	};
+
+	/// Output sink that writes an export to disk a chunk at a time as it fills (and the rest when closed)
+	/// Once a chunk has been written (and compressed), it's reused, so memory use doesn't grow with the size of the export
+	class OutputStream : public std::ostream
+	{
+	private:
+
+		OutputBuffer		buffer;						// Chunked in-memory buffer
+		FILE*				file;						// Destination file (opened up front so errors are reported early)
+		GzipWriter			compressor;					// Writes a compressed copy (when requested)
+
+	public:
+
+		OutputStream();
+		OutputStream(size_t chunkSize);
+		~OutputStream();
+
+		bool				Open(const std::string& filePath);
+		bool				Compress(const std::string& filePath);
+		bool				IsOpen() const;
+		bool				Close();
+		size_t				Size() const;
+		void				SetMinify(bool minify);
+		void				AppendTo(OutputStream& stream) const;
+
+		inline void			Write(const char* s, size_t n)	{ buffer.Append(s, n); }
+	};
+
+	// Fast paths for text (the most common fragments), avoiding the ostream sentry
+	// Templates ensure that only true char and char* arguments match
+	template <typename T>
+	inline typename std::enable_if<std::is_same<T, char>::value, OutputStream&>::type operator<<(OutputStream& stream, const T* s)
+	{
+		stream.Write(s, strlen(s));
+		return stream;
+	}
+
+	template <typename T>
+	inline typename std::enable_if<std::is_same<T, char>::value, OutputStream&>::type operator<<(OutputStream& stream, T c)
+	{
+		stream.Write(&c, 1);
+		return stream;
+	}
+
+	inline OutputStream& operator<<(OutputStream& stream, const std::string& s)
+	{
+		stream.Write(s.data(), s.length());
+		return stream;
+	}
+
+	// Integers (character types and bool keep their std::ostream behavior)
+	template <typename T>
+	inline typename std::enable_if<std::is_integral<T>::value &&
+		!std::is_same<T, bool>::value && !std::is_same<T, char>::value &&
+		!std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value, OutputStream&>::type operator<<(OutputStream& stream, T value)
+	{
+		char buffer[24];
+		char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+		stream.Write(buffer, (size_t)(end - buffer));
+		return stream;
+	}
+}
+
+#endif
@@ -0,0 +1,136 @@
+// PathCollection.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "PathCollection.h"
+
+using namespace CanvasExport;
+
+PathCollection::PathCollection()
+{
+}
+
+PathCollection::~PathCollection()
+{
+}
+
+// Returns the index of the path (identical paths are only built once)
+size_t PathCollection::Add(const std::string& data)
+{
+	// Does this path already exist?
+	std::unordered_map<std::string, size_t>::const_iterator found = indices.find(data);
+	if (found != indices.end())
+	{
+		return found->second;
+	}
+
+	// Add a new path
+	size_t index = paths.size();
+	paths.push_back(data);
+	indices[data] = index;
+
+	return index;
+}
+
+bool PathCollection::HasPaths() const
+{
+	return !paths.empty();
+}
+
+// Render the function that builds the paths (called from init)
+void PathCollection::Render()
+{
+	if (exportOptions.GetEncoding() == ExportOptions::kEncodeQuantized)
+	{
+		RenderQuantized();
+		return;
+	}
+
+	outFile << "\n\n    // Paths (built once, then drawn by reference)";
+	outFile <<   "\n    var " << exportOptions.PathsName() << ";";
+
+	outFile << "\n\n    function initPaths() {";
+	outFile << "\n      " << exportOptions.PathsName() << " = [";
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		outFile << "\n        new Path2D(\"" << paths[i] << "\")";
+		if (i + 1 < paths.size())
+		{
+			outFile << ",";
+		}
+	}
+
+	outFile << "\n      ];";
+	outFile << "\n    }";
+}
+
+// Render the paths as a single blob of quantized, delta-encoded zigzag varints, decoded into Path2D objects
+void PathCollection::RenderQuantized()
+{
+	std::string data;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		data += paths[i];
+	}
+
+	outFile << "\n\n    // Paths (quantized, then built once and drawn by reference)";
+	outFile <<   "\n    var " << exportOptions.PathsName() << ";";
+
+	outFile << "\n\n    function initPaths() {";
+	outFile <<   "\n      var bytes = decodeBase64(\"" << EncodeBase64((const unsigned char*)data.data(), data.size()) << "\");";
+	outFile <<   "\n      var grid = " << exportOptions.grid << ";";
+	outFile <<   "\n      var i = 0;";
+	outFile << "\n\n      // Read a zigzag varint";
+	outFile <<   "\n      function next() {";
+	outFile <<   "\n        var value = 0, shift = 0, b;";
+	outFile <<   "\n        do {";
+	outFile <<   "\n          b = bytes[i++];";
+	outFile <<   "\n          value |= (b & 127) << shift;";
+	outFile <<   "\n          shift += 7;";
+	outFile <<   "\n        } while (b & 128);";
+	outFile <<   "\n        return (value >>> 1) ^ -(value & 1);";
+	outFile <<   "\n      }";
+	outFile << "\n\n      " << exportOptions.PathsName() << " = [];";
+	outFile <<   "\n      while (i < bytes.length) {";
+	outFile <<   "\n        var path = new Path2D();";
+	outFile <<   "\n        var x = 0, y = 0, x1, y1, x2, y2, segment;";
+	outFile <<   "\n        while ((segment = bytes[i++]) != " << (int)kSegmentEnd << ") {";
+	outFile <<   "\n          switch (segment) {";
+	outFile <<   "\n            case " << (int)kSegmentMoveTo << ": x += next(); y += next(); path.moveTo(x * grid, y * grid); break;";
+	outFile <<   "\n            case " << (int)kSegmentLineTo << ": x += next(); y += next(); path.lineTo(x * grid, y * grid); break;";
+	outFile <<   "\n            case " << (int)kSegmentBezierCurveTo << ":";
+	outFile <<   "\n              x1 = x += next(); y1 = y += next();";
+	outFile <<   "\n              x2 = x += next(); y2 = y += next();";
+	outFile <<   "\n              x += next(); y += next();";
+	outFile <<   "\n              path.bezierCurveTo(x1 * grid, y1 * grid, x2 * grid, y2 * grid, x * grid, y * grid);";
+	outFile <<   "\n              break;";
+	outFile <<   "\n            case " << (int)kSegmentClosePath << ": path.closePath(); break;";
+	outFile <<   "\n          }";
+	outFile <<   "\n        }";
+	outFile <<   "\n        " << exportOptions.PathsName() << ".push(path);";
+	outFile <<   "\n      }";
+	outFile <<   "\n    }";
+
+	RenderDecodeBase64();
+}
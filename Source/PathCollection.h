@@ -0,0 +1,69 @@
+// PathCollection.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef PATHCOLLECTION_H
+#define PATHCOLLECTION_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <unordered_map>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Represents the paths that are built once (as Path2D objects) when the document is initialized
+	class PathCollection
+	{
+	private:
+
+		std::vector<std::string>				paths;		// Path data for each path (SVG, or binary when quantized)
+		std::unordered_map<std::string, size_t>	indices;	// Index of each distinct path
+
+		void					RenderQuantized();
+
+	public:
+
+		/// Segment types in quantized path data
+		enum Segment
+		{
+			kSegmentEnd,					// End of path
+			kSegmentMoveTo,					// x, y
+			kSegmentLineTo,					// x, y
+			kSegmentBezierCurveTo,			// cp1x, cp1y, cp2x, cp2y, x, y
+			kSegmentClosePath
+		};
+
+		PathCollection();
+		~PathCollection();
+
+		size_t					Add(const std::string& data);
+		bool					HasPaths() const;
+		void					Render();
+
+	};
+}
+
+#endif
@@ -84,9 +84,8 @@ bool PatternCollection::Add(AIPatternHandle patternHandle, bool isSymbol)
 
 		// Get pattern name
 		// TODO: Do we need to make this unique? Does Illustrator allow duplicates?
-		ai::UnicodeString patternName;
-		sAIPattern->GetPatternName(pattern->patternHandle, patternName);
-		std::string name = patternName.as_Platform();
+		std::string name;
+		artSource->GetPatternName(pattern->patternHandle, name);
 		CleanString(name, true);
 		pattern->name = name;
 
@@ -24,14 +24,13 @@
 #define PATTERNCOLLECTION_H
 
 #include "IllustratorSDK.h"
-#include "Ai2CanvasSuites.h"
 #include "Pattern.h"
 #include "Utility.h"
 
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
 	/// Represents a collection of patterns (which includes symbols)
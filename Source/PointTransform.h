@@ -0,0 +1,194 @@
+// PointTransform.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef POINTTRANSFORM_H
+#define POINTTRANSFORM_H
+
+#include "IllustratorSDK.h"
+#include <cstddef>
+
+// Vector instruction sets (AVX builds also have SSE2; anything else, including ARM, uses the scalar loop)
+#if defined(__AVX2__) || defined(__AVX__)
+	#define POINTTRANSFORM_AVX
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define POINTTRANSFORM_SSE2
+	#include <emmintrin.h>
+#endif
+
+// Multiplies and adds are never fused into FMA instructions (even when the target has them), so every loop rounds the same way
+#if defined(__GNUC__) && !defined(__clang__)
+	#define POINTTRANSFORM_NO_CONTRACT		__attribute__((optimize("fp-contract=off")))
+#else
+	#define POINTTRANSFORM_NO_CONTRACT
+#endif
+
+namespace CanvasExport
+{
+	/// Transforms count points (separate x and y arrays) by a matrix in place, one point at a time
+	/// (the same arithmetic as AIRealMatrixXformPoint, and the reference for TransformPoints)
+	POINTTRANSFORM_NO_CONTRACT
+	inline void TransformPointsScalar(const AIRealMatrix& matrix, AIReal* x, AIReal* y, size_t count)
+	{
+		#if defined(__clang__)
+			#pragma clang fp contract(off)
+		#endif
+
+		const AIReal a = matrix.a;
+		const AIReal b = matrix.b;
+		const AIReal c = matrix.c;
+		const AIReal d = matrix.d;
+		const AIReal tx = matrix.tx;
+		const AIReal ty = matrix.ty;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			AIReal px = x[i];
+			AIReal py = y[i];
+			x[i] = px * a + py * c + tx;
+			y[i] = px * b + py * d + ty;
+		}
+	}
+
+	/// Transforms as many whole vectors of single-precision points as possible (returns the number of points transformed)
+	/// Multiplies and adds are kept separate and in the scalar order, so results are bit-identical
+	POINTTRANSFORM_NO_CONTRACT
+	inline size_t TransformPointsVector(const AIRealMatrix& matrix, float* x, float* y, size_t count)
+	{
+		#if defined(__clang__)
+			#pragma clang fp contract(off)
+		#endif
+
+		size_t i = 0;
+
+		#if defined(POINTTRANSFORM_AVX)
+			const __m256 a = _mm256_set1_ps((float)matrix.a);
+			const __m256 b = _mm256_set1_ps((float)matrix.b);
+			const __m256 c = _mm256_set1_ps((float)matrix.c);
+			const __m256 d = _mm256_set1_ps((float)matrix.d);
+			const __m256 tx = _mm256_set1_ps((float)matrix.tx);
+			const __m256 ty = _mm256_set1_ps((float)matrix.ty);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 px = _mm256_loadu_ps(x + i);
+				__m256 py = _mm256_loadu_ps(y + i);
+				_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, a), _mm256_mul_ps(py, c)), tx));
+				_mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, b), _mm256_mul_ps(py, d)), ty));
+			}
+		#elif defined(POINTTRANSFORM_SSE2)
+			const __m128 a = _mm_set1_ps((float)matrix.a);
+			const __m128 b = _mm_set1_ps((float)matrix.b);
+			const __m128 c = _mm_set1_ps((float)matrix.c);
+			const __m128 d = _mm_set1_ps((float)matrix.d);
+			const __m128 tx = _mm_set1_ps((float)matrix.tx);
+			const __m128 ty = _mm_set1_ps((float)matrix.ty);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 px = _mm_loadu_ps(x + i);
+				__m128 py = _mm_loadu_ps(y + i);
+				_mm_storeu_ps(x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, a), _mm_mul_ps(py, c)), tx));
+				_mm_storeu_ps(y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, b), _mm_mul_ps(py, d)), ty));
+			}
+		#else
+			(void)matrix;
+			(void)x;
+			(void)y;
+			(void)count;
+		#endif
+
+		return i;
+	}
+
+	/// Transforms as many whole vectors of double-precision points as possible (returns the number of points transformed)
+	POINTTRANSFORM_NO_CONTRACT
+	inline size_t TransformPointsVector(const AIRealMatrix& matrix, double* x, double* y, size_t count)
+	{
+		#if defined(__clang__)
+			#pragma clang fp contract(off)
+		#endif
+
+		size_t i = 0;
+
+		#if defined(POINTTRANSFORM_AVX)
+			const __m256d a = _mm256_set1_pd((double)matrix.a);
+			const __m256d b = _mm256_set1_pd((double)matrix.b);
+			const __m256d c = _mm256_set1_pd((double)matrix.c);
+			const __m256d d = _mm256_set1_pd((double)matrix.d);
+			const __m256d tx = _mm256_set1_pd((double)matrix.tx);
+			const __m256d ty = _mm256_set1_pd((double)matrix.ty);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256d px = _mm256_loadu_pd(x + i);
+				__m256d py = _mm256_loadu_pd(y + i);
+				_mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(px, a), _mm256_mul_pd(py, c)), tx));
+				_mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(px, b), _mm256_mul_pd(py, d)), ty));
+			}
+		#elif defined(POINTTRANSFORM_SSE2)
+			const __m128d a = _mm_set1_pd((double)matrix.a);
+			const __m128d b = _mm_set1_pd((double)matrix.b);
+			const __m128d c = _mm_set1_pd((double)matrix.c);
+			const __m128d d = _mm_set1_pd((double)matrix.d);
+			const __m128d tx = _mm_set1_pd((double)matrix.tx);
+			const __m128d ty = _mm_set1_pd((double)matrix.ty);
+
+			for (; i + 2 <= count; i += 2)
+			{
+				__m128d px = _mm_loadu_pd(x + i);
+				__m128d py = _mm_loadu_pd(y + i);
+				_mm_storeu_pd(x + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(px, a), _mm_mul_pd(py, c)), tx));
+				_mm_storeu_pd(y + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(px, b), _mm_mul_pd(py, d)), ty));
+			}
+		#else
+			(void)matrix;
+			(void)x;
+			(void)y;
+			(void)count;
+		#endif
+
+		return i;
+	}
+
+	/// Transforms count points (separate x and y arrays) by a matrix in place, several points at a time
+	/// (any remainder that doesn't fill a vector goes through the scalar loop)
+	inline void TransformPoints(const AIRealMatrix& matrix, AIReal* x, AIReal* y, size_t count)
+	{
+		size_t done = TransformPointsVector(matrix, x, y, count);
+		TransformPointsScalar(matrix, x + done, y + done, count - done);
+	}
+
+	/// Name of the instruction set used by TransformPoints (for benchmark reports)
+	inline const char* TransformPointsName()
+	{
+		#if defined(POINTTRANSFORM_AVX)
+			return "AVX";
+		#elif defined(POINTTRANSFORM_SSE2)
+			return "SSE2";
+		#else
+			return "scalar";
+		#endif
+	}
+}
+
+#endif
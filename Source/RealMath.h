@@ -0,0 +1,203 @@
+// RealMath.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef REALMATH_H
+#define REALMATH_H
+
+#include "IllustratorSDK.h"
+#include <cmath>
+
+namespace CanvasExport
+{
+	// Matrix, point and bezier math used while rendering
+	// Functions match the AIRealMathSuite and AIRealBezierSuite functions they replace (without the suites, so they work outside of Illustrator)
+	// Matrices map [x y 1] row vectors, so concatenating m1 with m2 applies m1 first
+
+	// Deepest bezier subdivision (a segment this small is always flat enough)
+	const int kMaxBezierDepth = 16;
+
+	// Iterations when searching for a t value (enough for double-precision t)
+	const int kMaxBezierSearch = 52;
+
+	const AIReal kPi = 3.14159265358979323846;
+
+	inline void RealMatrixSetIdentity(AIRealMatrix* m)
+	{
+		m->a = 1.0;
+		m->b = 0.0;
+		m->c = 0.0;
+		m->d = 1.0;
+		m->tx = 0.0;
+		m->ty = 0.0;
+	}
+
+	// [result] = [m1] x [m2] (result can be either argument)
+	inline void RealMatrixConcat(const AIRealMatrix* m1, const AIRealMatrix* m2, AIRealMatrix* result)
+	{
+		AIRealMatrix m;
+		m.a = m1->a * m2->a + m1->b * m2->c;
+		m.b = m1->a * m2->b + m1->b * m2->d;
+		m.c = m1->c * m2->a + m1->d * m2->c;
+		m.d = m1->c * m2->b + m1->d * m2->d;
+		m.tx = m1->tx * m2->a + m1->ty * m2->c + m2->tx;
+		m.ty = m1->tx * m2->b + m1->ty * m2->d + m2->ty;
+		*result = m;
+	}
+
+	// [m] = [m] x [scale]
+	inline void RealMatrixConcatScale(AIRealMatrix* m, AIReal h, AIReal v)
+	{
+		m->a *= h;
+		m->b *= v;
+		m->c *= h;
+		m->d *= v;
+		m->tx *= h;
+		m->ty *= v;
+	}
+
+	// [m] = [m] x [translate]
+	inline void RealMatrixConcatTranslate(AIRealMatrix* m, AIReal h, AIReal v)
+	{
+		m->tx += h;
+		m->ty += v;
+	}
+
+	// [result] = [p] x [m] (result can be p)
+	inline void RealPointTransform(const AIRealPoint* p, const AIRealMatrix* m, AIRealPoint* result)
+	{
+		AIReal h = p->h * m->a + p->v * m->c + m->tx;
+		AIReal v = p->h * m->b + p->v * m->d + m->ty;
+		result->h = h;
+		result->v = v;
+	}
+
+	inline AIReal DegreeToRadian(AIReal degree)
+	{
+		return degree * (kPi / 180.0);
+	}
+
+	inline void RealPointLengthAngle(AIReal length, AIReal angle, AIRealPoint* result)
+	{
+		result->h = length * cos(angle);
+		result->v = length * sin(angle);
+	}
+
+	// [result] = [a] + [b] (result can be either argument)
+	inline void RealPointAdd(const AIRealPoint* a, const AIRealPoint* b, AIRealPoint* result)
+	{
+		result->h = a->h + b->h;
+		result->v = a->v + b->v;
+	}
+
+	inline void RealBezierSet(AIRealBezier* b, const AIRealPoint* p0, const AIRealPoint* p1, const AIRealPoint* p2, const AIRealPoint* p3)
+	{
+		b->p0 = *p0;
+		b->p1 = *p1;
+		b->p2 = *p2;
+		b->p3 = *p3;
+	}
+
+	inline AIReal RealPointDistance(const AIRealPoint& a, const AIRealPoint& b)
+	{
+		return sqrt((b.h - a.h) * (b.h - a.h) + (b.v - a.v) * (b.v - a.v));
+	}
+
+	// Split a bezier at t (de Casteljau)
+	inline void RealBezierDivide(const AIRealBezier& b, AIReal t, AIRealBezier& left, AIRealBezier& right)
+	{
+		AIRealPoint p01, p12, p23, p012, p123, p0123;
+		p01.h = b.p0.h + (b.p1.h - b.p0.h) * t;
+		p01.v = b.p0.v + (b.p1.v - b.p0.v) * t;
+		p12.h = b.p1.h + (b.p2.h - b.p1.h) * t;
+		p12.v = b.p1.v + (b.p2.v - b.p1.v) * t;
+		p23.h = b.p2.h + (b.p3.h - b.p2.h) * t;
+		p23.v = b.p2.v + (b.p3.v - b.p2.v) * t;
+		p012.h = p01.h + (p12.h - p01.h) * t;
+		p012.v = p01.v + (p12.v - p01.v) * t;
+		p123.h = p12.h + (p23.h - p12.h) * t;
+		p123.v = p12.v + (p23.v - p12.v) * t;
+		p0123.h = p012.h + (p123.h - p012.h) * t;
+		p0123.v = p012.v + (p123.v - p012.v) * t;
+
+		left.p0 = b.p0;
+		left.p1 = p01;
+		left.p2 = p012;
+		left.p3 = p0123;
+		right.p0 = p0123;
+		right.p1 = p123;
+		right.p2 = p23;
+		right.p3 = b.p3;
+	}
+
+	// Length of a bezier (subdivides until the control polygon and the chord are within flatness of each other)
+	inline AIReal RealBezierLength(const AIRealBezier* b, AIReal flatness, int depth = 0)
+	{
+		AIReal chord = RealPointDistance(b->p0, b->p3);
+		AIReal polygon = RealPointDistance(b->p0, b->p1) + RealPointDistance(b->p1, b->p2) + RealPointDistance(b->p2, b->p3);
+
+		if ((polygon - chord) <= flatness || depth >= kMaxBezierDepth)
+		{
+			return (polygon + chord) / 2.0;
+		}
+
+		AIRealBezier left, right;
+		RealBezierDivide(*b, 0.5, left, right);
+		return RealBezierLength(&left, flatness, depth + 1) + RealBezierLength(&right, flatness, depth + 1);
+	}
+
+	// Find the t value that's length along a bezier of totalLength (binary search)
+	inline void RealBezierTAtLength(const AIRealBezier* b, AIReal length, AIReal totalLength, AIReal flatness, AIReal* t)
+	{
+		if (length <= 0.0)
+		{
+			*t = 0.0;
+			return;
+		}
+		if (length >= totalLength)
+		{
+			*t = 1.0;
+			return;
+		}
+
+		AIReal low = 0.0;
+		AIReal high = 1.0;
+		for (int i = 0; i < kMaxBezierSearch && (high - low) > flatness * 1e-3; i++)
+		{
+			AIReal middle = (low + high) / 2.0;
+
+			AIRealBezier left, right;
+			RealBezierDivide(*b, middle, left, right);
+			if (RealBezierLength(&left, flatness) < length)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		*t = (low + high) / 2.0;
+	}
+}
+
+#endif
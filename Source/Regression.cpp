@@ -0,0 +1,414 @@
+// Regression.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "Regression.h"
+#include "Document.h"
+#include "SnapshotArtSource.h"
+#include <chrono>
+
+using namespace CanvasExport;
+
+// Time differences smaller than this are never reported (in milliseconds)
+static const double kMinTimeDifference = 2.0;
+
+// Header lines that name the plug-in version and platform (ignored when comparing)
+static const char* const kBannerLines[] =
+{
+	"<!-- Created with Ai->Canvas Export Plug-In Version ",
+	"<!-- By Mike Swanson "
+};
+
+Regression::Regression(const std::string& listPath)
+{
+	// Initialize Regression
+	this->listPath = listPath;
+	this->timeThreshold = 10.0;
+	this->sizeThreshold = 1.0;
+
+	// Everything in the corpus is relative to the list's folder
+	size_t folder = listPath.find_last_of("/\\");
+	this->folderPath = (folder != std::string::npos) ? listPath.substr(0, folder + 1) : "";
+}
+
+Regression::~Regression()
+{
+}
+
+// Export the corpus and compare (or, when updating, replace the golden output and baseline)
+std::string Regression::Run(bool update)
+{
+	if (!ReadList())
+	{
+		return "Unable to read corpus list: " + listPath;
+	}
+	ReadBaselines();
+
+	// Golden output is always written with the default options
+	ExportOptions previousOptions = exportOptions;
+	ArtSource* previousSource = artSource;
+	bool previousDebug = debug;
+	exportOptions.Reset();
+
+	std::map<std::string, Baseline> results;
+	size_t passedCount = 0;
+	std::ostringstream report;
+	report << setiosflags(ios::fixed) << setprecision(1);
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		const std::string& name = names[i];
+		std::string outputPath = folderPath + name + ".out.html";
+		std::string goldenPath = folderPath + name + ".html";
+
+		SnapshotArtSource source;
+		if (!source.Open(folderPath + name + ".snapshot"))
+		{
+			report << "\n  FAIL " << name << ": unable to open snapshot";
+			continue;
+		}
+
+		// Export (keeping the best time)
+		artSource = &source;
+		double bestSeconds = 0.0;
+		bool isExported = true;
+		for (int pass = 0; pass < kPasses && isExported; pass++)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			isExported = Document::Export(outputPath, false, nullptr);
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (pass == 0 || seconds < bestSeconds)
+			{
+				bestSeconds = seconds;
+			}
+		}
+		artSource = previousSource;
+
+		std::string output;
+		if (!isExported || !ReadFile(outputPath, output))
+		{
+			report << "\n  FAIL " << name << ": unable to export";
+			continue;
+		}
+
+		Baseline result;
+		result.bytes = NormalizeOutput(output).size();
+		result.milliseconds = bestSeconds * 1000.0;
+		results[name] = result;
+
+		// Replace the golden output?
+		if (update)
+		{
+			ofstream golden;
+			golden.open(goldenPath.c_str(), ios::out | ios::binary | ios::trunc);
+			golden.write(output.data(), output.size());
+			golden.close();
+			remove(outputPath.c_str());
+
+			report << "\n  UPDATED " << name << " (" << result.bytes << " bytes, " << result.milliseconds << " ms)";
+			passedCount++;
+			continue;
+		}
+
+		std::vector<std::string> problems;
+
+		// Compare against the golden output
+		std::string golden;
+		if (!ReadFile(goldenPath, golden))
+		{
+			problems.push_back("no golden output");
+		}
+		else
+		{
+			std::string difference = CompareOutput(NormalizeOutput(output), NormalizeOutput(golden));
+			if (!difference.empty())
+			{
+				problems.push_back(difference);
+			}
+		}
+
+		// Compare against the baseline
+		std::map<std::string, Baseline>::const_iterator baseline = baselines.find(name);
+		if (baseline != baselines.end())
+		{
+			const Baseline& expected = baseline->second;
+
+			if (expected.bytes > 0 &&
+				result.bytes > expected.bytes * (1.0 + sizeThreshold / 100.0))
+			{
+				std::ostringstream problem;
+				problem << setiosflags(ios::fixed) << setprecision(1) << "size " << expected.bytes << " -> " << result.bytes << " bytes (+" <<
+					(100.0 * ((double)result.bytes - (double)expected.bytes) / (double)expected.bytes) << "%, limit " << sizeThreshold << "%)";
+				problems.push_back(problem.str());
+			}
+
+			if (expected.milliseconds > 0.0 &&
+				result.milliseconds > expected.milliseconds * (1.0 + timeThreshold / 100.0) &&
+				(result.milliseconds - expected.milliseconds) >= kMinTimeDifference)
+			{
+				std::ostringstream problem;
+				problem << setiosflags(ios::fixed) << setprecision(1) << "time " << expected.milliseconds << " -> " << result.milliseconds << " ms (+" <<
+					(100.0 * (result.milliseconds - expected.milliseconds) / expected.milliseconds) << "%, limit " << timeThreshold << "%)";
+				problems.push_back(problem.str());
+			}
+		}
+
+		if (problems.empty())
+		{
+			// Output matches, so it isn't needed
+			remove(outputPath.c_str());
+
+			report << "\n  PASS " << name << " (" << result.bytes << " bytes, " << result.milliseconds << " ms)";
+			if (baseline == baselines.end())
+			{
+				report << ", no baseline";
+			}
+			passedCount++;
+		}
+		else
+		{
+			// Keep the output, so it can be compared with the golden output
+			report << "\n  FAIL " << name << ":";
+			for (size_t j = 0; j < problems.size(); j++)
+			{
+				report << (j > 0 ? "; " : " ") << problems[j];
+			}
+		}
+	}
+
+	// Restore state
+	exportOptions = previousOptions;
+	artSource = previousSource;
+	debug = previousDebug;
+
+	std::ostringstream summary;
+	if (update)
+	{
+		if (!WriteBaselines(results))
+		{
+			summary << "Unable to write baseline: " << listPath << ".baseline\n";
+		}
+		summary << "Regression: updated " << passedCount << " of " << names.size();
+	}
+	else
+	{
+		summary << "Regression: " << passedCount << " of " << names.size() << " passed";
+	}
+
+	return summary.str() + report.str();
+}
+
+// Read the corpus list: one snapshot name per line (without ".snapshot"), plus optional "time: percent" and "size: percent" thresholds
+bool Regression::ReadList()
+{
+	ifstream list;
+	list.open(listPath.c_str(), ios::in);
+	if (!list.is_open())
+	{
+		return false;
+	}
+
+	names.clear();
+
+	std::string line;
+	while (std::getline(list, line))
+	{
+		// Skip blank lines and comments
+		size_t first = line.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos || line[first] == '#')
+		{
+			continue;
+		}
+		line = line.substr(first, line.find_last_not_of(" \t\r\n") - first + 1);
+
+		// Threshold?
+		std::vector<std::string> split = Tokenize(line, ":");
+		if (split.size() == 2)
+		{
+			std::string parameter = split[0];
+			CleanParameter(parameter);
+			ToLower(parameter);
+
+			double value = strtod(split[1].c_str(), NULL);
+			if (parameter == "time" && value >= 0.0)
+			{
+				timeThreshold = value;
+				continue;
+			}
+			else if (parameter == "size" && value >= 0.0)
+			{
+				sizeThreshold = value;
+				continue;
+			}
+		}
+
+		names.push_back(line);
+	}
+
+	return true;
+}
+
+// The baseline is kept next to the list, one "name bytes milliseconds" line per snapshot
+void Regression::ReadBaselines()
+{
+	baselines.clear();
+
+	ifstream file;
+	file.open((listPath + ".baseline").c_str(), ios::in);
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream fields(line);
+		std::string name;
+		Baseline baseline;
+		if (fields >> name >> baseline.bytes >> baseline.milliseconds)
+		{
+			baselines[name] = baseline;
+		}
+	}
+}
+
+bool Regression::WriteBaselines(const std::map<std::string, Baseline>& results)
+{
+	// Keep baselines for anything that wasn't exported this time
+	std::map<std::string, Baseline> merged = baselines;
+	for (std::map<std::string, Baseline>::const_iterator it = results.begin(); it != results.end(); ++it)
+	{
+		merged[it->first] = it->second;
+	}
+
+	ofstream file;
+	file.open((listPath + ".baseline").c_str(), ios::out | ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << setiosflags(ios::fixed) << setprecision(3);
+	for (std::map<std::string, Baseline>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+	{
+		file << it->first << " " << it->second.bytes << " " << it->second.milliseconds << "\n";
+	}
+	file.close();
+
+	return !file.fail();
+}
+
+// Describe the first difference (or return an empty string if the output matches)
+std::string Regression::CompareOutput(const std::string& output, const std::string& golden)
+{
+	if (output == golden)
+	{
+		return "";
+	}
+
+	size_t length = (output.size() < golden.size()) ? output.size() : golden.size();
+	size_t offset = 0;
+	while (offset < length && output[offset] == golden[offset])
+	{
+		offset++;
+	}
+
+	size_t line = 1;
+	for (size_t i = 0; i < offset; i++)
+	{
+		if (output[i] == '\n')
+		{
+			line++;
+		}
+	}
+
+	std::ostringstream difference;
+	difference << "output differs from golden at line " << line << " (" << output.size() << " vs. " << golden.size() << " bytes)";
+	return difference.str();
+}
+
+bool Regression::ReadFile(const std::string& filePath, std::string& contents)
+{
+	ifstream file;
+	file.open(filePath.c_str(), ios::in | ios::binary);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	std::ostringstream buffer;
+	buffer << file.rdbuf();
+	contents = buffer.str();
+
+	return true;
+}
+
+// Output as it's compared: LF line endings, with the version banner blanked
+// (so golden output carries across plug-in versions and platforms)
+std::string Regression::NormalizeOutput(const std::string& output)
+{
+	std::string normalized;
+	normalized.reserve(output.size());
+
+	size_t begin = 0;
+	while (begin < output.size())
+	{
+		size_t end = output.find('\n', begin);
+		if (end == std::string::npos)
+		{
+			end = output.size();
+		}
+
+		size_t length = end - begin;
+		if (length > 0 && output[end - 1] == '\r')
+		{
+			length--;
+		}
+
+		bool isBanner = false;
+		for (size_t i = 0; i < sizeof(kBannerLines) / sizeof(kBannerLines[0]); i++)
+		{
+			if (output.compare(begin, strlen(kBannerLines[i]), kBannerLines[i]) == 0)
+			{
+				isBanner = true;
+			}
+		}
+
+		// (blank lines keep the reported line numbers)
+		if (!isBanner)
+		{
+			normalized.append(output, begin, length);
+		}
+		if (end < output.size())
+		{
+			normalized += '\n';
+		}
+
+		begin = end + 1;
+	}
+
+	return normalized;
+}
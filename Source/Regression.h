@@ -0,0 +1,76 @@
+// Regression.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <map>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Exports a corpus of snapshots and compares the results against golden output and a time/size baseline
+	/// (invoked via the "Regression" script command)
+	class Regression
+	{
+	private:
+
+		struct Baseline
+		{
+			size_t				bytes;					// Output size
+			double				milliseconds;			// Best export time
+		};
+
+		std::string			listPath;					// Corpus list
+		std::string			folderPath;					// Folder containing the corpus list (snapshots and golden output are relative to it)
+		std::vector<std::string>	names;				// Snapshot names (without extensions)
+		std::map<std::string, Baseline>	baselines;		// Baseline for each name
+		double				timeThreshold;				// Allowed time increase (percent)
+		double				sizeThreshold;				// Allowed size increase (percent)
+
+		bool				ReadList();
+		void				ReadBaselines();
+		bool				WriteBaselines(const std::map<std::string, Baseline>& results);
+		std::string			CompareOutput(const std::string& output, const std::string& golden);
+
+		static bool			ReadFile(const std::string& filePath, std::string& contents);
+		static std::string	NormalizeOutput(const std::string& output);
+
+	public:
+
+		static const int	kPasses = 3;				// Export passes (the best time is compared)
+
+		Regression(const std::string& listPath);
+		~Regression();
+
+		std::string			Run(bool update);
+	};
+}
+
+#endif
@@ -0,0 +1,116 @@
+// SegmentBuffer.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "SegmentBuffer.h"
+
+using namespace CanvasExport;
+
+SegmentBuffer::SegmentBuffer()
+{
+	// Initialize SegmentBuffer
+	this->count = 0;
+}
+
+SegmentBuffer::~SegmentBuffer()
+{
+}
+
+// Fetch every segment of a path (returns the segment count, or 0 if the segments can't be read)
+size_t SegmentBuffer::Fetch(AIArtHandle path)
+{
+	count = 0;
+
+	short segmentCount = 0;
+	artSource->GetPathSegmentCount(path, &segmentCount);
+	if (segmentCount <= 0)
+	{
+		return 0;
+	}
+
+	// Buffers only grow, so long paths are allocated once per export
+	if (fetched.size() < (size_t)segmentCount)
+	{
+		fetched.resize(segmentCount);
+		px.resize(segmentCount);
+		py.resize(segmentCount);
+		inx.resize(segmentCount);
+		iny.resize(segmentCount);
+		outx.resize(segmentCount);
+		outy.resize(segmentCount);
+	}
+
+	if (artSource->GetPathSegments(path, 0, segmentCount, fetched.data()) != kNoErr)
+	{
+		return 0;
+	}
+
+	// Split into coordinate arrays
+	for (short i = 0; i < segmentCount; i++)
+	{
+		const AIPathSegment& segment = fetched[i];
+		px[i] = segment.p.h;
+		py[i] = segment.p.v;
+		inx[i] = segment.in.h;
+		iny[i] = segment.in.v;
+		outx[i] = segment.out.h;
+		outy[i] = segment.out.v;
+	}
+
+	count = segmentCount;
+	return count;
+}
+
+// Transform every point by a matrix (the same arithmetic as AIRealMatrixXformPoint)
+void SegmentBuffer::Transform(const AIRealMatrix& matrix)
+{
+	TransformPoints(matrix, px.data(), py.data(), count);
+	TransformPoints(matrix, inx.data(), iny.data(), count);
+	TransformPoints(matrix, outx.data(), outy.data(), count);
+}
+
+// Harden every point (symbols are defined in their own coordinate space, so they aren't transformed)
+void SegmentBuffer::Harden()
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		AIRealPoint point;
+
+		point.h = px[i];
+		point.v = py[i];
+		artSource->AIRealPointHarden(&point, &point);
+		px[i] = point.h;
+		py[i] = point.v;
+
+		point.h = inx[i];
+		point.v = iny[i];
+		artSource->AIRealPointHarden(&point, &point);
+		inx[i] = point.h;
+		iny[i] = point.v;
+
+		point.h = outx[i];
+		point.v = outy[i];
+		artSource->AIRealPointHarden(&point, &point);
+		outx[i] = point.h;
+		outy[i] = point.v;
+	}
+}
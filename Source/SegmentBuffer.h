@@ -0,0 +1,72 @@
+// SegmentBuffer.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef SEGMENTBUFFER_H
+#define SEGMENTBUFFER_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include "PointTransform.h"
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Holds the segments of one path, fetched with a single call and kept as separate coordinate arrays (reused for every path in an export)
+	class SegmentBuffer
+	{
+	private:
+
+		std::vector<AIPathSegment>	fetched;			// Segments as returned by the art source
+
+	public:
+
+		SegmentBuffer();
+		~SegmentBuffer();
+
+		size_t				count;						// Segments in the current path
+		std::vector<AIReal>	px;							// Anchor points
+		std::vector<AIReal>	py;
+		std::vector<AIReal>	inx;						// Incoming control points
+		std::vector<AIReal>	iny;
+		std::vector<AIReal>	outx;						// Outgoing control points
+		std::vector<AIReal>	outy;
+
+		size_t				Fetch(AIArtHandle path);
+		void				Transform(const AIRealMatrix& matrix);
+		void				Harden();
+
+		/// Is the segment from previous to current a straight line? (neither control point is pulled away from its anchor)
+		inline bool			IsLine(size_t previous, size_t current) const
+		{
+			return ((px[previous] == outx[previous] && py[previous] == outy[previous]) &&
+					(px[current] == inx[current] && py[current] == iny[current]));
+		}
+
+		inline AIRealPoint	Point(size_t index) const	{ AIRealPoint point; point.h = px[index]; point.v = py[index]; return point; }
+	};
+}
+
+#endif
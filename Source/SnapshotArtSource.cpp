@@ -0,0 +1,1455 @@
+// SnapshotArtSource.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "SnapshotArtSource.h"
+#include "Utility.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#ifdef MAC_ENV
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace CanvasExport;
+
+// Tables are built in memory, then written in one pass
+struct SnapshotArtSource::SnapshotTables
+{
+	std::vector<SnapshotLayer>		layers;
+	std::vector<SnapshotArt>		art;
+	std::vector<AIPathSegment>		segments;
+	std::vector<SnapshotStyle>		styles;
+	std::vector<SnapshotGradient>	gradients;
+	std::vector<AIGradientStop>		stops;
+	std::vector<SnapshotPattern>	patterns;
+	std::vector<SnapshotSymbol>		symbols;
+	std::vector<SnapshotPlaced>		placed;
+	std::vector<SnapshotTextFrame>	textFrames;
+	std::vector<SnapshotTextLine>	textLines;
+	std::vector<SnapshotGlyphRun>	glyphRuns;
+	std::vector<char>				strings;
+
+	std::map<AIGradientHandle, uint32_t>	gradientIndexes;	// Each gradient and pattern is only captured once
+	std::map<AIPatternHandle, uint32_t>		patternIndexes;
+
+	std::map<std::string, uint32_t>			skipped;			// Art that wasn't captured (by art type, or "masked")
+};
+
+// Tables start on 8-byte boundaries, so records can be read in place
+static inline uint32_t AlignOffset(size_t offset)
+{
+	return (uint32_t)((offset + 7) & ~(size_t)7);
+}
+
+// Append a table to the file (unused padding is zero) and return its offset
+template <typename T>
+static uint32_t AddTable(std::vector<char>& buffer, const std::vector<T>& table)
+{
+	uint32_t offset = AlignOffset(buffer.size());
+	buffer.resize(offset + table.size() * sizeof(T), 0);
+	if (!table.empty())
+	{
+		memcpy(&buffer[offset], &table[0], table.size() * sizeof(T));
+	}
+	return offset;
+}
+
+SnapshotArtSource::SnapshotArtSource()
+{
+	// Initialize SnapshotArtSource
+	this->data = nullptr;
+	this->dataSize = 0;
+	this->header = nullptr;
+	this->layers = nullptr;
+	this->art = nullptr;
+	this->segments = nullptr;
+	this->styles = nullptr;
+	this->gradients = nullptr;
+	this->stops = nullptr;
+	this->patterns = nullptr;
+	this->symbols = nullptr;
+	this->placed = nullptr;
+	this->textFrames = nullptr;
+	this->textLines = nullptr;
+	this->glyphRuns = nullptr;
+	this->strings = nullptr;
+
+	#ifdef WIN_ENV
+		this->file = INVALID_HANDLE_VALUE;
+		this->mapping = NULL;
+	#endif
+}
+
+SnapshotArtSource::~SnapshotArtSource()
+{
+	Close();
+}
+
+// Capture everything the exporter reads from another source (usually the current document)
+// Art that can't be captured is described in skipped (e.g. "2 kMeshArt, 1 masked"), and is empty if everything was captured
+bool SnapshotArtSource::Write(ArtSource& source, const std::string& filePath, std::string& skipped)
+{
+	SnapshotTables tables;
+
+	ai::int32 layerCount = 0;
+	source.CountLayers(&layerCount);
+
+	for (ai::int32 i = 0; i < layerCount; i++)
+	{
+		AILayerHandle layerHandle = nullptr;
+		if (source.GetNthLayer(i, &layerHandle) != kNoErr)
+		{
+			continue;
+		}
+
+		AIBoolean visible = false;
+		source.GetLayerVisible(layerHandle, &visible);
+
+		std::string title;
+		source.GetLayerTitle(layerHandle, title);
+
+		SnapshotLayer layer;
+		layer.title = AddString(title, tables);
+		layer.visible = visible ? 1 : 0;
+		layer.firstArt = kNone;
+		layer.reserved = 0;
+
+		AIArtHandle artHandle = nullptr;
+		source.GetFirstArtOfLayer(layerHandle, &artHandle);
+		layer.firstArt = CaptureChain(source, artHandle, 0, tables);
+
+		tables.layers.push_back(layer);
+	}
+
+	skipped.clear();
+	for (std::map<std::string, uint32_t>::const_iterator it = tables.skipped.begin(); it != tables.skipped.end(); ++it)
+	{
+		if (!skipped.empty())
+		{
+			skipped += ", ";
+		}
+		skipped += std::to_string(it->second) + " " + it->first;
+	}
+
+	// Lay out the file (the header is written last, once the offsets are known)
+	SnapshotHeader fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	memcpy(fileHeader.magic, "AI2CSNAP", 8);
+	fileHeader.version = kVersion;
+	fileHeader.layerCount = (uint32_t)tables.layers.size();
+	fileHeader.artCount = (uint32_t)tables.art.size();
+	fileHeader.segmentCount = (uint32_t)tables.segments.size();
+	fileHeader.styleCount = (uint32_t)tables.styles.size();
+	fileHeader.gradientCount = (uint32_t)tables.gradients.size();
+	fileHeader.stopCount = (uint32_t)tables.stops.size();
+	fileHeader.patternCount = (uint32_t)tables.patterns.size();
+	fileHeader.symbolCount = (uint32_t)tables.symbols.size();
+	fileHeader.placedCount = (uint32_t)tables.placed.size();
+	fileHeader.textFrameCount = (uint32_t)tables.textFrames.size();
+	fileHeader.textLineCount = (uint32_t)tables.textLines.size();
+	fileHeader.glyphRunCount = (uint32_t)tables.glyphRuns.size();
+
+	std::vector<char> buffer(sizeof(SnapshotHeader), 0);
+	fileHeader.layersOffset = AddTable(buffer, tables.layers);
+	fileHeader.artOffset = AddTable(buffer, tables.art);
+	fileHeader.segmentsOffset = AddTable(buffer, tables.segments);
+	fileHeader.stylesOffset = AddTable(buffer, tables.styles);
+	fileHeader.gradientsOffset = AddTable(buffer, tables.gradients);
+	fileHeader.stopsOffset = AddTable(buffer, tables.stops);
+	fileHeader.patternsOffset = AddTable(buffer, tables.patterns);
+	fileHeader.symbolsOffset = AddTable(buffer, tables.symbols);
+	fileHeader.placedOffset = AddTable(buffer, tables.placed);
+	fileHeader.textFramesOffset = AddTable(buffer, tables.textFrames);
+	fileHeader.textLinesOffset = AddTable(buffer, tables.textLines);
+	fileHeader.glyphRunsOffset = AddTable(buffer, tables.glyphRuns);
+	fileHeader.stringsOffset = AddTable(buffer, tables.strings);
+	fileHeader.stringsSize = (uint32_t)tables.strings.size();
+	fileHeader.size = (uint32_t)buffer.size();
+	memcpy(&buffer[0], &fileHeader, sizeof(fileHeader));
+
+	std::ofstream stream;
+	stream.open(filePath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+	stream.write(&buffer[0], buffer.size());
+	stream.close();
+
+	return !stream.fail();
+}
+
+// Capture art and its siblings (returns the index of the first captured art, or kNone)
+uint32_t SnapshotArtSource::CaptureChain(ArtSource& source, AIArtHandle artHandle, uint32_t depth, SnapshotTables& tables)
+{
+	uint32_t firstIndex = kNone;
+	uint32_t previousIndex = kNone;
+
+	while (artHandle)
+	{
+		uint32_t index = CaptureArt(source, artHandle, depth, tables);
+
+		// Link into the sibling chain (art that wasn't captured is left out)
+		if (index != kNone)
+		{
+			if (previousIndex == kNone)
+			{
+				firstIndex = index;
+			}
+			else
+			{
+				tables.art[previousIndex].sibling = index;
+			}
+			previousIndex = index;
+		}
+
+		if (source.GetArtSibling(artHandle, &artHandle) != kNoErr)
+		{
+			break;
+		}
+	}
+
+	return firstIndex;
+}
+
+// Capture a single art object and its children (children are captured first, so each record is complete when it's added)
+// Returns kNone for art that can't be replayed (and counts it as skipped)
+uint32_t SnapshotArtSource::CaptureArt(ArtSource& source, AIArtHandle artHandle, uint32_t depth, SnapshotTables& tables)
+{
+	// Everything else is read through suites that a snapshot can't replay (meshes, plug-in art, legacy text, ...)
+	short type = kUnknownArt;
+	source.GetArtType(artHandle, &type);
+	if (type != kGroupArt && type != kCompoundPathArt && type != kPathArt &&
+		type != kSymbolArt && type != kPlacedArt && type != kRasterArt && type != kTextFrameArt)
+	{
+		tables.skipped[ArtTypeName(type)]++;
+		return kNone;
+	}
+
+	// Only the attributes the exporter tests are kept
+	ai::int32 userAttr = 0;
+	source.GetArtUserAttr(artHandle, kArtHidden | kArtPartOfCompound, &userAttr);
+
+	// Visible art with an opacity mask is rasterized, which needs the document
+	if ((userAttr & kArtHidden) != kArtHidden)
+	{
+		AIMaskRef mask = nullptr;
+		source.GetMask(artHandle, &mask);
+		if (mask != nullptr)
+		{
+			tables.skipped["masked"]++;
+			return kNone;
+		}
+	}
+
+	SnapshotArt record;
+	memset(&record, 0, sizeof(record));
+	record.type = type;
+	record.userAttr = userAttr;
+	record.name = kNone;
+	record.firstChild = kNone;
+	record.sibling = kNone;
+	record.style = kNone;
+	record.detail = kNone;
+
+	// Symbols, placed and raster art, and text frames keep what the exporter reads from them in their own tables
+	if (type == kSymbolArt)
+	{
+		record.detail = CaptureSymbol(source, artHandle, tables);
+	}
+	else if (type == kPlacedArt || type == kRasterArt)
+	{
+		record.detail = CapturePlaced(source, artHandle, type, tables);
+	}
+	else if (type == kTextFrameArt)
+	{
+		record.detail = CaptureTextFrame(source, artHandle, tables);
+	}
+	if ((type == kSymbolArt || type == kPlacedArt || type == kRasterArt || type == kTextFrameArt) && record.detail == kNone)
+	{
+		tables.skipped[ArtTypeName(type)]++;
+		return kNone;
+	}
+
+	std::string name;
+	ASBoolean isDefaultName = true;
+	source.GetArtName(artHandle, name, &isDefaultName);
+	if (!isDefaultName)
+	{
+		record.name = AddString(name, tables);
+	}
+
+	source.GetArtBounds(artHandle, &record.bounds);
+	record.opacity = source.GetOpacity(artHandle);
+	record.blendingMode = source.GetBlendingMode(artHandle);
+
+	// Path geometry
+	if (type == kPathArt)
+	{
+		short segmentCount = 0;
+		source.GetPathSegmentCount(artHandle, &segmentCount);
+
+		record.firstSegment = (uint32_t)tables.segments.size();
+		if (segmentCount > 0)
+		{
+			tables.segments.resize(tables.segments.size() + segmentCount);
+			if (source.GetPathSegments(artHandle, 0, segmentCount, &tables.segments[record.firstSegment]) == kNoErr)
+			{
+				record.segmentCount = segmentCount;
+			}
+			else
+			{
+				tables.segments.resize(record.firstSegment);
+			}
+		}
+
+		AIBoolean closed = false;
+		source.GetPathClosed(artHandle, &closed);
+		record.closed = closed ? 1 : 0;
+
+		AIBoolean guide = false;
+		source.GetPathGuide(artHandle, &guide);
+		record.guide = guide ? 1 : 0;
+	}
+
+	// Style (any art with a path style)
+	AIPathStyle style;
+	AIBoolean hasAdvancedFill = false;
+	if (source.GetPathStyle(artHandle, &style, &hasAdvancedFill) == kNoErr)
+	{
+		record.style = CaptureStyle(source, style, tables);
+		record.hasAdvancedFill = hasAdvancedFill ? 1 : 0;
+	}
+
+	// Children (art nested deeper than kMaxDepth isn't captured)
+	AIArtHandle childHandle = nullptr;
+	source.GetArtFirstChild(artHandle, &childHandle);
+	if (childHandle && depth < kMaxDepth)
+	{
+		record.firstChild = CaptureChain(source, childHandle, (depth + 1), tables);
+	}
+	else if (childHandle)
+	{
+		tables.skipped["deeply nested"]++;
+	}
+
+	tables.art.push_back(record);
+	return (uint32_t)(tables.art.size() - 1);
+}
+
+// Capture a path style (with its gradients and patterns)
+uint32_t SnapshotArtSource::CaptureStyle(ArtSource& source, const AIPathStyle& style, SnapshotTables& tables)
+{
+	SnapshotStyle record;
+	memset(&record, 0, sizeof(record));
+	record.style = style;
+	record.fillPaint = CapturePaint(source, record.style.fill.color, record.style.fillPaint, tables);
+	record.strokePaint = CapturePaint(source, record.style.stroke.color, record.style.strokePaint, tables);
+
+	tables.styles.push_back(record);
+	return (uint32_t)(tables.styles.size() - 1);
+}
+
+// Replace a color's handle with a value or table index (returns the gradient or pattern index, or kNone)
+// A color that can't be captured isn't painted
+uint32_t SnapshotArtSource::CapturePaint(ArtSource& source, AIColor& color, AIBoolean& paint, SnapshotTables& tables)
+{
+	uint32_t index = kNone;
+	bool isCaptured = true;
+
+	switch (color.kind)
+	{
+		case kGradient:
+		{
+			index = CaptureGradient(source, color.c.b.gradient, tables);
+			color.c.b.gradient = nullptr;
+			break;
+		}
+		case kPattern:
+		{
+			index = CapturePattern(source, color.c.p.pattern, tables);
+			color.c.p.pattern = nullptr;
+			isCaptured = (tables.patterns[index].art != kNone);
+			break;
+		}
+		case kCustomColor:
+		{
+			isCaptured = CaptureColor(source, color);
+			break;
+		}
+		case kGrayColor:
+		case kFourColor:
+		case kThreeColor:
+		case kNoneColor:
+		case kAdvanceColor:
+		{
+			break;
+		}
+	}
+
+	if (!isCaptured)
+	{
+		color.kind = kNoneColor;
+		paint = false;
+		index = kNone;
+	}
+
+	return index;
+}
+
+uint32_t SnapshotArtSource::CaptureGradient(ArtSource& source, AIGradientHandle gradientHandle, SnapshotTables& tables)
+{
+	std::map<AIGradientHandle, uint32_t>::const_iterator captured = tables.gradientIndexes.find(gradientHandle);
+	if (captured != tables.gradientIndexes.end())
+	{
+		return captured->second;
+	}
+
+	SnapshotGradient gradient;
+	memset(&gradient, 0, sizeof(gradient));
+
+	short type = kLinearGradient;
+	source.GetGradientType(gradientHandle, &type);
+	gradient.type = type;
+
+	short count = 0;
+	source.GetGradientStopCount(gradientHandle, &count);
+	gradient.firstStop = (uint32_t)tables.stops.size();
+	for (short i = 0; i < count; i++)
+	{
+		AIGradientStop stop;
+		if (source.GetNthGradientStop(gradientHandle, i, &stop) == kNoErr)
+		{
+			// A stop always has a color (Lab colors can't be converted, so they're stored as gray)
+			if (!CaptureColor(source, stop.color))
+			{
+				stop.color.kind = kGrayColor;
+				stop.color.c.g.gray = 0.0;
+			}
+			tables.stops.push_back(stop);
+		}
+	}
+	gradient.stopCount = (uint32_t)tables.stops.size() - gradient.firstStop;
+
+	uint32_t index = (uint32_t)tables.gradients.size();
+	tables.gradients.push_back(gradient);
+	tables.gradientIndexes[gradientHandle] = index;
+	return index;
+}
+
+// Capture a pattern and its art (a pattern whose art can't be captured has no art)
+uint32_t SnapshotArtSource::CapturePattern(ArtSource& source, AIPatternHandle patternHandle, SnapshotTables& tables)
+{
+	std::map<AIPatternHandle, uint32_t>::const_iterator captured = tables.patternIndexes.find(patternHandle);
+	if (captured != tables.patternIndexes.end())
+	{
+		return captured->second;
+	}
+
+	std::string name;
+	source.GetPatternName(patternHandle, name);
+
+	SnapshotPattern pattern;
+	pattern.name = AddString(name, tables);
+	pattern.art = kNone;
+
+	// Added before its art is captured, so the art can't capture it again
+	uint32_t index = (uint32_t)tables.patterns.size();
+	tables.patterns.push_back(pattern);
+	tables.patternIndexes[patternHandle] = index;
+
+	AIArtHandle artHandle = nullptr;
+	if (source.GetPatternArt(patternHandle, &artHandle) == kNoErr && artHandle)
+	{
+		uint32_t art = CaptureArt(source, artHandle, 0, tables);
+		tables.patterns[index].art = art;
+	}
+
+	return index;
+}
+
+// Capture a symbol's definition (a pattern) and transform (returns the symbol index, or kNone)
+uint32_t SnapshotArtSource::CaptureSymbol(ArtSource& source, AIArtHandle artHandle, SnapshotTables& tables)
+{
+	AIPatternHandle patternHandle = nullptr;
+	if (source.GetSymbolPatternOfSymbolArt(artHandle, &patternHandle) != kNoErr || !patternHandle)
+	{
+		return kNone;
+	}
+
+	SnapshotSymbol symbol;
+	memset(&symbol, 0, sizeof(symbol));
+	if (source.GetSoftTransformOfSymbolArt(artHandle, &symbol.transform) != kNoErr)
+	{
+		return kNone;
+	}
+
+	// A symbol whose definition can't be captured can't be drawn
+	symbol.pattern = CapturePattern(source, patternHandle, tables);
+	if (tables.patterns[symbol.pattern].art == kNone)
+	{
+		return kNone;
+	}
+
+	tables.symbols.push_back(symbol);
+	return (uint32_t)(tables.symbols.size() - 1);
+}
+
+// Capture placed or raster art as a reference to its file (the pixels themselves aren't captured)
+uint32_t SnapshotArtSource::CapturePlaced(ArtSource& source, AIArtHandle artHandle, short type, SnapshotTables& tables)
+{
+	SnapshotPlaced record;
+	memset(&record, 0, sizeof(record));
+
+	std::string filePath;
+	if (type == kPlacedArt)
+	{
+		short placedType = kEPSType;
+		AIBoolean isRaster = false;
+		if (source.GetPlacedType(artHandle, &placedType) != kNoErr ||
+			source.GetPlacedFilePath(artHandle, filePath) != kNoErr ||
+			source.GetPlacedMatrix(artHandle, &record.matrix) != kNoErr ||
+			source.GetPlacedRasterInfo(artHandle, &record.info, &isRaster) != kNoErr)
+		{
+			return kNone;
+		}
+		record.placedType = placedType;
+		record.isRaster = isRaster ? 1 : 0;
+	}
+	else
+	{
+		source.GetRasterFilePath(artHandle, filePath);
+	}
+	record.filePath = AddString(filePath, tables);
+
+	tables.placed.push_back(record);
+	return (uint32_t)(tables.placed.size() - 1);
+}
+
+// Capture a text frame's lines and glyph runs (returns the text frame index, or kNone)
+uint32_t SnapshotArtSource::CaptureTextFrame(ArtSource& source, AIArtHandle artHandle, SnapshotTables& tables)
+{
+	TextFrame textFrame;
+	if (source.GetTextFrame(artHandle, textFrame) != kNoErr)
+	{
+		return kNone;
+	}
+
+	SnapshotTextFrame record;
+	memset(&record, 0, sizeof(record));
+	record.matrix = textFrame.matrix;
+	record.firstLine = (uint32_t)tables.textLines.size();
+	record.lineCount = (uint32_t)textFrame.lines.size();
+
+	for (size_t i = 0; i < textFrame.lines.size(); i++)
+	{
+		SnapshotTextLine line;
+		line.firstRun = (uint32_t)tables.glyphRuns.size();
+		line.runCount = (uint32_t)textFrame.lines[i].glyphRuns.size();
+		tables.textLines.push_back(line);
+
+		for (size_t j = 0; j < textFrame.lines[i].glyphRuns.size(); j++)
+		{
+			CaptureGlyphRun(source, textFrame.lines[i].glyphRuns[j], tables);
+		}
+	}
+
+	tables.textFrames.push_back(record);
+	return (uint32_t)(tables.textFrames.size() - 1);
+}
+
+void SnapshotArtSource::CaptureGlyphRun(ArtSource& source, const GlyphRun& glyphRun, SnapshotTables& tables)
+{
+	SnapshotGlyphRun record;
+	memset(&record, 0, sizeof(record));
+	record.matrix = glyphRun.matrix;
+	record.origin = glyphRun.origin;
+	record.fontSize = glyphRun.fontSize;
+	record.verticalScale = glyphRun.verticalScale;
+	record.horizontalScale = glyphRun.horizontalScale;
+	record.lineWidth = glyphRun.lineWidth;
+	record.contents = AddString(glyphRun.contents, tables);
+	record.fontName = AddString(glyphRun.fontName, tables);
+	record.fontStyleName = AddString(glyphRun.fontStyleName, tables);
+	record.hasFont = glyphRun.hasFont ? 1 : 0;
+	record.hasLineWidth = glyphRun.hasLineWidth ? 1 : 0;
+	record.hasLineCap = glyphRun.hasLineCap ? 1 : 0;
+	record.hasLineJoin = glyphRun.hasLineJoin ? 1 : 0;
+	record.lineCap = glyphRun.lineCap;
+	record.lineJoin = glyphRun.lineJoin;
+
+	// Paints are captured just as they are for path styles
+	AIBoolean hasFill = glyphRun.hasFill;
+	record.fillColor = glyphRun.fillColor;
+	record.fillPaint = CapturePaint(source, record.fillColor, hasFill, tables);
+	record.hasFill = hasFill ? 1 : 0;
+
+	AIBoolean hasStroke = glyphRun.hasStroke;
+	record.strokeColor = glyphRun.strokeColor;
+	record.strokePaint = CapturePaint(source, record.strokeColor, hasStroke, tables);
+	record.hasStroke = hasStroke ? 1 : 0;
+
+	tables.glyphRuns.push_back(record);
+}
+
+// Convert a custom color to the process color it's defined with (custom color handles don't outlast the document)
+// Returns false for a color that can't be converted
+bool SnapshotArtSource::CaptureColor(ArtSource& source, AIColor& color)
+{
+	if (color.kind != kCustomColor)
+	{
+		return true;
+	}
+
+	AICustomColor customColor;
+	if (source.GetCustomColor(color.c.c.color, &customColor) != kNoErr)
+	{
+		return false;
+	}
+
+	// The tint isn't used (just as when a custom color is converted to RGB)
+	switch (customColor.kind)
+	{
+		case kCustomFourColor:
+		{
+			color.kind = kFourColor;
+			color.c.f = customColor.c.f;
+			return true;
+		}
+		case kCustomThreeColor:
+		{
+			color.kind = kThreeColor;
+			color.c.rgb = customColor.c.rgb;
+			return true;
+		}
+		case kCustomLabColor:
+		{
+			break;
+		}
+	}
+	return false;
+}
+
+uint32_t SnapshotArtSource::AddString(const std::string& string, SnapshotTables& tables)
+{
+	uint32_t offset = (uint32_t)tables.strings.size();
+	tables.strings.insert(tables.strings.end(), string.begin(), string.end());
+	tables.strings.push_back('\0');
+	return offset;
+}
+
+// Map a snapshot file (read-only)
+bool SnapshotArtSource::Open(const std::string& filePath)
+{
+	Close();
+
+	#ifdef MAC_ENV
+		int descriptor = open(filePath.c_str(), O_RDONLY);
+		if (descriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat status;
+		if (fstat(descriptor, &status) != 0 || status.st_size < (off_t)sizeof(SnapshotHeader))
+		{
+			close(descriptor);
+			return false;
+		}
+
+		void* address = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		close(descriptor);
+		if (address == MAP_FAILED)
+		{
+			return false;
+		}
+
+		this->data = (const char*)address;
+		this->dataSize = (size_t)status.st_size;
+	#endif
+	#ifdef WIN_ENV
+		this->file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (this->file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(this->file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(SnapshotHeader))
+		{
+			Close();
+			return false;
+		}
+
+		this->mapping = CreateFileMappingA(this->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (this->mapping == NULL)
+		{
+			Close();
+			return false;
+		}
+
+		this->data = (const char*)MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+		this->dataSize = (size_t)fileSize.QuadPart;
+		if (this->data == nullptr)
+		{
+			Close();
+			return false;
+		}
+	#endif
+
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void SnapshotArtSource::Close()
+{
+	#ifdef MAC_ENV
+		if (data)
+		{
+			munmap((void*)data, dataSize);
+		}
+	#endif
+	#ifdef WIN_ENV
+		if (data)
+		{
+			UnmapViewOfFile(data);
+		}
+		if (mapping != NULL)
+		{
+			CloseHandle(mapping);
+			mapping = NULL;
+		}
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+	#endif
+
+	data = nullptr;
+	dataSize = 0;
+	header = nullptr;
+	layers = nullptr;
+	art = nullptr;
+	segments = nullptr;
+	styles = nullptr;
+	gradients = nullptr;
+	stops = nullptr;
+	patterns = nullptr;
+	symbols = nullptr;
+	placed = nullptr;
+	textFrames = nullptr;
+	textLines = nullptr;
+	glyphRuns = nullptr;
+	strings = nullptr;
+}
+
+// Touch each page, so the file is read before it's replayed (rather than while)
+void SnapshotArtSource::Prefetch() const
+{
+	volatile char sum = 0;
+	for (size_t i = 0; i < dataSize; i += 4096)
+	{
+		sum += data[i];
+	}
+}
+
+// Check the header, table bounds and links once, so the accessors can trust them
+bool SnapshotArtSource::Validate()
+{
+	header = (const SnapshotHeader*)data;
+	if (memcmp(header->magic, "AI2CSNAP", 8) != 0 ||
+		header->version != kVersion ||
+		header->size != dataSize)
+	{
+		return false;
+	}
+
+	// Every table must fit (and be aligned) within the file
+	const uint32_t offsets[13] = { header->layersOffset, header->artOffset, header->segmentsOffset, header->stylesOffset,
+		header->gradientsOffset, header->stopsOffset, header->patternsOffset, header->symbolsOffset, header->placedOffset,
+		header->textFramesOffset, header->textLinesOffset, header->glyphRunsOffset, header->stringsOffset };
+	const uint64_t sizes[13] = { (uint64_t)header->layerCount * sizeof(SnapshotLayer), (uint64_t)header->artCount * sizeof(SnapshotArt),
+		(uint64_t)header->segmentCount * sizeof(AIPathSegment), (uint64_t)header->styleCount * sizeof(SnapshotStyle),
+		(uint64_t)header->gradientCount * sizeof(SnapshotGradient), (uint64_t)header->stopCount * sizeof(AIGradientStop),
+		(uint64_t)header->patternCount * sizeof(SnapshotPattern), (uint64_t)header->symbolCount * sizeof(SnapshotSymbol),
+		(uint64_t)header->placedCount * sizeof(SnapshotPlaced), (uint64_t)header->textFrameCount * sizeof(SnapshotTextFrame),
+		(uint64_t)header->textLineCount * sizeof(SnapshotTextLine), (uint64_t)header->glyphRunCount * sizeof(SnapshotGlyphRun),
+		header->stringsSize };
+	for (int i = 0; i < 13; i++)
+	{
+		if ((offsets[i] & 7) != 0 || (uint64_t)offsets[i] + sizes[i] > dataSize)
+		{
+			return false;
+		}
+	}
+	if (header->stringsSize > 0 && data[header->stringsOffset + header->stringsSize - 1] != '\0')
+	{
+		return false;
+	}
+
+	layers = (const SnapshotLayer*)(data + header->layersOffset);
+	art = (const SnapshotArt*)(data + header->artOffset);
+	segments = (const AIPathSegment*)(data + header->segmentsOffset);
+	styles = (const SnapshotStyle*)(data + header->stylesOffset);
+	gradients = (const SnapshotGradient*)(data + header->gradientsOffset);
+	stops = (const AIGradientStop*)(data + header->stopsOffset);
+	patterns = (const SnapshotPattern*)(data + header->patternsOffset);
+	symbols = (const SnapshotSymbol*)(data + header->symbolsOffset);
+	placed = (const SnapshotPlaced*)(data + header->placedOffset);
+	textFrames = (const SnapshotTextFrame*)(data + header->textFramesOffset);
+	textLines = (const SnapshotTextLine*)(data + header->textLinesOffset);
+	glyphRuns = (const SnapshotGlyphRun*)(data + header->glyphRunsOffset);
+	strings = data + header->stringsOffset;
+
+	for (uint32_t i = 0; i < header->layerCount; i++)
+	{
+		if ((layers[i].firstArt != kNone && layers[i].firstArt >= header->artCount) ||
+			layers[i].title >= header->stringsSize)
+		{
+			return false;
+		}
+	}
+
+	// Only art that's captured can be replayed (anything else would be passed to the SDK)
+	for (uint32_t i = 0; i < header->artCount; i++)
+	{
+		const SnapshotArt& record = art[i];
+		bool hasDetail = true;
+		uint32_t detailCount = 0;
+		switch (record.type)
+		{
+			case kGroupArt:
+			case kCompoundPathArt:
+			case kPathArt:
+			{
+				hasDetail = false;
+				break;
+			}
+			case kSymbolArt:
+			{
+				detailCount = header->symbolCount;
+				break;
+			}
+			case kPlacedArt:
+			case kRasterArt:
+			{
+				detailCount = header->placedCount;
+				break;
+			}
+			case kTextFrameArt:
+			{
+				detailCount = header->textFrameCount;
+				break;
+			}
+			default:
+			{
+				return false;
+			}
+		}
+		if ((hasDetail ? (record.detail >= detailCount) : (record.detail != kNone)) ||
+			(record.firstChild != kNone && record.firstChild >= header->artCount) ||
+			(record.sibling != kNone && record.sibling >= header->artCount) ||
+			(record.style != kNone && record.style >= header->styleCount) ||
+			(record.name != kNone && record.name >= header->stringsSize) ||
+			record.blendingMode < kAINormalBlendingMode || record.blendingMode >= kAINumBlendingModes ||
+			record.segmentCount > 0x7FFF ||
+			(uint64_t)record.firstSegment + record.segmentCount > header->segmentCount)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->styleCount; i++)
+	{
+		if (!ValidatePaint(styles[i].style.fill.color, styles[i].fillPaint) ||
+			!ValidatePaint(styles[i].style.stroke.color, styles[i].strokePaint))
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->gradientCount; i++)
+	{
+		if (gradients[i].stopCount > 0x7FFF ||
+			(uint64_t)gradients[i].firstStop + gradients[i].stopCount > header->stopCount)
+		{
+			return false;
+		}
+	}
+
+	// Stops only have process colors
+	for (uint32_t i = 0; i < header->stopCount; i++)
+	{
+		if (stops[i].color.kind != kGrayColor && stops[i].color.kind != kFourColor && stops[i].color.kind != kThreeColor)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->patternCount; i++)
+	{
+		if (patterns[i].art >= header->artCount ||
+			patterns[i].name >= header->stringsSize)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->symbolCount; i++)
+	{
+		if (symbols[i].pattern >= header->patternCount)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->placedCount; i++)
+	{
+		if (placed[i].filePath >= header->stringsSize)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->textFrameCount; i++)
+	{
+		if ((uint64_t)textFrames[i].firstLine + textFrames[i].lineCount > header->textLineCount)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->textLineCount; i++)
+	{
+		if ((uint64_t)textLines[i].firstRun + textLines[i].runCount > header->glyphRunCount)
+		{
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->glyphRunCount; i++)
+	{
+		const SnapshotGlyphRun& record = glyphRuns[i];
+		if (record.contents >= header->stringsSize ||
+			record.fontName >= header->stringsSize ||
+			record.fontStyleName >= header->stringsSize ||
+			!ValidatePaint(record.fillColor, record.fillPaint) ||
+			!ValidatePaint(record.strokeColor, record.strokePaint))
+		{
+			return false;
+		}
+	}
+
+	return ValidateTree();
+}
+
+// Gradients and patterns must be in their tables (custom colors are always converted when they're captured)
+bool SnapshotArtSource::ValidatePaint(const AIColor& color, uint32_t paint) const
+{
+	switch (color.kind)
+	{
+		case kGrayColor:
+		case kFourColor:
+		case kThreeColor:
+		case kNoneColor:
+		case kAdvanceColor:
+		{
+			return true;
+		}
+		case kGradient:
+		{
+			return (paint < header->gradientCount);
+		}
+		case kPattern:
+		{
+			return (paint < header->patternCount);
+		}
+		case kCustomColor:
+		{
+			break;
+		}
+	}
+	return false;
+}
+
+// Art must form trees that the renderer can walk: each record is linked to at most once (so a chain can't loop back on itself),
+// and art is nested no deeper than kMaxDepth
+bool SnapshotArtSource::ValidateTree() const
+{
+	// Every link to a record (layers and patterns first, since they're where walks start)
+	std::vector<uint32_t> links;
+	for (uint32_t i = 0; i < header->layerCount; i++)
+	{
+		if (layers[i].firstArt != kNone)
+		{
+			links.push_back(layers[i].firstArt);
+		}
+	}
+	for (uint32_t i = 0; i < header->patternCount; i++)
+	{
+		links.push_back(patterns[i].art);
+	}
+	size_t rootCount = links.size();
+	for (uint32_t i = 0; i < header->artCount; i++)
+	{
+		if (art[i].firstChild != kNone)
+		{
+			links.push_back(art[i].firstChild);
+		}
+		if (art[i].sibling != kNone)
+		{
+			links.push_back(art[i].sibling);
+		}
+	}
+
+	std::vector<bool> isLinked(header->artCount, false);
+	for (size_t i = 0; i < links.size(); i++)
+	{
+		if (isLinked[links[i]])
+		{
+			return false;
+		}
+		isLinked[links[i]] = true;
+	}
+
+	// Walk from each root (without recursion, so a deep file can't overflow the stack here)
+	std::vector< std::pair<uint32_t, uint32_t> > pending;
+	for (size_t i = 0; i < rootCount; i++)
+	{
+		pending.push_back(std::make_pair(links[i], (uint32_t)0));
+	}
+	while (!pending.empty())
+	{
+		uint32_t index = pending.back().first;
+		uint32_t depth = pending.back().second;
+		pending.pop_back();
+
+		if (depth > kMaxDepth)
+		{
+			return false;
+		}
+
+		if (art[index].sibling != kNone)
+		{
+			pending.push_back(std::make_pair(art[index].sibling, depth));
+		}
+		if (art[index].firstChild != kNone)
+		{
+			pending.push_back(std::make_pair(art[index].firstChild, (depth + 1)));
+		}
+	}
+
+	return true;
+}
+
+AIArtHandle SnapshotArtSource::ToHandle(uint32_t index) const
+{
+	return (index == kNone) ? nullptr : reinterpret_cast<AIArtHandle>(const_cast<SnapshotArt*>(&art[index]));
+}
+
+// Point a gradient or pattern color at its record
+void SnapshotArtSource::ToHandle(AIColor& color, uint32_t paint) const
+{
+	if (color.kind == kGradient)
+	{
+		color.c.b.gradient = reinterpret_cast<AIGradientHandle>(const_cast<SnapshotGradient*>(&gradients[paint]));
+	}
+	else if (color.kind == kPattern)
+	{
+		color.c.p.pattern = reinterpret_cast<AIPatternHandle>(const_cast<SnapshotPattern*>(&patterns[paint]));
+	}
+}
+
+// Placed and raster art share a table
+const SnapshotArtSource::SnapshotPlaced* SnapshotArtSource::ToPlaced(AIArtHandle handle) const
+{
+	const SnapshotArt* record = ToArt(handle);
+	return (record->type == kPlacedArt || record->type == kRasterArt) ? &placed[record->detail] : nullptr;
+}
+
+AIErr SnapshotArtSource::CountLayers(ai::int32* count)
+{
+	*count = header ? (ai::int32)header->layerCount : 0;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetNthLayer(ai::int32 n, AILayerHandle* layer)
+{
+	if (!header || n < 0 || (uint32_t)n >= header->layerCount)
+	{
+		*layer = nullptr;
+		return kBadParameterErr;
+	}
+
+	*layer = reinterpret_cast<AILayerHandle>(const_cast<SnapshotLayer*>(&layers[n]));
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetLayerVisible(AILayerHandle layer, AIBoolean* visible)
+{
+	*visible = (reinterpret_cast<const SnapshotLayer*>(layer)->visible != 0);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetLayerTitle(AILayerHandle layer, std::string& title)
+{
+	title = strings + reinterpret_cast<const SnapshotLayer*>(layer)->title;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art)
+{
+	*art = ToHandle(reinterpret_cast<const SnapshotLayer*>(layer)->firstArt);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetArtFirstChild(AIArtHandle art, AIArtHandle* child)
+{
+	*child = art ? ToHandle(ToArt(art)->firstChild) : nullptr;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr SnapshotArtSource::GetArtSibling(AIArtHandle art, AIArtHandle* sibling)
+{
+	*sibling = art ? ToHandle(ToArt(art)->sibling) : nullptr;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr SnapshotArtSource::GetArtType(AIArtHandle art, short* type)
+{
+	*type = art ? (short)ToArt(art)->type : (short)kUnknownArt;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr SnapshotArtSource::GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr)
+{
+	*attr = art ? (ToArt(art)->userAttr & whichAttr) : 0;
+	return (art ? kNoErr : kBadParameterErr);
+}
+
+AIErr SnapshotArtSource::GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName)
+{
+	uint32_t nameOffset = ToArt(art)->name;
+	name = (nameOffset == kNone) ? "" : strings + nameOffset;
+	if (isDefaultName)
+	{
+		*isDefaultName = (nameOffset == kNone);
+	}
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetArtBounds(AIArtHandle art, AIRealRect* bounds)
+{
+	*bounds = ToArt(art)->bounds;
+	return kNoErr;
+}
+
+AIReal SnapshotArtSource::GetOpacity(AIArtHandle art)
+{
+	return ToArt(art)->opacity;
+}
+
+AIBlendingMode SnapshotArtSource::GetBlendingMode(AIArtHandle art)
+{
+	return (AIBlendingMode)ToArt(art)->blendingMode;
+}
+
+AIErr SnapshotArtSource::GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects)
+{
+	liveEffects.clear();
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetMask(AIArtHandle art, AIMaskRef* mask)
+{
+	*mask = nullptr;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping)
+{
+	*clipping = false;
+	return kNoErr;
+}
+
+bool SnapshotArtSource::CanRasterize()
+{
+	return false;
+}
+
+AIErr SnapshotArtSource::RasterizeArtToPNG(AIArtHandle art, const std::string& filePath)
+{
+	return kBadParameterErr;
+}
+
+AIErr SnapshotArtSource::GetPathSegmentCount(AIArtHandle path, short* count)
+{
+	*count = (short)ToArt(path)->segmentCount;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments)
+{
+	const SnapshotArt* record = ToArt(path);
+	if (segmentNumber < 0 || count < 0 || (uint32_t)(segmentNumber + count) > record->segmentCount)
+	{
+		return kBadParameterErr;
+	}
+
+	memcpy(segments, &this->segments[record->firstSegment + segmentNumber], count * sizeof(AIPathSegment));
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPathClosed(AIArtHandle path, AIBoolean* closed)
+{
+	*closed = (ToArt(path)->closed != 0);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPathGuide(AIArtHandle path, AIBoolean* isGuide)
+{
+	*isGuide = (ToArt(path)->guide != 0);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill)
+{
+	const SnapshotArt* record = ToArt(art);
+	if (record->style == kNone)
+	{
+		return kBadParameterErr;
+	}
+
+	const SnapshotStyle& snapshotStyle = styles[record->style];
+	*style = snapshotStyle.style;
+	ToHandle(style->fill.color, snapshotStyle.fillPaint);
+	ToHandle(style->stroke.color, snapshotStyle.strokePaint);
+	if (hasAdvancedFill)
+	{
+		*hasAdvancedFill = (record->hasAdvancedFill != 0);
+	}
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetGradientType(AIGradientHandle gradient, short* type)
+{
+	*type = (short)ToGradient(gradient)->type;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetGradientStopCount(AIGradientHandle gradient, short* count)
+{
+	*count = (short)ToGradient(gradient)->stopCount;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop)
+{
+	const SnapshotGradient* record = ToGradient(gradient);
+	if (n < 0 || (uint32_t)n >= record->stopCount)
+	{
+		return kBadParameterErr;
+	}
+
+	*stop = stops[record->firstStop + n];
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPatternArt(AIPatternHandle pattern, AIArtHandle* art)
+{
+	*art = ToHandle(ToPattern(pattern)->art);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPatternName(AIPatternHandle pattern, std::string& name)
+{
+	name = strings + ToPattern(pattern)->name;
+	return kNoErr;
+}
+
+// Custom colors are converted when they're captured
+AIErr SnapshotArtSource::GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor)
+{
+	return kBadParameterErr;
+}
+
+AIErr SnapshotArtSource::GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern)
+{
+	const SnapshotArt* record = ToArt(art);
+	if (record->type != kSymbolArt)
+	{
+		*pattern = nullptr;
+		return kBadParameterErr;
+	}
+
+	*pattern = reinterpret_cast<AIPatternHandle>(const_cast<SnapshotPattern*>(&patterns[symbols[record->detail].pattern]));
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform)
+{
+	const SnapshotArt* record = ToArt(art);
+	if (record->type != kSymbolArt)
+	{
+		return kBadParameterErr;
+	}
+
+	*transform = symbols[record->detail].transform;
+	return kNoErr;
+}
+
+// Plug-in art isn't captured
+AIErr SnapshotArtSource::GetPluginArtName(AIArtHandle art, std::string& name)
+{
+	name.clear();
+	return kBadParameterErr;
+}
+
+AIErr SnapshotArtSource::GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt)
+{
+	*resultArt = nullptr;
+	return kBadParameterErr;
+}
+
+AIErr SnapshotArtSource::GetPlacedType(AIArtHandle art, short* type)
+{
+	const SnapshotPlaced* record = ToPlaced(art);
+	if (!record || ToArt(art)->type != kPlacedArt)
+	{
+		return kBadParameterErr;
+	}
+
+	*type = (short)record->placedType;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPlacedFilePath(AIArtHandle art, std::string& filePath)
+{
+	const SnapshotPlaced* record = ToPlaced(art);
+	if (!record || ToArt(art)->type != kPlacedArt)
+	{
+		filePath.clear();
+		return kBadParameterErr;
+	}
+
+	filePath = strings + record->filePath;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix)
+{
+	const SnapshotPlaced* record = ToPlaced(art);
+	if (!record || ToArt(art)->type != kPlacedArt)
+	{
+		return kBadParameterErr;
+	}
+
+	*matrix = record->matrix;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster)
+{
+	const SnapshotPlaced* record = ToPlaced(art);
+	if (!record || ToArt(art)->type != kPlacedArt)
+	{
+		return kBadParameterErr;
+	}
+
+	*info = record->info;
+	*isRaster = (record->isRaster != 0);
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetRasterFilePath(AIArtHandle art, std::string& filePath)
+{
+	const SnapshotPlaced* record = ToPlaced(art);
+	if (!record || ToArt(art)->type != kRasterArt)
+	{
+		filePath.clear();
+		return kBadParameterErr;
+	}
+
+	filePath = strings + record->filePath;
+	return kNoErr;
+}
+
+AIErr SnapshotArtSource::GetTextFrame(AIArtHandle art, TextFrame& textFrame)
+{
+	textFrame.lines.clear();
+
+	const SnapshotArt* record = ToArt(art);
+	if (record->type != kTextFrameArt)
+	{
+		return kBadParameterErr;
+	}
+
+	const SnapshotTextFrame& snapshotTextFrame = textFrames[record->detail];
+	textFrame.matrix = snapshotTextFrame.matrix;
+	textFrame.lines.resize(snapshotTextFrame.lineCount);
+	for (uint32_t i = 0; i < snapshotTextFrame.lineCount; i++)
+	{
+		const SnapshotTextLine& line = textLines[snapshotTextFrame.firstLine + i];
+		std::vector<GlyphRun>& lineGlyphRuns = textFrame.lines[i].glyphRuns;
+		lineGlyphRuns.resize(line.runCount);
+		for (uint32_t j = 0; j < line.runCount; j++)
+		{
+			const SnapshotGlyphRun& snapshotGlyphRun = glyphRuns[line.firstRun + j];
+			GlyphRun& glyphRun = lineGlyphRuns[j];
+			glyphRun.contents = strings + snapshotGlyphRun.contents;
+			glyphRun.fontSize = snapshotGlyphRun.fontSize;
+			glyphRun.hasFont = (snapshotGlyphRun.hasFont != 0);
+			glyphRun.fontName = strings + snapshotGlyphRun.fontName;
+			glyphRun.fontStyleName = strings + snapshotGlyphRun.fontStyleName;
+			glyphRun.verticalScale = snapshotGlyphRun.verticalScale;
+			glyphRun.horizontalScale = snapshotGlyphRun.horizontalScale;
+			glyphRun.matrix = snapshotGlyphRun.matrix;
+			glyphRun.origin = snapshotGlyphRun.origin;
+			glyphRun.hasFill = (snapshotGlyphRun.hasFill != 0);
+			glyphRun.fillColor = snapshotGlyphRun.fillColor;
+			ToHandle(glyphRun.fillColor, snapshotGlyphRun.fillPaint);
+			glyphRun.hasStroke = (snapshotGlyphRun.hasStroke != 0);
+			glyphRun.strokeColor = snapshotGlyphRun.strokeColor;
+			ToHandle(glyphRun.strokeColor, snapshotGlyphRun.strokePaint);
+			glyphRun.hasLineWidth = (snapshotGlyphRun.hasLineWidth != 0);
+			glyphRun.lineWidth = snapshotGlyphRun.lineWidth;
+			glyphRun.hasLineCap = (snapshotGlyphRun.hasLineCap != 0);
+			glyphRun.lineCap = (AILineCap)snapshotGlyphRun.lineCap;
+			glyphRun.hasLineJoin = (snapshotGlyphRun.hasLineJoin != 0);
+			glyphRun.lineJoin = (AILineJoin)snapshotGlyphRun.lineJoin;
+		}
+	}
+	return kNoErr;
+}
@@ -0,0 +1,296 @@
+// SnapshotArtSource.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SNAPSHOTARTSOURCE_H
+#define SNAPSHOTARTSOURCE_H
+
+#include "IllustratorSDK.h"
+#include "ArtSource.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace CanvasExport
+{
+	/// Replays a document captured with SnapshotArtSource::Write (so exports can be repeated without Illustrator)
+	/// The file is memory-mapped and read in place: handles point directly at its fixed-size records, so they must never be passed to the SDK
+	/// Groups, compound paths, paths, symbols, text frames, and placed and raster art (by file path) are captured
+	/// Other art (and masked art, which would be rasterized) is skipped and counted, since it's read through suites a snapshot can't replay
+	/// Paints are stored by value: gradients and patterns in their own tables, and custom colors as the process colors they're defined with
+	class SnapshotArtSource : public ArtSource
+	{
+	private:
+
+		static const uint32_t	kNone = 0xFFFFFFFF;		// No art, string, style, gradient or pattern
+		static const uint32_t	kMaxDepth = 256;		// Deepest nesting of art (deeper art isn't captured, and a file with any is rejected)
+
+		struct SnapshotHeader
+		{
+			char				magic[8];					// "AI2CSNAP"
+			uint32_t			version;
+			uint32_t			size;						// Total file size (in bytes)
+			uint32_t			layerCount;
+			uint32_t			artCount;
+			uint32_t			segmentCount;
+			uint32_t			styleCount;
+			uint32_t			gradientCount;
+			uint32_t			stopCount;
+			uint32_t			patternCount;
+			uint32_t			symbolCount;
+			uint32_t			placedCount;
+			uint32_t			textFrameCount;
+			uint32_t			textLineCount;
+			uint32_t			glyphRunCount;
+			uint32_t			layersOffset;				// Offsets from the start of the file
+			uint32_t			artOffset;
+			uint32_t			segmentsOffset;
+			uint32_t			stylesOffset;
+			uint32_t			gradientsOffset;
+			uint32_t			stopsOffset;
+			uint32_t			patternsOffset;
+			uint32_t			symbolsOffset;
+			uint32_t			placedOffset;
+			uint32_t			textFramesOffset;
+			uint32_t			textLinesOffset;
+			uint32_t			glyphRunsOffset;
+			uint32_t			stringsOffset;
+			uint32_t			stringsSize;
+		};
+
+		struct SnapshotLayer
+		{
+			uint32_t			title;						// Offset into the string table (null-terminated)
+			uint32_t			visible;
+			uint32_t			firstArt;					// Art index
+			uint32_t			reserved;
+		};
+
+		struct SnapshotArt
+		{
+			AIRealRect			bounds;
+			AIReal				opacity;
+			int32_t				type;						// Art type (kGroupArt, kPathArt, ...)
+			int32_t				userAttr;					// Attribute flags (kArtHidden, kArtPartOfCompound, ...)
+			uint32_t			name;						// Offset into the string table (kNone for a default name)
+			uint32_t			firstChild;					// Art index
+			uint32_t			sibling;					// Art index
+			uint32_t			firstSegment;				// Segment index
+			uint32_t			segmentCount;
+			uint32_t			style;						// Style index
+			uint32_t			closed;
+			uint32_t			guide;
+			uint32_t			hasAdvancedFill;
+			int32_t				blendingMode;
+			uint32_t			detail;						// Symbol, placed or text frame index (for symbols, placed and raster art, and text frames)
+		};
+
+		struct SnapshotStyle
+		{
+			AIPathStyle			style;						// Gradient and pattern handles are replaced when the style is read
+			uint32_t			fillPaint;					// Gradient or pattern index (for gradient and pattern fills)
+			uint32_t			strokePaint;				// Gradient or pattern index (for gradient and pattern strokes)
+		};
+
+		struct SnapshotGradient
+		{
+			int32_t				type;						// kLinearGradient or kRadialGradient
+			uint32_t			firstStop;					// Stop index
+			uint32_t			stopCount;
+			uint32_t			reserved;
+		};
+
+		struct SnapshotPattern
+		{
+			uint32_t			name;						// Offset into the string table
+			uint32_t			art;						// Art index (the pattern's group)
+		};
+
+		struct SnapshotSymbol
+		{
+			AIRealMatrix		transform;					// Soft transform
+			uint32_t			pattern;					// Pattern index (the symbol definition)
+			uint32_t			reserved;
+		};
+
+		struct SnapshotPlaced
+		{
+			AIRasterRecord		info;						// Raster info (placed art)
+			AIRealMatrix		matrix;						// Placed matrix (placed art)
+			int32_t				placedType;					// kEPSType, ... (placed art)
+			uint32_t			isRaster;					// (placed art)
+			uint32_t			filePath;					// Offset into the string table (the linked or original file)
+			uint32_t			reserved;
+		};
+
+		struct SnapshotTextFrame
+		{
+			AIRealMatrix		matrix;
+			uint32_t			firstLine;					// Text line index
+			uint32_t			lineCount;
+		};
+
+		struct SnapshotTextLine
+		{
+			uint32_t			firstRun;					// Glyph run index
+			uint32_t			runCount;
+		};
+
+		struct SnapshotGlyphRun
+		{
+			AIRealMatrix		matrix;
+			AIRealPoint			origin;
+			AIColor				fillColor;					// Gradient and pattern handles are replaced when the run is read
+			AIColor				strokeColor;
+			AIReal				fontSize;
+			AIReal				verticalScale;
+			AIReal				horizontalScale;
+			AIReal				lineWidth;
+			uint32_t			contents;					// Offsets into the string table
+			uint32_t			fontName;
+			uint32_t			fontStyleName;
+			uint32_t			fillPaint;					// Gradient or pattern index (for gradient and pattern fills)
+			uint32_t			strokePaint;				// Gradient or pattern index (for gradient and pattern strokes)
+			uint32_t			hasFont;
+			uint32_t			hasFill;
+			uint32_t			hasStroke;
+			uint32_t			hasLineWidth;
+			uint32_t			hasLineCap;
+			uint32_t			hasLineJoin;
+			int32_t				lineCap;
+			int32_t				lineJoin;
+		};
+
+		const char*			data;						// Mapped file (or nullptr)
+		size_t				dataSize;
+		const SnapshotHeader*	header;
+		const SnapshotLayer*	layers;
+		const SnapshotArt*		art;
+		const AIPathSegment*	segments;
+		const SnapshotStyle*	styles;
+		const SnapshotGradient*	gradients;
+		const AIGradientStop*	stops;
+		const SnapshotPattern*	patterns;
+		const SnapshotSymbol*	symbols;
+		const SnapshotPlaced*	placed;
+		const SnapshotTextFrame*	textFrames;
+		const SnapshotTextLine*	textLines;
+		const SnapshotGlyphRun*	glyphRuns;
+		const char*				strings;
+
+	#ifdef WIN_ENV
+		HANDLE				file;
+		HANDLE				mapping;
+	#endif
+
+		struct SnapshotTables;
+
+		static uint32_t		CaptureChain(ArtSource& source, AIArtHandle artHandle, uint32_t depth, SnapshotTables& tables);
+		static uint32_t		CaptureArt(ArtSource& source, AIArtHandle artHandle, uint32_t depth, SnapshotTables& tables);
+		static uint32_t		CaptureStyle(ArtSource& source, const AIPathStyle& style, SnapshotTables& tables);
+		static uint32_t		CapturePaint(ArtSource& source, AIColor& color, AIBoolean& paint, SnapshotTables& tables);
+		static uint32_t		CaptureGradient(ArtSource& source, AIGradientHandle gradientHandle, SnapshotTables& tables);
+		static uint32_t		CapturePattern(ArtSource& source, AIPatternHandle patternHandle, SnapshotTables& tables);
+		static uint32_t		CaptureSymbol(ArtSource& source, AIArtHandle artHandle, SnapshotTables& tables);
+		static uint32_t		CapturePlaced(ArtSource& source, AIArtHandle artHandle, short type, SnapshotTables& tables);
+		static uint32_t		CaptureTextFrame(ArtSource& source, AIArtHandle artHandle, SnapshotTables& tables);
+		static void			CaptureGlyphRun(ArtSource& source, const GlyphRun& glyphRun, SnapshotTables& tables);
+		static bool			CaptureColor(ArtSource& source, AIColor& color);
+		static uint32_t		AddString(const std::string& string, SnapshotTables& tables);
+
+		bool				Validate();
+		bool				ValidatePaint(const AIColor& color, uint32_t paint) const;
+		bool				ValidateTree() const;
+		AIArtHandle			ToHandle(uint32_t index) const;
+		void				ToHandle(AIColor& color, uint32_t paint) const;
+		const SnapshotPlaced*	ToPlaced(AIArtHandle handle) const;
+
+		static inline const SnapshotArt*		ToArt(AIArtHandle handle)				{ return reinterpret_cast<const SnapshotArt*>(handle); }
+		static inline const SnapshotGradient*	ToGradient(AIGradientHandle handle)		{ return reinterpret_cast<const SnapshotGradient*>(handle); }
+		static inline const SnapshotPattern*	ToPattern(AIPatternHandle handle)		{ return reinterpret_cast<const SnapshotPattern*>(handle); }
+
+	public:
+
+		static const uint32_t	kVersion = 3;
+
+		SnapshotArtSource();
+		~SnapshotArtSource();
+
+		static bool			Write(ArtSource& source, const std::string& filePath, std::string& skipped);
+
+		bool				Open(const std::string& filePath);
+		void				Close();
+		void				Prefetch() const;
+		inline bool			IsOpen() const		{ return (data != nullptr); }
+
+		// ArtSource
+		AIErr				CountLayers(ai::int32* count);
+		AIErr				GetNthLayer(ai::int32 n, AILayerHandle* layer);
+		AIErr				GetLayerVisible(AILayerHandle layer, AIBoolean* visible);
+		AIErr				GetLayerTitle(AILayerHandle layer, std::string& title);
+		AIErr				GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art);
+
+		AIErr				GetArtFirstChild(AIArtHandle art, AIArtHandle* child);
+		AIErr				GetArtSibling(AIArtHandle art, AIArtHandle* sibling);
+		AIErr				GetArtType(AIArtHandle art, short* type);
+		AIErr				GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr);
+		AIErr				GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName);
+		AIErr				GetArtBounds(AIArtHandle art, AIRealRect* bounds);
+
+		AIReal				GetOpacity(AIArtHandle art);
+		AIBlendingMode		GetBlendingMode(AIArtHandle art);
+		AIErr				GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects);
+		AIErr				GetMask(AIArtHandle art, AIMaskRef* mask);
+		AIErr				GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping);
+		bool				CanRasterize();
+		AIErr				RasterizeArtToPNG(AIArtHandle art, const std::string& filePath);
+
+		AIErr				GetPathSegmentCount(AIArtHandle path, short* count);
+		AIErr				GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments);
+		AIErr				GetPathClosed(AIArtHandle path, AIBoolean* closed);
+		AIErr				GetPathGuide(AIArtHandle path, AIBoolean* isGuide);
+		AIErr				GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill);
+
+		AIErr				GetGradientType(AIGradientHandle gradient, short* type);
+		AIErr				GetGradientStopCount(AIGradientHandle gradient, short* count);
+		AIErr				GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop);
+		AIErr				GetPatternArt(AIPatternHandle pattern, AIArtHandle* art);
+		AIErr				GetPatternName(AIPatternHandle pattern, std::string& name);
+		AIErr				GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor);
+
+		AIErr				GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern);
+		AIErr				GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform);
+
+		AIErr				GetPluginArtName(AIArtHandle art, std::string& name);
+		AIErr				GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt);
+
+		AIErr				GetPlacedType(AIArtHandle art, short* type);
+		AIErr				GetPlacedFilePath(AIArtHandle art, std::string& filePath);
+		AIErr				GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix);
+		AIErr				GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster);
+		AIErr				GetRasterFilePath(AIArtHandle art, std::string& filePath);
+
+		AIErr				GetTextFrame(AIArtHandle art, TextFrame& textFrame);
+	};
+}
+
+#endif
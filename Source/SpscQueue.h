@@ -0,0 +1,108 @@
+// SpscQueue.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace CanvasExport
+{
+	/// Bounded, lock-free queue for exactly one producer thread and one consumer thread
+	/// (Push is only called by the producer; Front and Pop only by the consumer)
+	template <typename T>
+	class SpscQueue
+	{
+	private:
+
+		std::vector<T>		slots;
+		size_t				mask;						// Capacity - 1 (capacity is a power of two)
+		std::atomic<size_t>	head;						// Next slot to read (only advanced by the consumer)
+		std::atomic<size_t>	tail;						// Next slot to write (only advanced by the producer)
+
+	public:
+
+		SpscQueue(size_t capacity)
+		{
+			// Initialize SpscQueue
+			size_t size = 1;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+			this->slots.resize(size);
+			this->mask = size - 1;
+			this->head = 0;
+			this->tail = 0;
+		}
+
+		~SpscQueue()
+		{
+		}
+
+		/// Add a value (returns false if the queue is full)
+		bool Push(const T& value)
+		{
+			size_t current = tail.load(std::memory_order_relaxed);
+			if (current - head.load(std::memory_order_acquire) > mask)
+			{
+				return false;
+			}
+
+			slots[current & mask] = value;
+			tail.store(current + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// Look at the oldest value without removing it (returns false if the queue is empty)
+		bool Front(T& value) const
+		{
+			size_t current = head.load(std::memory_order_relaxed);
+			if (current == tail.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+
+			value = slots[current & mask];
+			return true;
+		}
+
+		/// Remove the oldest value (returns false if the queue is empty)
+		bool Pop(T& value)
+		{
+			if (!Front(value))
+			{
+				return false;
+			}
+
+			head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			return true;
+		}
+
+		inline bool			IsEmpty() const		{ return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire)); }
+		inline bool			IsFull() const		{ return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire) > mask); }
+	};
+}
+
+#endif
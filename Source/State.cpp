@@ -22,6 +22,7 @@
 
 #include "IllustratorSDK.h"
 #include "State.h"
+#include "RealMath.h"
 
 using namespace CanvasExport;
 
@@ -43,7 +44,7 @@ State::State()
 	this->fontName = "sans-serif";
 	this->fontStyleName = "Regular";
 	this->isProcessingSymbol = false;
-	sAIRealMath->AIRealMatrixSetIdentity(&this->internalTransform);
+	RealMatrixSetIdentity(&this->internalTransform);
 }
 
 State::~State()
@@ -54,14 +55,14 @@ State::~State()
 void State::DebugInfo()
 {
 	outFile << "\n\n// State Info";
-	outFile << "\n//   globalAlpha = " << setiosflags(ios::fixed) << setprecision(2) << this->globalAlpha;
+	outFile << "\n//   globalAlpha = " << Fixed<2>(this->globalAlpha);
 	outFile << "\n//   fillStyle = " << this->fillStyle;
 	outFile << "\n//   strokeStyle = " << this->strokeStyle;
-	outFile << "\n//   lineWidth = " << setiosflags(ios::fixed) << setprecision(1) << this->lineWidth;
+	outFile << "\n//   lineWidth = " << Fixed<1>(this->lineWidth);
 	outFile << "\n//   lineCap = " << this->lineCap;
 	outFile << "\n//   lineJoin = " << this->lineJoin;
-	outFile << "\n//   miterLimit = " << setiosflags(ios::fixed) << setprecision(1) << this->miterLimit;
-	outFile << "\n//   fontSize = " << setiosflags(ios::fixed) << setprecision(1) << this->fontSize;
+	outFile << "\n//   miterLimit = " << Fixed<1>(this->miterLimit);
+	outFile << "\n//   fontSize = " << Fixed<1>(this->fontSize);
 	outFile << "\n//   fontName = " << this->fontName;
 	outFile << "\n//   fontStyleName = " << this->fontStyleName;
 	outFile << "\n//   isProcessingSymbol = " << this->isProcessingSymbol;
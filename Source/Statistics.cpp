@@ -0,0 +1,325 @@
+// Statistics.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "Statistics.h"
+#include <algorithm>
+
+using namespace CanvasExport;
+
+Statistics::Statistics()
+{
+	// Initialize Statistics
+	Reset(false);
+}
+
+Statistics::~Statistics()
+{
+}
+
+// Clear all counters (and start or stop collecting)
+void Statistics::Reset(bool enabled)
+{
+	this->enabled = enabled;
+	this->inLayer = false;
+	this->layerBytes = 0;
+
+	for (int i = 0; i < kArtTypeCount; i++)
+	{
+		Clear(types[i]);
+	}
+	layers.clear();
+	openArt.clear();
+}
+
+void Statistics::Clear(Counters& counters)
+{
+	counters.nodes = 0;
+	counters.segments = 0;
+	counters.commands = 0;
+	counters.bytes = 0;
+	counters.rasterized = 0;
+	counters.seconds = 0.0;
+}
+
+// Layers are counted from the start of their art until their drawing commands have been written
+void Statistics::BeginLayer(const std::string& functionName, const std::string& layerName)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	LayerCounters layer;
+	layer.functionName = functionName;
+	layer.layerName = layerName;
+	Clear(layer.counters);
+	layers.push_back(layer);
+
+	inLayer = true;
+	layerStart = std::chrono::steady_clock::now();
+	layerBytes = outFile.Size();
+}
+
+void Statistics::EndLayer()
+{
+	if (!enabled || !inLayer)
+	{
+		return;
+	}
+
+	Counters& counters = layers.back().counters;
+	counters.bytes = outFile.Size() - layerBytes;
+	counters.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - layerStart).count();
+
+	inLayer = false;
+}
+
+// Art is timed (and its commands counted) without its children, so nested groups aren't counted twice
+void Statistics::BeginArt(short type, size_t commandCount)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	OpenArt art;
+	art.type = (type >= 0 && type < kArtTypeCount) ? type : (short)kUnknownArt;
+	art.start = std::chrono::steady_clock::now();
+	art.commands = commandCount;
+	art.childSeconds = 0.0;
+	art.childCommands = 0;
+	openArt.push_back(art);
+}
+
+void Statistics::EndArt(size_t commandCount)
+{
+	if (!enabled || openArt.empty())
+	{
+		return;
+	}
+
+	OpenArt art = openArt.back();
+	openArt.pop_back();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - art.start).count();
+
+	// (recorded commands are cleared when they're written, so the count can go down)
+	size_t commands = (commandCount > art.commands) ? (commandCount - art.commands) : 0;
+
+	// Let the parent exclude this art
+	if (!openArt.empty())
+	{
+		openArt.back().childSeconds += seconds;
+		openArt.back().childCommands += commands;
+	}
+
+	Counters& counters = types[art.type];
+	counters.nodes++;
+	counters.seconds += seconds - art.childSeconds;
+	counters.commands += (commands > art.childCommands) ? (commands - art.childCommands) : 0;
+
+	if (inLayer)
+	{
+		layers.back().counters.nodes++;
+		if (openArt.empty())
+		{
+			layers.back().counters.commands += commands;
+		}
+	}
+}
+
+void Statistics::AddSegments(size_t count)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	if (!openArt.empty())
+	{
+		types[openArt.back().type].segments += count;
+	}
+	if (inLayer)
+	{
+		layers.back().counters.segments += count;
+	}
+}
+
+void Statistics::AddRasterized()
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	if (!openArt.empty())
+	{
+		types[openArt.back().type].rasterized++;
+	}
+	if (inLayer)
+	{
+		layers.back().counters.rasterized++;
+	}
+}
+
+// Orders layers by output size (largest first)
+static bool CompareLayerBytes(const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b)
+{
+	return (a.first > b.first);
+}
+
+// Write the statistics as JSON (layers are listed largest first)
+bool Statistics::Write(const std::string& filePath)
+{
+	ofstream file;
+	file.open(filePath.c_str(), ios::out | ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << "{\n  \"artTypes\": [";
+	bool isFirst = true;
+	for (int i = 0; i < kArtTypeCount; i++)
+	{
+		if (types[i].nodes > 0)
+		{
+			file << (isFirst ? "\n" : ",\n") << "    { \"type\": \"" << ArtTypeName((short)i) << "\", ";
+			WriteCounters(file, types[i]);
+			file << " }";
+			isFirst = false;
+		}
+	}
+
+	std::vector<std::pair<size_t, size_t> > order;
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		order.push_back(std::make_pair(layers[i].counters.bytes, i));
+	}
+	std::stable_sort(order.begin(), order.end(), CompareLayerBytes);
+
+	file << "\n  ],\n  \"layers\": [";
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		const LayerCounters& layer = layers[order[i].second];
+		file << (i > 0 ? ",\n" : "\n") << "    { \"function\": \"" << EscapeJSON(layer.functionName) <<
+			"\", \"layer\": \"" << EscapeJSON(layer.layerName) << "\", ";
+		WriteCounters(file, layer.counters);
+		file << " }";
+	}
+	file << "\n  ]\n}\n";
+	file.close();
+
+	return !file.fail();
+}
+
+void Statistics::WriteCounters(ofstream& file, const Counters& counters)
+{
+	file << "\"nodes\": " << counters.nodes <<
+		", \"segments\": " << counters.segments <<
+		", \"commands\": " << counters.commands <<
+		", \"bytes\": " << counters.bytes <<
+		", \"rasterized\": " << counters.rasterized <<
+		", \"milliseconds\": " << setiosflags(ios::fixed) << setprecision(3) << (counters.seconds * 1000.0);
+}
+
+// Summarize in the debug HTML (layers are listed largest first)
+void Statistics::DebugInfo()
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	Counters totals;
+	Clear(totals);
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		totals.nodes += layers[i].counters.nodes;
+		totals.segments += layers[i].counters.segments;
+		totals.commands += layers[i].counters.commands;
+		totals.bytes += layers[i].counters.bytes;
+		totals.rasterized += layers[i].counters.rasterized;
+		totals.seconds += layers[i].counters.seconds;
+	}
+
+	outFile <<   "\n<p>Art types:</p>";
+	outFile <<   "\n<ul>";
+	for (int i = 0; i < kArtTypeCount; i++)
+	{
+		if (types[i].nodes > 0)
+		{
+			DebugCounters(ArtTypeName((short)i), types[i], totals);
+		}
+	}
+	outFile <<   "\n</ul>";
+
+	std::vector<std::pair<size_t, size_t> > order;
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		order.push_back(std::make_pair(layers[i].counters.bytes, i));
+	}
+	std::stable_sort(order.begin(), order.end(), CompareLayerBytes);
+
+	outFile <<   "\n<p>Layers (largest output first): " << layers.size() << "</p>";
+	if (!layers.empty())
+	{
+		outFile <<   "\n<ul>";
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			const LayerCounters& layer = layers[order[i].second];
+			DebugCounters(layer.functionName + " / " + layer.layerName, layer.counters, totals);
+		}
+		outFile <<   "\n</ul>";
+	}
+}
+
+void Statistics::DebugCounters(const std::string& name, const Counters& counters, const Counters& totals)
+{
+	outFile <<   "\n  <li>" << name << ": nodes: " << counters.nodes <<
+				 ", segments: " << counters.segments <<
+				 ", commands: " << counters.commands;
+
+	if (counters.bytes > 0)
+	{
+		outFile << ", bytes: " << counters.bytes;
+		if (totals.bytes > 0)
+		{
+			outFile << " (" << Fixed<1>(100.0 * counters.bytes / totals.bytes) << "%)";
+		}
+	}
+
+	outFile << ", time: " << Fixed<2>(counters.seconds * 1000.0) << " ms";
+	if (totals.seconds > 0.0)
+	{
+		outFile << " (" << Fixed<1>(100.0 * counters.seconds / totals.seconds) << "%)";
+	}
+
+	if (counters.rasterized > 0)
+	{
+		outFile << ", rasterized: " << counters.rasterized;
+	}
+
+	outFile << "</li>";
+}
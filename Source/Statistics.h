@@ -0,0 +1,100 @@
+// Statistics.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <chrono>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Counts what each art type and each layer contributes to an export (nodes, segments, output, time and rasterized art)
+	class Statistics
+	{
+	private:
+
+		struct Counters
+		{
+			size_t				nodes;					// Art objects rendered
+			size_t				segments;				// Path segments emitted
+			size_t				commands;				// Drawing commands recorded
+			size_t				bytes;					// Output written (layers only)
+			size_t				rasterized;				// Art rasterized to PNG, rather than drawn
+			double				seconds;				// Time spent (art types exclude their children)
+		};
+
+		struct LayerCounters
+		{
+			std::string			functionName;
+			std::string			layerName;
+			Counters			counters;
+		};
+
+		struct OpenArt
+		{
+			short				type;
+			std::chrono::steady_clock::time_point	start;
+			size_t				commands;				// Recorded commands when the art began
+			double				childSeconds;			// Time spent in children
+			size_t				childCommands;			// Commands recorded by children
+		};
+
+		bool				enabled;
+		Counters			types[kArtTypeCount];		// Indexed by art type
+		std::vector<LayerCounters>	layers;
+		bool				inLayer;					// Is a layer being rendered?
+		std::chrono::steady_clock::time_point	layerStart;
+		size_t				layerBytes;					// Output size when the layer began
+		std::vector<OpenArt>	openArt;				// Art being rendered (innermost last)
+
+		void				Clear(Counters& counters);
+		void				WriteCounters(ofstream& file, const Counters& counters);
+		void				DebugCounters(const std::string& name, const Counters& counters, const Counters& totals);
+
+	public:
+
+		Statistics();
+		~Statistics();
+
+		inline bool			IsEnabled() const	{ return enabled; }
+
+		void				Reset(bool enabled);
+		void				BeginLayer(const std::string& functionName, const std::string& layerName);
+		void				EndLayer();
+		void				BeginArt(short type, size_t commandCount);
+		void				EndArt(size_t commandCount);
+		void				AddSegments(size_t count);
+		void				AddRasterized();
+		bool				Write(const std::string& filePath);
+		void				DebugInfo();
+	};
+}
+
+#endif
@@ -0,0 +1,259 @@
+// StyleCollection.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "IllustratorSDK.h"
+#include "StyleCollection.h"
+#include <functional>
+
+using namespace CanvasExport;
+
+StyleCollection::StyleCollection()
+{
+}
+
+StyleCollection::~StyleCollection()
+{
+}
+
+// Add a style (returns the index of an identical style, if there is one)
+uint32_t StyleCollection::Add(const AIPathStyle& style)
+{
+	size_t hash = Hash(style);
+
+	// Have we already seen this style?
+	std::pair<std::unordered_multimap<size_t, uint32_t>::const_iterator, std::unordered_multimap<size_t, uint32_t>::const_iterator> range = lookup.equal_range(hash);
+	for (std::unordered_multimap<size_t, uint32_t>::const_iterator it = range.first; it != range.second; ++it)
+	{
+		if (Equal(styles[it->second], style))
+		{
+			return it->second;
+		}
+	}
+
+	uint32_t index = (uint32_t)styles.size();
+	styles.push_back(style);
+	fillStyles.push_back(std::string());
+	strokeStyles.push_back(std::string());
+	hasStrings.push_back(false);
+	lookup.insert(std::make_pair(hash, index));
+
+	return index;
+}
+
+void StyleCollection::SetStrings(uint32_t index, const std::string& fillStyle, const std::string& strokeStyle)
+{
+	fillStyles[index] = fillStyle;
+	strokeStyles[index] = strokeStyle;
+	hasStrings[index] = true;
+}
+
+// Combine a value with a hash (as in boost::hash_combine)
+template <typename T>
+static inline void HashCombine(size_t& hash, const T& value)
+{
+	hash ^= std::hash<T>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+// Hash the fields that affect output (the fields compared by Equal, or a subset of them)
+size_t StyleCollection::Hash(const AIPathStyle& style)
+{
+	size_t hash = 0;
+	HashCombine(hash, (int)style.fillPaint);
+	HashCombine(hash, (int)style.strokePaint);
+	HashCombine(hash, (int)style.clip);
+	HashCombine(hash, (int)style.evenodd);
+	if (style.fillPaint)
+	{
+		HashCombine(hash, HashColor(style.fill.color));
+	}
+	if (style.strokePaint)
+	{
+		HashCombine(hash, HashColor(style.stroke.color));
+		HashCombine(hash, (double)style.stroke.width);
+	}
+	return hash;
+}
+
+size_t StyleCollection::HashColor(const AIColor& color)
+{
+	size_t hash = 0;
+	HashCombine(hash, (int)color.kind);
+	switch (color.kind)
+	{
+		case kGrayColor:
+		{
+			HashCombine(hash, (double)color.c.g.gray);
+			break;
+		}
+		case kFourColor:
+		{
+			HashCombine(hash, (double)color.c.f.cyan);
+			HashCombine(hash, (double)color.c.f.magenta);
+			HashCombine(hash, (double)color.c.f.yellow);
+			HashCombine(hash, (double)color.c.f.black);
+			break;
+		}
+		case kThreeColor:
+		{
+			HashCombine(hash, (double)color.c.rgb.red);
+			HashCombine(hash, (double)color.c.rgb.green);
+			HashCombine(hash, (double)color.c.rgb.blue);
+			break;
+		}
+		case kCustomColor:
+		{
+			HashCombine(hash, (const void*)color.c.c.color);
+			HashCombine(hash, (double)color.c.c.tint);
+			break;
+		}
+		case kPattern:
+		{
+			HashCombine(hash, (const void*)color.c.p.pattern);
+			break;
+		}
+		case kGradient:
+		{
+			HashCombine(hash, (const void*)color.c.b.gradient);
+			break;
+		}
+		case kNoneColor:
+		case kAdvanceColor:
+		{
+			break;
+		}
+	}
+	return hash;
+}
+
+// Compare the fields that affect output (overprint, lockClip and resolution are never written)
+bool StyleCollection::Equal(const AIPathStyle& style1, const AIPathStyle& style2)
+{
+	if (style1.fillPaint != style2.fillPaint ||
+		style1.strokePaint != style2.strokePaint ||
+		style1.clip != style2.clip ||
+		style1.evenodd != style2.evenodd)
+	{
+		return false;
+	}
+
+	if (style1.fillPaint && !EqualColor(style1.fill.color, style2.fill.color))
+	{
+		return false;
+	}
+
+	if (style1.strokePaint)
+	{
+		const AIStrokeStyle& stroke1 = style1.stroke;
+		const AIStrokeStyle& stroke2 = style2.stroke;
+		if (!EqualColor(stroke1.color, stroke2.color) ||
+			stroke1.width != stroke2.width ||
+			(stroke1.dash.length != 0) != (stroke2.dash.length != 0) ||
+			stroke1.cap != stroke2.cap ||
+			stroke1.join != stroke2.join ||
+			stroke1.miterLimit != stroke2.miterLimit)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool StyleCollection::EqualColor(const AIColor& color1, const AIColor& color2)
+{
+	if (color1.kind != color2.kind)
+	{
+		return false;
+	}
+
+	switch (color1.kind)
+	{
+		case kGrayColor:
+		{
+			return (color1.c.g.gray == color2.c.g.gray);
+		}
+		case kFourColor:
+		{
+			return (color1.c.f.cyan == color2.c.f.cyan &&
+					color1.c.f.magenta == color2.c.f.magenta &&
+					color1.c.f.yellow == color2.c.f.yellow &&
+					color1.c.f.black == color2.c.f.black);
+		}
+		case kThreeColor:
+		{
+			return (color1.c.rgb.red == color2.c.rgb.red &&
+					color1.c.rgb.green == color2.c.rgb.green &&
+					color1.c.rgb.blue == color2.c.rgb.blue);
+		}
+		case kCustomColor:
+		{
+			return (color1.c.c.color == color2.c.c.color &&
+					color1.c.c.tint == color2.c.c.tint);
+		}
+		case kPattern:
+		{
+			const AIPatternStyle& pattern1 = color1.c.p;
+			const AIPatternStyle& pattern2 = color2.c.p;
+			return (pattern1.pattern == pattern2.pattern &&
+					pattern1.shiftDist == pattern2.shiftDist &&
+					pattern1.shiftAngle == pattern2.shiftAngle &&
+					pattern1.scale.h == pattern2.scale.h &&
+					pattern1.scale.v == pattern2.scale.v &&
+					pattern1.rotate == pattern2.rotate &&
+					pattern1.reflect == pattern2.reflect &&
+					pattern1.reflectAngle == pattern2.reflectAngle &&
+					pattern1.shearAngle == pattern2.shearAngle &&
+					pattern1.shearAxis == pattern2.shearAxis &&
+					EqualMatrix(pattern1.transform, pattern2.transform));
+		}
+		case kGradient:
+		{
+			const AIGradientStyle& gradient1 = color1.c.b;
+			const AIGradientStyle& gradient2 = color2.c.b;
+			return (gradient1.gradient == gradient2.gradient &&
+					gradient1.gradientOrigin.h == gradient2.gradientOrigin.h &&
+					gradient1.gradientOrigin.v == gradient2.gradientOrigin.v &&
+					gradient1.gradientAngle == gradient2.gradientAngle &&
+					gradient1.gradientLength == gradient2.gradientLength &&
+					gradient1.hiliteAngle == gradient2.hiliteAngle &&
+					gradient1.hiliteLength == gradient2.hiliteLength &&
+					EqualMatrix(gradient1.matrix, gradient2.matrix));
+		}
+		case kNoneColor:
+		case kAdvanceColor:
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool StyleCollection::EqualMatrix(const AIRealMatrix& matrix1, const AIRealMatrix& matrix2)
+{
+	return (matrix1.a == matrix2.a &&
+			matrix1.b == matrix2.b &&
+			matrix1.c == matrix2.c &&
+			matrix1.d == matrix2.d &&
+			matrix1.tx == matrix2.tx &&
+			matrix1.ty == matrix2.ty);
+}
@@ -0,0 +1,71 @@
+// StyleCollection.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef STYLECOLLECTION_H
+#define STYLECOLLECTION_H
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace CanvasExport
+{
+	// Globals
+	extern OutputStream outFile;
+	extern bool debug;
+
+	/// Represents the distinct path styles in a document (each is stored once, with its fill and stroke style strings)
+	class StyleCollection
+	{
+	private:
+
+		std::unordered_multimap<size_t, uint32_t>	lookup;		// Style hash to index
+		std::vector<AIPathStyle>	styles;
+		std::vector<std::string>	fillStyles;			// Fill style strings (built the first time a style is drawn)
+		std::vector<std::string>	strokeStyles;		// Stroke style strings
+		std::vector<bool>			hasStrings;			// Have the strings been built?
+
+		static size_t		Hash(const AIPathStyle& style);
+		static size_t		HashColor(const AIColor& color);
+		static bool			Equal(const AIPathStyle& style1, const AIPathStyle& style2);
+		static bool			EqualColor(const AIColor& color1, const AIColor& color2);
+		static bool			EqualMatrix(const AIRealMatrix& matrix1, const AIRealMatrix& matrix2);
+
+	public:
+
+		StyleCollection();
+		~StyleCollection();
+
+		uint32_t			Add(const AIPathStyle& style);
+		void				SetStrings(uint32_t index, const std::string& fillStyle, const std::string& strokeStyle);
+
+		inline size_t		Count() const							{ return styles.size(); }
+		inline const AIPathStyle&	Style(uint32_t index) const		{ return styles[index]; }
+		inline bool			HasStrings(uint32_t index) const		{ return hasStrings[index]; }
+		inline const std::string&	FillStyle(uint32_t index) const	{ return fillStyles[index]; }
+		inline const std::string&	StrokeStyle(uint32_t index) const	{ return strokeStyles[index]; }
+	};
+}
+
+#endif
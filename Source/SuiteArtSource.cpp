@@ -0,0 +1,675 @@
+// SuiteArtSource.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "SuiteArtSource.h"
+#include "Trace.h"
+
+using namespace CanvasExport;
+
+// Rasterizing can't be cancelled
+static AIBoolean ProgressProc(ai::int32 current, ai::int32 total)
+{
+	(void)current;
+	(void)total;
+	return true;
+}
+
+SuiteArtSource::SuiteArtSource()
+{
+}
+
+SuiteArtSource::~SuiteArtSource()
+{
+}
+
+AIErr SuiteArtSource::CountLayers(ai::int32* count)
+{
+	return sAILayer->CountLayers(count);
+}
+
+AIErr SuiteArtSource::GetNthLayer(ai::int32 n, AILayerHandle* layer)
+{
+	return sAILayer->GetNthLayer(n, layer);
+}
+
+AIErr SuiteArtSource::GetLayerVisible(AILayerHandle layer, AIBoolean* visible)
+{
+	return sAILayer->GetLayerVisible(layer, visible);
+}
+
+AIErr SuiteArtSource::GetLayerTitle(AILayerHandle layer, std::string& title)
+{
+	ai::UnicodeString layerTitle;
+	AIErr error = sAILayer->GetLayerTitle(layer, layerTitle);
+	title = layerTitle.as_Platform();
+	return error;
+}
+
+AIErr SuiteArtSource::GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art)
+{
+	return sAIArt->GetFirstArtOfLayer(layer, art);
+}
+
+AIErr SuiteArtSource::GetArtFirstChild(AIArtHandle art, AIArtHandle* child)
+{
+	return sAIArt->GetArtFirstChild(art, child);
+}
+
+AIErr SuiteArtSource::GetArtSibling(AIArtHandle art, AIArtHandle* sibling)
+{
+	return sAIArt->GetArtSibling(art, sibling);
+}
+
+AIErr SuiteArtSource::GetArtType(AIArtHandle art, short* type)
+{
+	return sAIArt->GetArtType(art, type);
+}
+
+AIErr SuiteArtSource::GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr)
+{
+	return sAIArt->GetArtUserAttr(art, whichAttr, attr);
+}
+
+AIErr SuiteArtSource::GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName)
+{
+	ai::UnicodeString artName;
+	AIErr error = sAIArt->GetArtName(art, artName, isDefaultName);
+	name = artName.as_Platform();
+	return error;
+}
+
+AIErr SuiteArtSource::GetArtBounds(AIArtHandle art, AIRealRect* bounds)
+{
+	return sAIArt->GetArtBounds(art, bounds);
+}
+
+AIReal SuiteArtSource::GetOpacity(AIArtHandle art)
+{
+	return sAIBlendStyle->GetOpacity(art);
+}
+
+AIBlendingMode SuiteArtSource::GetBlendingMode(AIArtHandle art)
+{
+	return sAIBlendStyle->GetBlendingMode(art);
+}
+
+// Read the Live Effects attached to the art's style
+AIErr SuiteArtSource::GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects)
+{
+	liveEffects.clear();
+
+	// Get the style for this art handle
+	AIArtStyleHandle artStyle = nullptr;
+	AIErr error = sAIArtStyle->GetArtStyle(art, &artStyle);
+	if (error != kNoErr || artStyle == nullptr)
+	{
+		return error;
+	}
+
+	// Create a new style parser 
+	AIStyleParser parser(nullptr);
+    sAIArtStyleParser->NewParser(&parser);
+    
+	// Parse the art style
+    sAIArtStyleParser->ParseStyle(parser, artStyle);
+
+	// How many post-effects are attached to this art style?
+	ASInt32 postEffectCount = sAIArtStyleParser->CountPostEffects(parser);
+
+	// Loop through all post-effect art styles
+    for (ASInt32 postIndex = 0; (postIndex < postEffectCount); ++postIndex)
+    {
+		// Parse the Live Effects
+        AIParserLiveEffect parserLiveEffect;
+        sAIArtStyleParser->GetNthPostEffect(parser, postIndex, &parserLiveEffect);
+
+		// Get the Live Effect handle
+		AILiveEffectHandle liveEffectHandle;
+		sAIArtStyleParser->GetLiveEffectHandle(parserLiveEffect, &liveEffectHandle);
+		
+		// Get the name of the effect (function appears to allocate its own memory???)
+		const char *liveEffectName = nullptr;
+		// TODO: Do we need to release this memory somewhere? Or does the fact that we retrieved the handle via the AIArtStyleParser do the trick
+		//       (since we clean-up the parser later)?
+		sAILiveEffect->GetLiveEffectName(liveEffectHandle, &liveEffectName);
+
+		LiveEffect liveEffect;
+		liveEffect.name = (liveEffectName ? liveEffectName : "");
+
+        // Check to see if the name is "Adobe Drop Shadow"
+		liveEffect.isDropShadow = (liveEffect.name == "Adobe Drop Shadow");
+		if (liveEffect.isDropShadow)
+		{
+			GetDropShadow(parserLiveEffect, liveEffect.dropShadow);
+		}
+
+		liveEffects.push_back(liveEffect);
+    }
+
+	// Dispose the art style parser
+	sAIArtStyleParser->DisposeParser(parser);
+
+	return kNoErr;
+}
+
+// Read drop shadow parameters from a Live Effect
+void SuiteArtSource::GetDropShadow(AIParserLiveEffect liveEffect, DropShadow& dropShadow)
+{
+	// Set default drop shadow values
+	dropShadow.horz = 0.0f;
+	dropShadow.vert = 0.0f;
+	dropShadow.blur = 0.0f;
+	dropShadow.opac = 1.0f;
+
+	// Obtain the parameters dictionary
+	AILiveEffectParameters params;
+	sAIArtStyleParser->GetLiveEffectParams(liveEffect, &params);
+
+	// Do we have any parameters?
+	if (params)
+	{
+		// Create an iterator for the parameters dictionary items
+		AIDictionaryIterator dictionaryIter = nullptr;
+		sAIDictionary->Begin(params, &dictionaryIter);
+
+		// Iterate through the parameter dictionary entries
+		while ( !sAIDictionaryIterator->AtEnd(dictionaryIter) )
+		{
+			// Get the dictionary key
+			AIDictKey dictKey = sAIDictionaryIterator->GetKey(dictionaryIter);
+
+			// Get the key string
+			const char *keyString = nullptr;
+			keyString = sAIDictionary->GetKeyString(dictKey);
+
+			// Clean-up key string
+			char betterKeyString[256];
+			#ifdef MAC_ENV
+			strcpy(betterKeyString, keyString);
+			#endif
+			#ifdef WIN_ENV
+			strcpy_s(betterKeyString, keyString);
+			#endif
+			if (betterKeyString[0] == '-')
+				betterKeyString[0] = ' ';
+
+			// For matching keys, retrieve parameter values
+			if (strcmp(betterKeyString, "horz") == 0)
+			{
+				// Get horizontal shadow offset
+				sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.horz);
+			}
+			else if (strcmp(betterKeyString, "vert") == 0)
+			{
+				// Get vertical shadow offset
+				sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.vert);
+			}
+			else if (strcmp(betterKeyString, "blur") == 0)
+			{
+				// Get vertical shadow offset
+				sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.blur);
+			}
+			else if (strcmp(betterKeyString, "opac") == 0)
+			{
+				// Get shadow opacity
+				sAIDictionary->GetRealEntry(params, dictKey, &dropShadow.opac);
+			}
+			else if (strcmp(betterKeyString, "sclr") == 0)
+			{
+				// Get shadow color
+				// TODO: Check to see if we have to do any reference counting for reading this key (and other keys)
+				AIEntryRef entryRef = sAIDictionary->Get(params, dictKey);
+				sAIEntry->ToFillStyle(entryRef, &dropShadow.shadowStyle);
+			}
+
+			// Move to the next dictionary entry
+			sAIDictionaryIterator->Next(dictionaryIter);
+		}
+		// Release the dictionary iterator
+		sAIDictionaryIterator->Release(dictionaryIter);
+	}
+}
+
+AIErr SuiteArtSource::GetMask(AIArtHandle art, AIMaskRef* mask)
+{
+	return sAIMask->GetMask(art, mask);
+}
+
+AIErr SuiteArtSource::GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping)
+{
+	return sAIPluginGroup->GetPluginArtClipping(art, clipping);
+}
+
+bool SuiteArtSource::CanRasterize()
+{
+	return true;
+}
+
+// Given an art handle, rasterizes to a file at the given path
+// NOTE: While width and height are passed, the resulting file is often of a different size, which negatively affects positioning
+// See discussion thread: http://forums.adobe.com/thread/603776?tstart=0
+AIErr SuiteArtSource::RasterizeArtToPNG(AIArtHandle art, const std::string& filePath)
+{
+	TraceScope traceScope("SuiteArtSource::RasterizeArtToPNG", filePath);
+
+	ai::FilePath path;
+	path.Set(ai::UnicodeString(filePath));
+
+    AIRealRect bounds;
+    GetArtBounds(art, &bounds);
+    AIReal artWidth = bounds.right - bounds.left;
+    AIReal artHeight = bounds.top - bounds.bottom;
+
+	AIErr result = kNoErr;
+	AIDataFilter *dstFilter = nullptr;
+	AIDataFilter *filter = nullptr;
+	if (!result)
+			result = sAIDataFilter->NewFileDataFilter(path, "write", 'prw', 'PNGf', &filter);
+	if (!result) {
+			result = sAIDataFilter->LinkDataFilter(dstFilter, filter);
+			dstFilter = filter;
+	}
+
+	// Set PNG parameters
+	AIImageOptPNGParams2 params;
+    params.versionOneSuiteParams.interlaced = false;
+    params.versionOneSuiteParams.numberOfColors = 16777216;
+    params.versionOneSuiteParams.transparentIndex = 0;
+    params.versionOneSuiteParams.resolution = 72.0f;
+    params.versionOneSuiteParams.outAlpha = true;
+    params.versionOneSuiteParams.outWidth = (ASInt32)artWidth;
+    params.versionOneSuiteParams.outHeight = (ASInt32)artHeight;
+
+    //We assume that the basic resolution of illustrator is 72 dpi
+    AIReal resolutionRatio =  1.0f;
+    AIReal minDim = min(artWidth,artHeight) * resolutionRatio;
+    AIReal maxDim = max(artWidth,artHeight) * resolutionRatio;
+    AIReal ratio = 1;
+
+    if (minDim < 1)
+    {
+            ratio = 1 / minDim;
+            minDim *= ratio;
+            maxDim *= ratio;
+    }
+
+    if (maxDim > 65535)
+    {
+            ratio *= 65535 / maxDim;
+    }
+
+    //Here we tune the resolution parameter to comply to minRasterizationDimension and
+    //maxRasterizationDimension constraints
+    //We assume that the basic resolution of illustrator is 72 dpi
+    params.versionOneSuiteParams.resolution *= (AIFloat)ratio;
+
+    params.antialias = true;
+    /* A cropping box for the art. If empty or degenerate, do not crop. */
+	AIRealRect crop;
+	crop.left = 0.0f;
+	crop.top = 0.0f;
+	crop.right = 0.0f;
+	crop.bottom = 0.0f;
+    params.cropBox = crop;
+    params.backgroundIsTransparent = true;
+    /* When backgroundIsTransparent is false, rasterize against this matte color. */
+    /*params.matteColor.red = 1.0f;
+    params.matteColor.green = 1.0f;
+    params.matteColor.blue = 1.0f; */
+
+	// Make PNG
+    if (!result)
+		result = sAIImageOpt->MakePNG24 (art, dstFilter, params, ProgressProc);
+
+    if (dstFilter)
+	{
+		AIErr tmpresult = sAIDataFilter->UnlinkDataFilter(dstFilter, &dstFilter);
+		if (!result)
+				result = tmpresult;
+	}
+
+	return result;
+}
+
+AIErr SuiteArtSource::GetPathSegmentCount(AIArtHandle path, short* count)
+{
+	return sAIPath->GetPathSegmentCount(path, count);
+}
+
+AIErr SuiteArtSource::GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments)
+{
+	return sAIPath->GetPathSegments(path, segmentNumber, count, segments);
+}
+
+AIErr SuiteArtSource::GetPathClosed(AIArtHandle path, AIBoolean* closed)
+{
+	return sAIPath->GetPathClosed(path, closed);
+}
+
+AIErr SuiteArtSource::GetPathGuide(AIArtHandle path, AIBoolean* isGuide)
+{
+	return sAIPath->GetPathGuide(path, isGuide);
+}
+
+AIErr SuiteArtSource::GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill)
+{
+	return sAIPathStyle->GetPathStyle(art, style, hasAdvancedFill);
+}
+
+AIErr SuiteArtSource::GetGradientType(AIGradientHandle gradient, short* type)
+{
+	return sAIGradient->GetGradientType(gradient, type);
+}
+
+AIErr SuiteArtSource::GetGradientStopCount(AIGradientHandle gradient, short* count)
+{
+	return sAIGradient->GetGradientStopCount(gradient, count);
+}
+
+AIErr SuiteArtSource::GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop)
+{
+	return sAIGradient->GetNthGradientStop(gradient, n, stop);
+}
+
+AIErr SuiteArtSource::GetPatternArt(AIPatternHandle pattern, AIArtHandle* art)
+{
+	return sAIPattern->GetPatternArt(pattern, art);
+}
+
+AIErr SuiteArtSource::GetPatternName(AIPatternHandle pattern, std::string& name)
+{
+	ai::UnicodeString patternName;
+	AIErr error = sAIPattern->GetPatternName(pattern, patternName);
+	name = patternName.as_Platform();
+	return error;
+}
+
+AIErr SuiteArtSource::GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor)
+{
+	return sAICustomColor->GetCustomColor(customColorHandle, customColor);
+}
+
+AIErr SuiteArtSource::GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern)
+{
+	return sAISymbol->GetSymbolPatternOfSymbolArt(art, pattern);
+}
+
+AIErr SuiteArtSource::GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform)
+{
+	return sAISymbol->GetSoftTransformOfSymbolArt(art, transform);
+}
+
+AIErr SuiteArtSource::GetPluginArtName(AIArtHandle art, std::string& name)
+{
+	// TODO: Do we really need to allocate memory here? Or does the call do it for us?
+	char **pluginArtName = (char **)calloc(1024, sizeof(char));
+	AIErr error = sAIPluginGroup->GetPluginArtName(art, pluginArtName);
+	name = (*pluginArtName ? std::string(*pluginArtName) : "");
+
+	// Release memory
+	free(pluginArtName);
+	pluginArtName = nullptr;
+
+	return error;
+}
+
+AIErr SuiteArtSource::GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt)
+{
+	return sAIPluginGroup->GetPluginArtResultArt(art, resultArt);
+}
+
+AIErr SuiteArtSource::GetPlacedType(AIArtHandle art, short* type)
+{
+	return sAIPlaced->GetPlacedType(art, type);
+}
+
+AIErr SuiteArtSource::GetPlacedFilePath(AIArtHandle art, std::string& filePath)
+{
+	ai::UnicodeString path;
+	AIErr error = sAIPlaced->GetPlacedFilePathFromArt(art, path);
+	filePath = path.as_Platform();
+	return error;
+}
+
+AIErr SuiteArtSource::GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix)
+{
+	return sAIPlaced->GetPlacedMatrix(art, matrix);
+}
+
+AIErr SuiteArtSource::GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster)
+{
+	return sAIPlaced->GetRasterInfo(art, info, isRaster);
+}
+
+AIErr SuiteArtSource::GetRasterFilePath(AIArtHandle art, std::string& filePath)
+{
+	ai::UnicodeString path;
+	AIErr error = sAIRaster->GetRasterFilePathFromArt(art, path);
+	filePath = path.as_Platform();
+	return error;
+}
+
+// Read the lines and glyph runs of a text frame (through the text engine)
+AIErr SuiteArtSource::GetTextFrame(AIArtHandle art, TextFrame& textFrame)
+{
+	textFrame.lines.clear();
+
+	// Create ITextFrame object.
+	TextFrameRef textFrameRef = nullptr;
+	AIErr error = sAITextFrame->GetATETextFrame(art, &textFrameRef);
+	if (error != kNoErr)
+	{
+		return error;
+	}
+	ATE::ITextFrame frame(textFrameRef);
+
+	// Get the text frame matrix
+	textFrame.matrix = frame.GetMatrix();
+
+	// Get the text lines
+	ATE::ITextLinesIterator lines = frame.GetTextLinesIterator();
+	while (lines.IsNotDone())
+	{
+		ATE::ITextLine line = lines.Item();
+		ATE::IGlyphRunsIterator glyphRuns = line.GetGlyphRunsIterator();
+
+		TextLine textLine;
+
+		// Loop through all glyph runs
+		while (glyphRuns.IsNotDone())
+		{
+			// Get next glyph run
+			ATE::IGlyphRun glyphRun = glyphRuns.Item();
+
+			// Any contents?
+			if (glyphRun.GetCharacterCount() > 0)
+			{
+				GlyphRun run;
+				GetGlyphRun(glyphRun, run);
+				textLine.glyphRuns.push_back(run);
+			}
+
+			// Get the next glyph run
+			glyphRuns.Next();
+		}
+
+		textFrame.lines.push_back(textLine);
+
+		// Get the next line
+		lines.Next();
+	}
+
+	return kNoErr;
+}
+
+// Read the contents and character features of a glyph run
+void SuiteArtSource::GetGlyphRun(const ATE::IGlyphRun& glyphRun, GlyphRun& run)
+{
+	// Get text contents of glyph run
+	ASInt32 count = glyphRun.GetCharacterCount();
+	std::vector<char> contents(count + 1, '\0');
+	glyphRun.GetContents(&contents[0], count);
+	run.contents = std::string(&contents[0]);
+
+	// Get character features
+	ATE::ICharFeatures features = glyphRun.GetCharFeatures();
+
+	// To test for local feature assignments
+	bool isAssigned = false;
+
+	// Get font size
+	// TODO: Is there ever a case when the font size *isn't* assigned? What's the default in that situation?
+	run.fontSize = features.GetFontSize(&isAssigned);
+
+	// Get font info
+	ATE::IFont font = features.GetFont(&isAssigned);
+	run.hasFont = isAssigned;
+	if (isAssigned)
+	{
+		// Allocate memory for font names and styles
+		char systemFontName[1024] = "";
+		char fontStyleName[1024] = "";
+
+		// Local font is assigned
+		FontRef fontRef = font.GetRef();
+		AIFontKey fontKey = nullptr;
+		sAIFont->FontKeyFromFont(fontRef, &fontKey);
+
+		// Get system font name
+		// TODO: Note that this may be Windows-specific...need to figure out the Apple equivalent
+		sAIFont->GetSystemFontName(fontKey, systemFontName, sizeof(systemFontName));
+
+		// Determine font variant
+		sAIFont->GetFontStyleName(fontKey, fontStyleName, sizeof(fontStyleName));
+
+		run.fontName = std::string(systemFontName);
+		run.fontStyleName = std::string(fontStyleName);
+	}
+
+	// Is there a vertical scale?
+	run.verticalScale = features.GetVerticalScale(&isAssigned);
+	if (!isAssigned)
+	{
+		// No vertical scaling
+		run.verticalScale = 1.0f;
+	}
+
+	// Is there a horizontal scale?
+	run.horizontalScale = features.GetHorizontalScale(&isAssigned);
+	if (!isAssigned)
+	{
+		// No horizontal scaling
+		run.horizontalScale = 1.0f;
+	}
+
+	// Get the matrix for this glyph run
+	run.matrix = glyphRun.GetMatrix();
+
+	// Get first origin offset for this glyph (canvas doesn't support advanced character spacing, so only the first origin is used)
+	ATE::IArrayRealPoint glyphOrigins = glyphRun.GetOrigins();
+	run.origin = glyphOrigins.Item(0);
+
+	// Is the text filled?
+	run.hasFill = false;
+	AIBoolean hasFill = features.GetFill(&isAssigned);
+	if (isAssigned && hasFill)
+	{
+		// What color?
+		ATE::IApplicationPaint ATEfillColor = features.GetFillColor(&isAssigned);
+		if (isAssigned)
+		{
+			run.hasFill = true;
+			sATEPaint->GetAIColor(ATEfillColor.GetRef(), &run.fillColor);
+		}
+	}
+
+	// Is the text stroked?
+	run.hasStroke = false;
+	run.hasLineWidth = false;
+	run.hasLineCap = false;
+	run.hasLineJoin = false;
+	AIBoolean hasStroke = features.GetStroke(&isAssigned);
+	if (isAssigned && hasStroke)
+	{
+		// What color?
+		ATE::IApplicationPaint ATEstrokeColor = features.GetStrokeColor(&isAssigned);
+		if (isAssigned)
+		{
+			run.hasStroke = true;
+			sATEPaint->GetAIColor(ATEstrokeColor.GetRef(), &run.strokeColor);
+
+			// Stroke width
+			run.lineWidth = features.GetLineWidth(&isAssigned);
+			run.hasLineWidth = isAssigned;
+
+			// Line cap (NOTE: LineCapType and AILineCap enumerations are identical)
+			run.lineCap = (AILineCap)features.GetLineCap(&isAssigned);
+			run.hasLineCap = isAssigned;
+
+			// Line join (NOTE: LineJoinType and AILineJoin enumerations are identical)
+			run.lineJoin = (AILineJoin)features.GetLineJoin(&isAssigned);
+			run.hasLineJoin = isAssigned;
+		}
+	}
+}
+
+void SuiteArtSource::AIRealPointHarden(const AIRealPoint* source, AIRealPoint* destination)
+{
+	sAIHardSoft->AIRealPointHarden(source, destination);
+}
+
+void SuiteArtSource::AIRealMatrixHarden(AIRealMatrix* matrix)
+{
+	sAIHardSoft->AIRealMatrixHarden(matrix);
+}
+
+void SuiteArtSource::AIRealMatrixRealSoft(AIRealMatrix* matrix)
+{
+	sAIHardSoft->AIRealMatrixRealSoft(matrix);
+}
+
+AIErr SuiteArtSource::ConvertSampleColor(ai::int32 srcSpace, const SampleComponent* srcColor, ai::int32 dstSpace, SampleComponent* dstColor, ASBoolean* inGamut)
+{
+	return sAIColorConversion->ConvertSampleColor(srcSpace, srcColor, dstSpace, dstColor, AIColorConvertOptions::kForExport, inGamut);
+}
+
+AIErr SuiteArtSource::GetFileURL(const std::string& filePath, std::string& url)
+{
+	ai::UnicodeString usPath(filePath);
+	ai::FilePath aiFilePath(usPath);
+	url = aiFilePath.GetAsURL(false).as_Platform();
+	return kNoErr;
+}
+
+void SuiteArtSource::BeginProfile()
+{
+	BeginSuiteProfile();
+}
+
+// Write suite calls to a file
+void SuiteArtSource::EndProfile(const std::string& filePath)
+{
+	EndSuiteProfile();
+	WriteSuiteProfile(filePath);
+}
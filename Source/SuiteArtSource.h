@@ -0,0 +1,108 @@
+// SuiteArtSource.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SUITEARTSOURCE_H
+#define SUITEARTSOURCE_H
+
+#include "IllustratorSDK.h"
+#include "Ai2CanvasSuites.h"
+#include "ArtSource.h"
+
+namespace CanvasExport
+{
+	/// Reads the current Illustrator document (through the SDK suites)
+	/// This is the only source that needs Illustrator, so it's only built into the plug-in
+	class SuiteArtSource : public ArtSource
+	{
+	public:
+
+		SuiteArtSource();
+		~SuiteArtSource();
+
+		AIErr				CountLayers(ai::int32* count);
+		AIErr				GetNthLayer(ai::int32 n, AILayerHandle* layer);
+		AIErr				GetLayerVisible(AILayerHandle layer, AIBoolean* visible);
+		AIErr				GetLayerTitle(AILayerHandle layer, std::string& title);
+		AIErr				GetFirstArtOfLayer(AILayerHandle layer, AIArtHandle* art);
+
+		AIErr				GetArtFirstChild(AIArtHandle art, AIArtHandle* child);
+		AIErr				GetArtSibling(AIArtHandle art, AIArtHandle* sibling);
+		AIErr				GetArtType(AIArtHandle art, short* type);
+		AIErr				GetArtUserAttr(AIArtHandle art, ai::int32 whichAttr, ai::int32* attr);
+		AIErr				GetArtName(AIArtHandle art, std::string& name, ASBoolean* isDefaultName);
+		AIErr				GetArtBounds(AIArtHandle art, AIRealRect* bounds);
+
+		AIReal				GetOpacity(AIArtHandle art);
+		AIBlendingMode		GetBlendingMode(AIArtHandle art);
+		AIErr				GetLiveEffects(AIArtHandle art, std::vector<LiveEffect>& liveEffects);
+		AIErr				GetMask(AIArtHandle art, AIMaskRef* mask);
+		AIErr				GetPluginArtClipping(AIArtHandle art, AIBoolean* clipping);
+		bool				CanRasterize();
+		AIErr				RasterizeArtToPNG(AIArtHandle art, const std::string& filePath);
+
+		AIErr				GetPathSegmentCount(AIArtHandle path, short* count);
+		AIErr				GetPathSegments(AIArtHandle path, short segmentNumber, short count, AIPathSegment* segments);
+		AIErr				GetPathClosed(AIArtHandle path, AIBoolean* closed);
+		AIErr				GetPathGuide(AIArtHandle path, AIBoolean* isGuide);
+		AIErr				GetPathStyle(AIArtHandle art, AIPathStyle* style, AIBoolean* hasAdvancedFill);
+
+		AIErr				GetGradientType(AIGradientHandle gradient, short* type);
+		AIErr				GetGradientStopCount(AIGradientHandle gradient, short* count);
+		AIErr				GetNthGradientStop(AIGradientHandle gradient, short n, AIGradientStop* stop);
+		AIErr				GetPatternArt(AIPatternHandle pattern, AIArtHandle* art);
+		AIErr				GetPatternName(AIPatternHandle pattern, std::string& name);
+		AIErr				GetCustomColor(AICustomColorHandle customColorHandle, AICustomColor* customColor);
+
+		AIErr				GetSymbolPatternOfSymbolArt(AIArtHandle art, AIPatternHandle* pattern);
+		AIErr				GetSoftTransformOfSymbolArt(AIArtHandle art, AIRealMatrix* transform);
+
+		AIErr				GetPluginArtName(AIArtHandle art, std::string& name);
+		AIErr				GetPluginArtResultArt(AIArtHandle art, AIArtHandle* resultArt);
+
+		AIErr				GetPlacedType(AIArtHandle art, short* type);
+		AIErr				GetPlacedFilePath(AIArtHandle art, std::string& filePath);
+		AIErr				GetPlacedMatrix(AIArtHandle art, AIRealMatrix* matrix);
+		AIErr				GetPlacedRasterInfo(AIArtHandle art, AIRasterRecord* info, AIBoolean* isRaster);
+		AIErr				GetRasterFilePath(AIArtHandle art, std::string& filePath);
+
+		AIErr				GetTextFrame(AIArtHandle art, TextFrame& textFrame);
+
+		void				AIRealPointHarden(const AIRealPoint* source, AIRealPoint* destination);
+		void				AIRealMatrixHarden(AIRealMatrix* matrix);
+		void				AIRealMatrixRealSoft(AIRealMatrix* matrix);
+
+		AIErr				ConvertSampleColor(ai::int32 srcSpace, const SampleComponent* srcColor, ai::int32 dstSpace, SampleComponent* dstColor, ASBoolean* inGamut);
+
+		AIErr				GetFileURL(const std::string& filePath, std::string& url);
+
+		void				BeginProfile();
+		void				EndProfile(const std::string& filePath);
+
+	private:
+
+		void				GetDropShadow(AIParserLiveEffect liveEffect, DropShadow& dropShadow);
+		void				GetGlyphRun(const ATE::IGlyphRun& glyphRun, GlyphRun& run);
+	};
+}
+
+#endif
@@ -0,0 +1,169 @@
+// TaskScheduler.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TaskScheduler.h"
+
+using namespace CanvasExport;
+
+TaskScheduler::TaskScheduler(size_t threadCount)
+{
+	// Initialize TaskScheduler
+	this->queued = 0;
+	this->nextWorker = 0;
+	this->isStopping = false;
+
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	// Every queue exists before any thread starts
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		workers.push_back(new Worker());
+	}
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		threads.push_back(std::thread(&TaskScheduler::Run, this, i));
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	Finish();
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		delete workers[i];
+	}
+}
+
+// Tasks added by a task go to its own thread's queue (and run next there), anything else is spread across the queues
+void TaskScheduler::Add(const std::function<void()>& task)
+{
+	size_t index = CurrentWorker();
+	if (index == workers.size())
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		index = nextWorker;
+		nextWorker = (nextWorker + 1) % workers.size();
+	}
+
+	// Count the task first, so the count never drops below zero
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks.push_back(task);
+	}
+	available.notify_one();
+}
+
+// Run every remaining task and stop the threads (nothing can be added from outside afterward)
+void TaskScheduler::Finish()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	available.notify_all();
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+	threads.clear();
+}
+
+void TaskScheduler::Run(size_t index)
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		if (Take(index, task))
+		{
+			task();
+			continue;
+		}
+
+		// Wait for more work (a task that's still being added is picked up on the next pass)
+		std::unique_lock<std::mutex> lock(mutex);
+		available.wait(lock, [&] { return (queued > 0 || isStopping); });
+		if (queued == 0 && isStopping)
+		{
+			return;
+		}
+	}
+}
+
+// Take the newest task from our own queue, or steal the oldest task from another one
+bool TaskScheduler::Take(size_t index, std::function<void()>& task)
+{
+	bool isTaken = false;
+
+	for (size_t i = 0; i < workers.size() && !isTaken; i++)
+	{
+		Worker* worker = workers[(index + i) % workers.size()];
+
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		if (!worker->tasks.empty())
+		{
+			if (i == 0)
+			{
+				task = worker->tasks.back();
+				worker->tasks.pop_back();
+			}
+			else
+			{
+				task = worker->tasks.front();
+				worker->tasks.pop_front();
+			}
+			isTaken = true;
+		}
+	}
+
+	if (isTaken)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queued--;
+	}
+
+	return isTaken;
+}
+
+// Index of the calling scheduler thread (or the worker count, if it's called from elsewhere)
+size_t TaskScheduler::CurrentWorker()
+{
+	std::thread::id id = std::this_thread::get_id();
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		if (threads[i].get_id() == id)
+		{
+			return i;
+		}
+	}
+
+	return workers.size();
+}
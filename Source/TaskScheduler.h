@@ -0,0 +1,70 @@
+// TaskScheduler.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CanvasExport
+{
+	/// Runs tasks on a fixed set of threads, each with its own queue
+	/// A thread takes its newest task first, and when it runs out, steals the oldest task from another thread
+	/// (so a task that adds many smaller tasks keeps the other threads busy)
+	class TaskScheduler
+	{
+	private:
+
+		struct Worker
+		{
+			std::deque<std::function<void()>>	tasks;
+			std::mutex		mutex;
+		};
+
+		std::vector<Worker*>	workers;
+		std::vector<std::thread>	threads;
+		std::mutex			mutex;
+		std::condition_variable	available;
+		size_t				queued;						// Tasks waiting in any queue
+		size_t				nextWorker;					// Queue for the next task added from outside the scheduler
+		bool				isStopping;					// No more tasks will be added from outside
+
+		void				Run(size_t index);
+		bool				Take(size_t index, std::function<void()>& task);
+		size_t				CurrentWorker();
+
+	public:
+
+		TaskScheduler(size_t threadCount);
+		~TaskScheduler();
+
+		void				Add(const std::function<void()>& task);
+		void				Finish();
+	};
+}
+
+#endif
@@ -0,0 +1,124 @@
+// Trace.cpp
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "IllustratorSDK.h"
+#include "Utility.h"
+#include <fstream>
+
+using namespace CanvasExport;
+
+Trace::Trace()
+{
+	// Initialize Trace
+	this->enabled = false;
+}
+
+Trace::~Trace()
+{
+}
+
+// Start collecting (discards any earlier events)
+void Trace::Begin()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	events.clear();
+	threads.clear();
+	origin = std::chrono::steady_clock::now();
+	enabled = true;
+}
+
+// Stop collecting (scopes that are still open are dropped)
+void Trace::End()
+{
+	enabled = false;
+}
+
+void Trace::Add(const char* name, const std::string* detail, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+	TraceEvent event;
+	event.name = name;
+	if (detail)
+	{
+		event.detail = *detail;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!enabled)
+	{
+		return;
+	}
+
+	event.start = std::chrono::duration_cast<std::chrono::microseconds>(start - origin).count();
+	event.duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+	// Number threads in the order they're seen
+	std::thread::id id = std::this_thread::get_id();
+	event.thread = 0;
+	while (event.thread < threads.size() && threads[event.thread] != id)
+	{
+		event.thread++;
+	}
+	if (event.thread == threads.size())
+	{
+		threads.push_back(id);
+	}
+
+	events.push_back(event);
+}
+
+// Write complete ("X") events as a JSON trace file
+bool Trace::Write(const std::string& filePath)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::ofstream file;
+	file.open(filePath.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file << "{\"traceEvents\":[";
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		const TraceEvent& event = events[i];
+
+		file << (i > 0 ? ",\n" : "\n") <<
+			"{\"name\":\"" << EscapeJSON(event.name) << "\",\"cat\":\"export\",\"ph\":\"X\"" <<
+			",\"ts\":" << event.start << ",\"dur\":" << event.duration <<
+			",\"pid\":1,\"tid\":" << (event.thread + 1);
+
+		if (!event.detail.empty())
+		{
+			file << ",\"args\":{\"detail\":\"" << EscapeJSON(event.detail) << "\"}";
+		}
+
+		file << "}";
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	file.close();
+
+	return !file.fail();
+}
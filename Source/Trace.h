@@ -0,0 +1,114 @@
+// Trace.h
+//
+// Copyright (c) 2010-2022 Mike Swanson (http://blog.mikeswanson.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace CanvasExport
+{
+	/// Collects timed export phases and writes them in Chrome trace event format (for chrome://tracing or Perfetto)
+	class Trace
+	{
+	private:
+
+		struct TraceEvent
+		{
+			const char*			name;					// Phase name (a string literal)
+			std::string			detail;					// Layer, function or file name
+			int64_t				start;					// Microseconds since Begin
+			int64_t				duration;				// Microseconds
+			unsigned int		thread;					// Index into threads
+		};
+
+		bool				enabled;
+		std::chrono::steady_clock::time_point	origin;	// When tracing began
+		std::vector<TraceEvent>	events;
+		std::vector<std::thread::id>	threads;		// Threads that have added events
+		std::mutex			mutex;
+
+	public:
+
+		Trace();
+		~Trace();
+
+		inline bool			IsEnabled() const	{ return enabled; }
+
+		void				Begin();
+		void				End();
+		void				Add(const char* name, const std::string* detail, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+		bool				Write(const std::string& filePath);
+	};
+
+	// Globals
+	extern Trace trace;
+
+	/// Times the enclosing scope (when tracing is off, this only tests a flag)
+	/// A detail string must outlive the scope
+	class TraceScope
+	{
+	private:
+
+		const char*			name;						// Phase name (or nullptr when tracing is off)
+		const std::string*	detail;
+		std::chrono::steady_clock::time_point	start;
+
+	public:
+
+		inline TraceScope(const char* name)
+		{
+			this->name = trace.IsEnabled() ? name : nullptr;
+			this->detail = nullptr;
+			if (this->name)
+			{
+				this->start = std::chrono::steady_clock::now();
+			}
+		}
+
+		inline TraceScope(const char* name, const std::string& detail)
+		{
+			this->name = trace.IsEnabled() ? name : nullptr;
+			this->detail = &detail;
+			if (this->name)
+			{
+				this->start = std::chrono::steady_clock::now();
+			}
+		}
+
+		inline ~TraceScope()
+		{
+			if (name)
+			{
+				trace.Add(name, detail, start, std::chrono::steady_clock::now());
+			}
+		}
+	};
+}
+
+#endif
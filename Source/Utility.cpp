@@ -33,6 +33,10 @@ std::string CanvasExport::Indent(size_t depth)
 	{
 		return std::string((depth * 2), ' ');
 	}
+	else if (exportOptions.IsMinified())
+	{
+		return "";
+	}
 	else
 	{
 		return "      ";
@@ -41,26 +45,23 @@ std::string CanvasExport::Indent(size_t depth)
 
 bool CanvasExport::OpenFile(const std::string& filePath)
 {
-	// Open the file
-	outFile.open(filePath.c_str(), ios::out);
-
-	// Return result
-	return outFile.is_open();
+	// Open the file (output is buffered in memory until the file is closed)
+	return outFile.Open(filePath);
 }
 
 void CanvasExport::CloseFile()
 {
-	// Close the file
-	outFile.close();
+	TraceScope traceScope("CloseFile");
+
+	// Write buffered output and close the file
+	outFile.Close();
 }
 
-void CanvasExport::RenderTransform(const AIRealMatrix& matrix)
+void CanvasExport::RenderTransform(const AIRealMatrix& matrix, std::ostream& stream)
 {
 	// Transform
-	outFile << setiosflags(ios::fixed) << setprecision(3) <<
-		matrix.a << ", " << matrix.b << ", " << matrix.c << ", " << matrix.d << ", " << 
-		setprecision(1) <<
-		matrix.tx << ", " << matrix.ty;
+	stream << Fixed<3>(matrix.a) << ", " << Fixed<3>(matrix.b) << ", " << Fixed<3>(matrix.c) << ", " << Fixed<3>(matrix.d) << ", " <<
+		Fixed<1>(matrix.tx) << ", " << Fixed<1>(matrix.ty);
 }
 
 // In-place replacement of one character for another
@@ -264,10 +265,21 @@ vector<string> CanvasExport::Tokenize(const std::string& str, const std::string&
 
 bool CanvasExport::FileExists(const std::string& fileName)
 {
-	ai::UnicodeString aiFileName(fileName);
-	ai::FilePath filePath(aiFileName);
+	std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+	return file.is_open();
+}
 
-	return filePath.Exists(true);
+// Folder of a file path, including the trailing separator ("c:\output\image.png" is "c:\output\")
+std::string CanvasExport::GetFolderPath(const std::string& filePath)
+{
+	return filePath.substr(0, filePath.find_last_of("/\\") + 1);
+}
+
+// File name without its folder or extension ("c:\output\image.png" is "image")
+std::string CanvasExport::GetFileNameNoExt(const std::string& filePath)
+{
+	std::string fileName = filePath.substr(filePath.find_last_of("/\\") + 1);
+	return fileName.substr(0, fileName.find_last_of('.'));
 }
 
 // Update bounds to include newBounds
@@ -316,61 +328,145 @@ std::string CanvasExport::GetUniqueFileName(const std::string& path, const std::
 	return uniqueFileName.str();
 }
 
+// Encode binary data as base64 (for embedding in JavaScript strings)
+std::string CanvasExport::EncodeBase64(const unsigned char* data, size_t size)
+{
+	static const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string result;
+	result.reserve(((size + 2) / 3) * 4);
+
+	// Each group of three bytes becomes four characters
+	size_t i = 0;
+	for (; i + 2 < size; i += 3)
+	{
+		unsigned int group = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+		result += digits[(group >> 18) & 0x3F];
+		result += digits[(group >> 12) & 0x3F];
+		result += digits[(group >> 6) & 0x3F];
+		result += digits[group & 0x3F];
+	}
+
+	// Pad the last group
+	if (i < size)
+	{
+		unsigned int group = data[i] << 16;
+		if (i + 1 < size)
+		{
+			group |= data[i + 1] << 8;
+		}
+
+		result += digits[(group >> 18) & 0x3F];
+		result += digits[(group >> 12) & 0x3F];
+		result += (i + 1 < size) ? digits[(group >> 6) & 0x3F] : '=';
+		result += '=';
+	}
+
+	return result;
+}
+
+// Render the JavaScript function that turns base64 back into a Uint8Array
+void CanvasExport::RenderDecodeBase64()
+{
+	outFile << "\n\n    function decodeBase64(data) {";
+	outFile <<   "\n      var text = atob(data);";
+	outFile <<   "\n      var bytes = new Uint8Array(text.length);";
+	outFile <<   "\n      for (var i = 0; i < text.length; i++) {";
+	outFile <<   "\n        bytes[i] = text.charCodeAt(i);";
+	outFile <<   "\n      }";
+	outFile <<   "\n      return bytes;";
+	outFile <<   "\n    }";
+}
+
 void CanvasExport::WriteArtTree()
 {
 	AILayerHandle layerHandle = nullptr;
 	ai::int32 layerCount = 0;
 
 	// How many layers in this document?
-	sAILayer->CountLayers(&layerCount);
+	artSource->CountLayers(&layerCount);
 
 	// Loop through all layers
 	for (ai::int32 i = 0; i < layerCount; i++)
 	{
 		// Get a reference to the layer
-		sAILayer->GetNthLayer(i, &layerHandle);
+		artSource->GetNthLayer(i, &layerHandle);
 
 		// Get the first art in this layer
 		AIArtHandle artHandle = nullptr;
-		sAIArt->GetFirstArtOfLayer(layerHandle, &artHandle);
+		artSource->GetFirstArtOfLayer(layerHandle, &artHandle);
 
 		// Dig in
 		WriteArtTree(artHandle, 0);
 	}
 }
 
-void CanvasExport::WriteArtTree(AIArtHandle artHandle, int depth)
+// Escape a string for JSON
+std::string CanvasExport::EscapeJSON(const std::string& s)
+{
+	std::string result;
+	result.reserve(s.length());
+
+	for (size_t i = 0; i < s.length(); i++)
+	{
+		unsigned char c = (unsigned char)s[i];
+		if (c == '"' || c == '\\')
+		{
+			result += '\\';
+			result += (char)c;
+		}
+		else if (c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			result += escaped;
+		}
+		else
+		{
+			result += (char)c;
+		}
+	}
+
+	return result;
+}
+
+// Simple way to describe art types for debugging purposes
+const char* CanvasExport::ArtTypeName(short type)
 {
-	// Simple way to describe art types for debugging purposes
-	static const char *artTypes[] = 
+	static const char *artTypes[kArtTypeCount] = 
 	{
 		"kUnknownArt", "kGroupArt", "kPathArt", "kCompoundPathArt", "kTextArtUnsupported", "kTextPathArtUnsupported", "kTextRunArtUnsupported", "kPlacedArt", "kMysteryPathArt", "kRasterArt", "kPluginArt", "kMeshArt", "kTextFrameArt", "kSymbolArt", "kForeignArt", "kLegacyTextArt"
 	};
 
+	return (type >= 0 && type < kArtTypeCount) ? artTypes[type] : artTypes[0];
+}
+
+void CanvasExport::WriteArtTree(AIArtHandle artHandle, int depth)
+{
 	// Loop through art and its siblings
 	do
 	{
 		// Art type
 		short type = 0;
-		sAIArt->GetArtType(artHandle, &type);
-		outFile << "\n//" << Indent(depth) << std::string(artTypes[type]) << " (" << type << ")";
+		artSource->GetArtType(artHandle, &type);
+		outFile << "\n//" << Indent(depth) << ArtTypeName(type) << " (" << type << ")";
 
 		// Get art name
-		ai::UnicodeString artName;
+		std::string artName;
 		AIBoolean isDefaultName = false;
-		sAIArt->GetArtName(artHandle, artName, &isDefaultName);
-		outFile << ": " << artName.as_Platform();
+		artSource->GetArtName(artHandle, artName, &isDefaultName);
+		outFile << ": " << artName;
 
 		// Any children?
 		AIArtHandle childArtHandle;
-		sAIArt->GetArtFirstChild(artHandle, &childArtHandle);
+		artSource->GetArtFirstChild(artHandle, &childArtHandle);
 		if (childArtHandle != nullptr)
 		{
 			WriteArtTree(childArtHandle, depth + 1);
 		}
 
 		// Find the next sibling
-		sAIArt->GetArtSibling(artHandle, &artHandle);
+		artSource->GetArtSibling(artHandle, &artHandle);
 	}
 	while (artHandle != nullptr);
 }
@@ -24,7 +24,11 @@
 #define UTILITY_H
 
 #include "IllustratorSDK.h"
-#include "Ai2CanvasSuites.h"
+#include "OutputStream.h"
+#include "NumberFormat.h"
+#include "ExportOptions.h"
+#include "ArtSource.h"
+#include "Trace.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -33,13 +37,16 @@
 namespace CanvasExport
 {
 	// Globals
-	extern ofstream outFile;
+	extern OutputStream outFile;
 	extern bool debug;
 
+	// Number of art types (kUnknownArt through kLegacyTextArt)
+	const short kArtTypeCount = 16;
+
 	bool OpenFile(const std::string& filePath);
 	void CloseFile();
 	std::string Indent(size_t depth);
-	void RenderTransform(const AIRealMatrix& matrix);
+	void RenderTransform(const AIRealMatrix& matrix, std::ostream& stream);
 	void Replace(std::string& s, char find, char replace);
 	void CleanString(std::string& s, AIBoolean camelCase);
 	void CleanFunction(std::string& s);
@@ -48,8 +55,14 @@ namespace CanvasExport
 	void MakeValidID(std::string& s);
 	vector<string> Tokenize(const std::string& str, const std::string& delimiters);
 	bool FileExists(const std::string& fileName);
+	std::string GetFolderPath(const std::string& filePath);
+	std::string GetFileNameNoExt(const std::string& filePath);
 	void UpdateBounds(const AIRealRect& newBounds, AIRealRect& bounds);
 	std::string GetUniqueFileName(const std::string& path, const std::string& fileName, const std::string& extension);
+	std::string EncodeBase64(const unsigned char* data, size_t size);
+	std::string EscapeJSON(const std::string& s);
+	const char* ArtTypeName(short type);
+	void RenderDecodeBase64();
 	void WriteArtTree();
 	void WriteArtTree(AIArtHandle artHandle, int depth);
 }